@@ -57,8 +57,10 @@ int px4_errno;
 struct px4_dev_t {
 	char *name;
 	void *cdev;
+	uint32_t hash;
+	int hash_next; ///< devmap index + 1 of the next entry in the same hash bucket, 0 if none
 
-	px4_dev_t(const char *n, void *c) : cdev(c)
+	px4_dev_t(const char *n, void *c, uint32_t h) : cdev(c), hash(h), hash_next(0)
 	{
 		name = strdup(n);
 	}
@@ -73,6 +75,54 @@ private:
 static px4_dev_t *devmap[PX4_MAX_DEV];
 pthread_mutex_t devmutex = PTHREAD_MUTEX_INITIALIZER;
 
+/* Hash index into devmap, so that name lookups do not need to scan all entries.
+ * Each bucket holds the devmap index + 1 of its first entry (0 if empty). */
+#define PX4_DEV_HASH_SIZE 256 // must be a power of 2
+static int devhash[PX4_DEV_HASH_SIZE];
+
+static uint32_t dev_hash(const char *name)
+{
+	/* FNV-1a */
+	uint32_t h = 2166136261u;
+
+	while (*name) {
+		h = (h ^ (uint8_t)*name++) * 16777619u;
+	}
+
+	return h;
+}
+
+/* devmutex must be held */
+static int dev_find_locked(const char *name)
+{
+	const uint32_t h = dev_hash(name);
+
+	for (int i = devhash[h & (PX4_DEV_HASH_SIZE - 1)] - 1; i >= 0; i = devmap[i]->hash_next - 1) {
+		if (devmap[i]->hash == h && strcmp(devmap[i]->name, name) == 0) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+/* devmutex must be held */
+static void dev_remove_locked(int index)
+{
+	int *link = &devhash[devmap[index]->hash & (PX4_DEV_HASH_SIZE - 1)];
+
+	while (*link != 0 && *link != index + 1) {
+		link = &devmap[*link - 1]->hash_next;
+	}
+
+	if (*link != 0) {
+		*link = devmap[index]->hash_next;
+	}
+
+	delete devmap[index];
+	devmap[index] = nullptr;
+}
+
 
 VDev::VDev(const char *name,
 	   const char *devname) :
@@ -143,21 +193,21 @@ VDev::register_driver(const char *name, void *data)
 		return -EINVAL;
 	}
 
-	// Make sure the device does not already exist
-	// FIXME - convert this to a map for efficiency
-
 	pthread_mutex_lock(&devmutex);
 
-	for (int i = 0; i < PX4_MAX_DEV; ++i) {
-		if (devmap[i] && (strcmp(devmap[i]->name, name) == 0)) {
-			pthread_mutex_unlock(&devmutex);
-			return -EEXIST;
-		}
+	// Make sure the device does not already exist
+	if (dev_find_locked(name) >= 0) {
+		pthread_mutex_unlock(&devmutex);
+		return -EEXIST;
 	}
 
 	for (int i = 0; i < PX4_MAX_DEV; ++i) {
 		if (devmap[i] == nullptr) {
-			devmap[i] = new px4_dev_t(name, (void *)data);
+			const uint32_t h = dev_hash(name);
+			int *bucket = &devhash[h & (PX4_DEV_HASH_SIZE - 1)];
+			devmap[i] = new px4_dev_t(name, (void *)data, h);
+			devmap[i]->hash_next = *bucket;
+			*bucket = i + 1;
 			PX4_DEBUG("Registered DEV %s", name);
 			ret = PX4_OK;
 			break;
@@ -185,14 +235,12 @@ VDev::unregister_driver(const char *name)
 
 	pthread_mutex_lock(&devmutex);
 
-	for (int i = 0; i < PX4_MAX_DEV; ++i) {
-		if (devmap[i] && (strcmp(name, devmap[i]->name) == 0)) {
-			delete devmap[i];
-			devmap[i] = nullptr;
-			PX4_DEBUG("Unregistered DEV %s", name);
-			ret = PX4_OK;
-			break;
-		}
+	int i = dev_find_locked(name);
+
+	if (i >= 0) {
+		dev_remove_locked(i);
+		PX4_DEBUG("Unregistered DEV %s", name);
+		ret = PX4_OK;
 	}
 
 	pthread_mutex_unlock(&devmutex);
@@ -209,14 +257,13 @@ VDev::unregister_class_devname(const char *class_devname, unsigned class_instanc
 
 	pthread_mutex_lock(&devmutex);
 
-	for (int i = 0; i < PX4_MAX_DEV; ++i) {
-		if (devmap[i] && strcmp(devmap[i]->name, name) == 0) {
-			delete devmap[i];
-			PX4_DEBUG("Unregistered class DEV %s", name);
-			devmap[i] = nullptr;
-			pthread_mutex_unlock(&devmutex);
-			return PX4_OK;
-		}
+	int i = dev_find_locked(name);
+
+	if (i >= 0) {
+		dev_remove_locked(i);
+		PX4_DEBUG("Unregistered class DEV %s", name);
+		pthread_mutex_unlock(&devmutex);
+		return PX4_OK;
 	}
 
 	pthread_mutex_unlock(&devmutex);
@@ -535,23 +582,15 @@ VDev::remove_poll_waiter(px4_pollfd_struct_t *fds)
 VDev *VDev::getDev(const char *path)
 {
 	PX4_DEBUG("VDev::getDev");
-	int i = 0;
 
 	pthread_mutex_lock(&devmutex);
 
-	for (; i < PX4_MAX_DEV; ++i) {
-		//if (devmap[i]) {
-		//	printf("%s %s\n", devmap[i]->name, path);
-		//}
-		if (devmap[i] && (strcmp(devmap[i]->name, path) == 0)) {
-			pthread_mutex_unlock(&devmutex);
-			return (VDev *)(devmap[i]->cdev);
-		}
-	}
+	int i = dev_find_locked(path);
+	VDev *dev = (i >= 0) ? (VDev *)(devmap[i]->cdev) : nullptr;
 
 	pthread_mutex_unlock(&devmutex);
 
-	return nullptr;
+	return dev;
 }
 
 void VDev::showDevices()
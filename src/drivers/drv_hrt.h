@@ -75,6 +75,9 @@ typedef struct hrt_call {
 	hrt_abstime		period;
 	hrt_callout		callout;
 	void			*arg;
+#ifdef __PX4_POSIX
+	unsigned		heap_index;	/* position in the callout heap */
+#endif
 } *hrt_call_t;
 
 /**
@@ -186,6 +189,17 @@ __EXPORT extern	void	hrt_start_delay(void);
  */
 __EXPORT extern void	hrt_stop_delay(void);
 
+/**
+ * Print callout statistics: queue length and the lateness of the callouts
+ * against their deadline.
+ */
+__EXPORT extern void	hrt_print_stats(void);
+
+/**
+ * Reset the callout statistics.
+ */
+__EXPORT extern void	hrt_reset_stats(void);
+
 #endif
 
 __END_DECLS
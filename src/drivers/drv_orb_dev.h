@@ -93,4 +93,15 @@
 /** Get the minimum interval at which the topic can be seen to be updated for this subscription */
 #define ORBIOCGETINTERVAL	_ORBIOC(16)
 
+/** Copy all pending samples of a queued topic in one call, see struct orb_copy_batch_arg */
+#define ORBIOCCOPYBATCH		_ORBIOC(17)
+
+/** Argument of ORBIOCCOPYBATCH */
+struct orb_copy_batch_arg {
+	void		*buffer;	/**< receives up to max_n samples, o_size bytes each, oldest first */
+	unsigned	max_n;		/**< capacity of buffer in samples */
+	unsigned	n;		/**< out: number of samples copied */
+	uint32_t	lost;		/**< out: samples overwritten before this subscriber could read them */
+};
+
 #endif /* _DRV_UORB_H */
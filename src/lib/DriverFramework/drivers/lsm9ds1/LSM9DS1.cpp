@@ -450,7 +450,21 @@ void LSM9DS1::_measure()
 
 #endif
 
-	_publish(m_sensor_data);
+	// The FIFO is not used, so every cycle hands over a burst of one sample.
+	struct imu_sensor_sample sample;
+	sample.accel_m_s2_x = m_sensor_data.accel_m_s2_x;
+	sample.accel_m_s2_y = m_sensor_data.accel_m_s2_y;
+	sample.accel_m_s2_z = m_sensor_data.accel_m_s2_z;
+	sample.gyro_rad_s_x = m_sensor_data.gyro_rad_s_x;
+	sample.gyro_rad_s_y = m_sensor_data.gyro_rad_s_y;
+	sample.gyro_rad_s_z = m_sensor_data.gyro_rad_s_z;
+	sample.mag_ga_x = m_sensor_data.mag_ga_x;
+	sample.mag_ga_y = m_sensor_data.mag_ga_y;
+	sample.mag_ga_z = m_sensor_data.mag_ga_z;
+	sample.temp_c = m_sensor_data.temp_c;
+	m_sensor_data.is_last_fifo_sample = true;
+
+	_publishBatch(&sample, 1, m_sensor_data);
 
 	m_synchronize.signal();
 	m_synchronize.unlock();
@@ -472,7 +472,22 @@ void MPU9250::_measure()
 		return;
 	}
 
-	for (unsigned packet_index = 0; packet_index < read_len / size_of_fifo_packet; ++packet_index) {
+	const unsigned num_packets = read_len / size_of_fifo_packet;
+	unsigned num_samples = 0;
+	uint64_t accel_range_hits = 0;
+	uint64_t gyro_range_hits = 0;
+	uint64_t mag_fifo_overflows = 0;
+	bool fifo_corrupt = false;
+
+	// The mag values are only written by this thread, keep the last ones if a packet
+	// does not contain valid mag data.
+	float mag_ga_x = m_sensor_data.mag_ga_x;
+	float mag_ga_y = m_sensor_data.mag_ga_y;
+	float mag_ga_z = m_sensor_data.mag_ga_z;
+
+	// Convert the whole burst first and hand it over in one go, so that the lock is
+	// only taken once per cycle instead of once per packet.
+	for (unsigned packet_index = 0; packet_index < num_packets; ++packet_index) {
 
 		fifo_packet *report = (fifo_packet *)(&fifo_read_buf[packet_index	* size_of_fifo_packet]);
 
@@ -492,25 +507,21 @@ void MPU9250::_measure()
 		if (report->accel_x == INT16_MIN || report->accel_x == INT16_MAX ||
 		    report->accel_y == INT16_MIN || report->accel_y == INT16_MAX ||
 		    report->accel_z == INT16_MIN || report->accel_z == INT16_MAX) {
-			m_synchronize.lock();
-			++m_sensor_data.accel_range_hit_counter;
-			m_synchronize.unlock();
+			++accel_range_hits;
 		}
 
 		// Also check the full gyro range, however, this is very unlikely to happen.
 		if (report->gyro_x == INT16_MIN || report->gyro_x == INT16_MAX ||
 		    report->gyro_y == INT16_MIN || report->gyro_y == INT16_MAX ||
 		    report->gyro_z == INT16_MIN || report->gyro_z == INT16_MAX) {
-			m_synchronize.lock();
-			++m_sensor_data.gyro_range_hit_counter;
-			m_synchronize.unlock();
+			++gyro_range_hits;
 		}
 
 		const float temp_c = float(report->temp) / 361.0f + 35.0f;
 
 		// Use the temperature field to try to detect if we (ever) fall out of sync with
 		// the FIFO buffer. If the temperature changes insane amounts, reset the FIFO logic
-		// and return early.
+		// and only pass on the samples before the corrupt one.
 		if (!_temp_initialized) {
 			// Assume that the temperature should be in a sane range of -40 to 85 deg C which is
 			// the specified temperature range, at least to initialize.
@@ -531,84 +542,109 @@ void MPU9250::_measure()
 					(double)fabsf(temp_c - _last_temp_c), (double)_last_temp_c, (double)temp_c);
 				reset_fifo();
 				_temp_initialized = false;
-				m_synchronize.lock();
-				++m_sensor_data.fifo_corruption_counter;
-				m_synchronize.unlock();
-				return;
+				fifo_corrupt = true;
+				break;
 			}
 
 			_last_temp_c = temp_c;
 		}
 
-		m_synchronize.lock();
-		m_sensor_data.accel_m_s2_x = float(report->accel_x)
-					     * (MPU9250_ONE_G / 2048.0f);
-		m_sensor_data.accel_m_s2_y = float(report->accel_y)
-					     * (MPU9250_ONE_G / 2048.0f);
-		m_sensor_data.accel_m_s2_z = float(report->accel_z)
-					     * (MPU9250_ONE_G / 2048.0f);
-		m_sensor_data.temp_c = temp_c;
-		m_sensor_data.gyro_rad_s_x = float(report->gyro_x) * GYRO_RAW_TO_RAD_S;
-		m_sensor_data.gyro_rad_s_y = float(report->gyro_y) * GYRO_RAW_TO_RAD_S;
-		m_sensor_data.gyro_rad_s_z = float(report->gyro_z) * GYRO_RAW_TO_RAD_S;
+		struct imu_sensor_sample &sample = _fifo_samples[num_samples];
+
+		sample.accel_m_s2_x = float(report->accel_x) * (MPU9250_ONE_G / 2048.0f);
+		sample.accel_m_s2_y = float(report->accel_y) * (MPU9250_ONE_G / 2048.0f);
+		sample.accel_m_s2_z = float(report->accel_z) * (MPU9250_ONE_G / 2048.0f);
+		sample.temp_c = temp_c;
+		sample.gyro_rad_s_x = float(report->gyro_x) * GYRO_RAW_TO_RAD_S;
+		sample.gyro_rad_s_y = float(report->gyro_y) * GYRO_RAW_TO_RAD_S;
+		sample.gyro_rad_s_z = float(report->gyro_z) * GYRO_RAW_TO_RAD_S;
 
 		if (_mag_enabled) {
 			struct fifo_packet_with_mag *report_with_mag_data = (struct fifo_packet_with_mag *)report;
 
 			int mag_error = _mag->process((const struct mag_data &)report_with_mag_data->mag_st1,
-						      m_sensor_data.mag_ga_x,
-						      m_sensor_data.mag_ga_y,
-						      m_sensor_data.mag_ga_z);
+						      mag_ga_x,
+						      mag_ga_y,
+						      mag_ga_z);
 
 			if (mag_error == MAG_ERROR_DATA_OVERFLOW) {
-				m_sensor_data.mag_fifo_overflow_counter++;
+				++mag_fifo_overflows;
 			}
 		}
 
-		// Pass on the sampling interval between FIFO samples at 8kHz.
-		m_sensor_data.fifo_sample_interval_us = 1000000 / MPU9250_MEASURE_INTERVAL_US
-							/ _packets_per_cycle_filtered;
+		sample.mag_ga_x = mag_ga_x;
+		sample.mag_ga_y = mag_ga_y;
+		sample.mag_ga_z = mag_ga_z;
 
-		// Flag if this is the last sample, and _publish() should wrap up the data it has received.
-		m_sensor_data.is_last_fifo_sample = ((packet_index + 1) == (read_len / size_of_fifo_packet));
+		++num_samples;
+	}
 
-		++m_sensor_data.read_counter;
+	m_synchronize.lock();
 
-		// Generate debug output every second, assuming that a sample is generated every
-		// 125 usecs
-#ifdef MPU9250_DEBUG
+	m_sensor_data.accel_range_hit_counter += accel_range_hits;
+	m_sensor_data.gyro_range_hit_counter += gyro_range_hits;
+	m_sensor_data.mag_fifo_overflow_counter += mag_fifo_overflows;
 
-		if (++m_sensor_data.read_counter % (1000000 / m_sensor_data.fifo_sample_interval_us) == 0) {
-
-			DF_LOG_INFO("IMU: accel: [%f, %f, %f]",
-				    (double)m_sensor_data.accel_m_s2_x,
-				    (double)m_sensor_data.accel_m_s2_y,
-				    (double)m_sensor_data.accel_m_s2_z);
-			DF_LOG_INFO("     gyro:  [%f, %f, %f]",
-				    (double)m_sensor_data.gyro_rad_s_x,
-				    (double)m_sensor_data.gyro_rad_s_y,
-				    (double)m_sensor_data.gyro_rad_s_z);
-			DF_LOG_INFO("    temp:  %f C", (double)m_sensor_data.temp_c);
-		}
+	if (fifo_corrupt) {
+		++m_sensor_data.fifo_corruption_counter;
+	}
 
-#endif
+	if (num_samples == 0) {
+		m_synchronize.unlock();
+		return;
+	}
+
+	// The shared data always holds the latest sample.
+	const struct imu_sensor_sample &last = _fifo_samples[num_samples - 1];
+	m_sensor_data.accel_m_s2_x = last.accel_m_s2_x;
+	m_sensor_data.accel_m_s2_y = last.accel_m_s2_y;
+	m_sensor_data.accel_m_s2_z = last.accel_m_s2_z;
+	m_sensor_data.gyro_rad_s_x = last.gyro_rad_s_x;
+	m_sensor_data.gyro_rad_s_y = last.gyro_rad_s_y;
+	m_sensor_data.gyro_rad_s_z = last.gyro_rad_s_z;
+	m_sensor_data.mag_ga_x = last.mag_ga_x;
+	m_sensor_data.mag_ga_y = last.mag_ga_y;
+	m_sensor_data.mag_ga_z = last.mag_ga_z;
+	m_sensor_data.temp_c = last.temp_c;
 
+	// Pass on the sampling interval between FIFO samples at 8kHz.
+	m_sensor_data.fifo_sample_interval_us = 1000000 / MPU9250_MEASURE_INTERVAL_US
+						/ _packets_per_cycle_filtered;
+
+	// The burst is complete, _publishBatch() should wrap up the data it has received.
+	m_sensor_data.is_last_fifo_sample = true;
+
+	m_sensor_data.read_counter += num_samples;
+
+	// Generate debug output every second, in the burst that crosses the second.
 #ifdef MPU9250_DEBUG
 
-		if (_mag_enabled && mag_error == 0) {
-			if ((m_sensor_data.read_counter % 10000) == 0) {
-				DF_LOG_INFO("     mag:  [%f, %f, %f] ga",
-					    m_sensor_data.mag_ga_x, m_sensor_data.mag_ga_y, m_sensor_data.mag_ga_z);
-			}
+	if (m_sensor_data.read_counter % (1000000 / m_sensor_data.fifo_sample_interval_us) < num_samples) {
+
+		DF_LOG_INFO("IMU: accel: [%f, %f, %f]",
+			    (double)m_sensor_data.accel_m_s2_x,
+			    (double)m_sensor_data.accel_m_s2_y,
+			    (double)m_sensor_data.accel_m_s2_z);
+		DF_LOG_INFO("     gyro:  [%f, %f, %f]",
+			    (double)m_sensor_data.gyro_rad_s_x,
+			    (double)m_sensor_data.gyro_rad_s_y,
+			    (double)m_sensor_data.gyro_rad_s_z);
+		DF_LOG_INFO("    temp:  %f C", (double)m_sensor_data.temp_c);
+
+		if (_mag_enabled) {
+			DF_LOG_INFO("     mag:  [%f, %f, %f] ga",
+				    (double)m_sensor_data.mag_ga_x,
+				    (double)m_sensor_data.mag_ga_y,
+				    (double)m_sensor_data.mag_ga_z);
 		}
+	}
 
 #endif
 
-		_publish(m_sensor_data);
+	_publishBatch(_fifo_samples, num_samples, m_sensor_data);
 
-		m_synchronize.signal();
-		m_synchronize.unlock();
-	}
+	m_synchronize.signal();
+	m_synchronize.unlock();
 }
 
 int MPU9250::_publish(struct imu_sensor_data &data)
@@ -234,6 +234,9 @@ struct mag_data {
 };
 #pragma pack(pop)
 
+// Maximum number of samples that fit into one FIFO read.
+#define MPU9250_MAX_FIFO_SAMPLES (MPU_MAX_LEN_FIFO_IN_BYTES / sizeof(fifo_packet))
+
 class MPU9250: public ImuSensor
 {
 public:
@@ -299,6 +302,9 @@ private:
 	bool _mag_enabled;
 	float _packets_per_cycle_filtered;
 
+	// Converted samples of the current FIFO burst.
+	struct imu_sensor_sample _fifo_samples[MPU9250_MAX_FIFO_SAMPLES];
+
 	MPU9250_mag *_mag;
 };
 
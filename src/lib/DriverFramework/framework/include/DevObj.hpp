@@ -142,9 +142,17 @@ private:
 
 	static void measure(void *arg);
 
+	// Work queue the measurements run on: one per bus device, virtual
+	// devices share the default queue
+	const char *workQueue()
+	{
+		return (m_bus_type == DeviceBusType_VIRT) ? nullptr : m_dev_path;
+	}
+
 	// Disallow copy
 	DevObj(const DevObj &);
 
+	DeviceBusType		m_bus_type;
 	int 			m_driver_instance;	// m_driver_instance = -1 when unregistered
 	DFPointerList		m_handles;
 	SyncObj			m_handle_lock;
@@ -99,6 +99,22 @@ struct imu_sensor_data {
 	bool		is_last_fifo_sample;
 };
 
+/**
+ * A single sample of a FIFO burst as handed to _publishBatch().
+ */
+struct imu_sensor_sample {
+	float		accel_m_s2_x;
+	float		accel_m_s2_y;
+	float		accel_m_s2_z;
+	float		gyro_rad_s_x;
+	float		gyro_rad_s_y;
+	float		gyro_rad_s_z;
+	float		mag_ga_x;
+	float		mag_ga_y;
+	float		mag_ga_z;
+	float		temp_c;
+};
+
 #if defined(__IMU_USE_I2C)
 class ImuSensor : public I2CDevObj
 #else
@@ -171,6 +187,37 @@ protected:
 		return -1;
 	};
 
+	/**
+	 * Hand over a whole FIFO burst at once. The counters and the values of the
+	 * last sample are in data, the samples are ordered oldest first.
+	 *
+	 * The default implementation passes the samples one by one to _publish().
+	 */
+	virtual int _publishBatch(const struct imu_sensor_sample *samples, unsigned num_samples,
+				  struct imu_sensor_data &data)
+	{
+		struct imu_sensor_data sample_data = data;
+		int ret = 0;
+
+		for (unsigned i = 0; i < num_samples; ++i) {
+			sample_data.accel_m_s2_x = samples[i].accel_m_s2_x;
+			sample_data.accel_m_s2_y = samples[i].accel_m_s2_y;
+			sample_data.accel_m_s2_z = samples[i].accel_m_s2_z;
+			sample_data.gyro_rad_s_x = samples[i].gyro_rad_s_x;
+			sample_data.gyro_rad_s_y = samples[i].gyro_rad_s_y;
+			sample_data.gyro_rad_s_z = samples[i].gyro_rad_s_z;
+			sample_data.mag_ga_x = samples[i].mag_ga_x;
+			sample_data.mag_ga_y = samples[i].mag_ga_y;
+			sample_data.mag_ga_z = samples[i].mag_ga_z;
+			sample_data.temp_c = samples[i].temp_c;
+			sample_data.is_last_fifo_sample = (i + 1 == num_samples);
+
+			ret = _publish(sample_data);
+		}
+
+		return ret;
+	}
+
 	struct imu_sensor_data 		m_sensor_data;
 	bool						m_mag_enabled;
 	SyncObj 					m_synchronize;
@@ -74,15 +74,33 @@ class WorkMgr
 {
 public:
 	// Interface functions
-	static void getWorkHandle(WorkCallback cb, void *arg, uint32_t delay_usec, WorkHandle &handle);
+
+	// The work runs on the worker thread of the given queue, which is created on first use.
+	// Drivers use their bus device path, so that a slow bus does not delay devices on other
+	// buses. queue = nullptr is the default queue. name is only used for printStatus().
+	static void getWorkHandle(WorkCallback cb, void *arg, uint32_t delay_usec, WorkHandle &handle,
+				  const char *queue = nullptr, const char *name = nullptr);
 	static void releaseWorkHandle(WorkHandle &handle);
 	static int schedule(WorkHandle &handle);
 	static void setError(WorkHandle &h, int error);
 
+	// Pin the worker thread of a queue to a CPU, cpu < 0 removes the pinning.
+	// The queue must already be in use. Returns 0 on success, -ENOENT if there
+	// is no queue with that name.
+	static int setQueueAffinity(const char *queue, int cpu);
+
+	// Print the work queues, their work items and the execution time and
+	// lateness statistics of the items
+	static void printStatus();
+	static void resetStats();
+
 private:
 	friend class Framework;
 
 	static bool isValidHandle(const WorkHandle &h);
+
+	// Find or create a work queue, returns its index
+	static unsigned getQueue(const char *queue);
 	static int initialize();
 	static void finalize();
 
@@ -51,6 +51,7 @@ DevObj::DevObj(const char *name, const char *dev_path, const char *dev_class_pat
 	m_sample_interval_usecs(sample_interval_usecs),
 	m_id {},
 	m_pub_blocked(false),
+	m_bus_type(bus_type),
 	m_driver_instance(-1),
 	m_refcount(0)
 {
@@ -166,7 +167,7 @@ int DevObj::start()
 
 	} else {
 		do {
-			WorkMgr::getWorkHandle(measure, this, m_sample_interval_usecs, m_work_handle);
+			WorkMgr::getWorkHandle(measure, this, m_sample_interval_usecs, m_work_handle, workQueue(), m_name);
 
 			if (!m_work_handle.isValid()) {
 				return -m_work_handle.getError();
@@ -329,7 +330,7 @@ void DevObj::setSampleInterval(unsigned int sample_interval_usecs)
 			WorkMgr::releaseWorkHandle(m_work_handle);
 
 			do {
-				WorkMgr::getWorkHandle(measure, this, m_sample_interval_usecs, m_work_handle);
+				WorkMgr::getWorkHandle(measure, this, m_sample_interval_usecs, m_work_handle, workQueue(), m_name);
 
 				if (!m_work_handle.isValid()) {
 					return;
@@ -34,6 +34,8 @@
 * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *************************************************************************/
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <pthread.h>
 #include <errno.h>
 #include <time.h>
@@ -45,6 +47,8 @@
 
 #ifdef __DF_LINUX
 #include <sys/prctl.h>
+#include <sched.h>
+#include <unistd.h>
 #endif
 
 // Used for backtrace
@@ -55,36 +59,66 @@
 
 #define SHOW_STATS 0
 
+// Run the work of every bus on its own worker thread. The DSP has a small
+// number of threads, so all work shares the default queue there.
+#ifndef DF_WORK_QUEUE_PER_BUS
+#ifdef __DF_QURT
+#define DF_WORK_QUEUE_PER_BUS 0
+#else
+#define DF_WORK_QUEUE_PER_BUS 1
+#endif
+#endif
+
 namespace DriverFramework
 {
 //-----------------------------------------------------------------------
 // Types
 //-----------------------------------------------------------------------
 
+// A worker thread that runs the work items of one queue
 class HRTWorkQueue : public DisableCopy
 {
 public:
-	static HRTWorkQueue &instance();
+	// Returns nullptr if there is no queue with that index
+	static HRTWorkQueue *get(unsigned index);
+
+	// Find the queue with the given name, create it and start its worker
+	// thread if it does not exist yet. Returns the default queue on failure.
+	static unsigned getIndex(const char *name);
+
+	// Find an existing queue without creating it. Returns -ENOENT if there is none.
+	static int findIndex(const char *name);
+
+	static int initialize();
+	static void finalize();
 
-	int initialize();
-	void finalize();
+	static void scheduleWorkItem(WorkHandle &wh);
 
-	void scheduleWorkItem(WorkHandle &wh);
+	static void shutdown();
 
-	void shutdown();
-	void enableStats(bool enable);
+	int setAffinity(int cpu);
+	void printStatus();
 
-	static void *process_trampoline(void * /*arg*/);
+	static void *process_trampoline(void *arg);
 
 private:
-	HRTWorkQueue() = default;
-	~HRTWorkQueue() = default;
+	HRTWorkQueue(unsigned index, const char *name);
+	~HRTWorkQueue();
 
+	int start();
 	void process();
+	void signal();
+	int applyAffinity();
 
-	bool 	m_enable_stats = false;
+	unsigned	m_index;
+	char		*m_name;
+	int		m_cpu = -1;
+	bool		m_running = false;
+	pthread_t	m_tid {};
+	unsigned long	m_wakeups = 0;
 
 	SyncObj m_reschedule;
+	bool	m_reschedule_pending = false;	// signal() was called since the last wait
 };
 
 
@@ -105,11 +139,12 @@ RunStatus *g_run_status = nullptr;
 // Static Variables
 //-----------------------------------------------------------------------
 
-static pthread_t g_tid;
-
 // QuRT C++ compiler does not support static initialization of classes
 static SyncObj *g_framework;
 
+static HRTWorkQueue *g_work_queues[DF_MAX_WORK_QUEUES];
+static SyncObj *g_work_queues_lock;
+
 //-----------------------------------------------------------------------
 // Static Functions
 //-----------------------------------------------------------------------
@@ -235,7 +270,7 @@ void RunStatus::terminate()
 void Framework::shutdown()
 {
 	// Free the HRTWorkQueue resources
-	HRTWorkQueue::instance().finalize();
+	HRTWorkQueue::finalize();
 
 	// Free the WorkMgr resources
 	WorkMgr::finalize();
@@ -276,7 +311,7 @@ int Framework::initialize()
 		return -4;
 	}
 
-	ret = HRTWorkQueue::instance().initialize();
+	ret = HRTWorkQueue::initialize();
 
 	if (ret < 0) {
 		return ret - 10;
@@ -353,6 +388,7 @@ static int setRealtimeSched()
 void *HRTWorkQueue::process_trampoline(void *arg)
 {
 	DF_LOG_DEBUG("HRTWorkQueue::process_trampoline");
+	HRTWorkQueue *queue = reinterpret_cast<HRTWorkQueue *>(arg);
 
 #ifndef __DF_QURT
 	int ret = setRealtimeSched();
@@ -364,31 +400,137 @@ void *HRTWorkQueue::process_trampoline(void *arg)
 #endif
 
 #ifdef __DF_LINUX
-	prctl(PR_SET_NAME, "DFWorker"); //set the thread name
+	// set the thread name, the default queue keeps the historic name
+	char thread_name[16] = "DFWorker";
+
+	if (queue->m_index != 0) {
+		const char *base = strrchr(queue->m_name, '/');
+		snprintf(thread_name, sizeof(thread_name), "DF%s", base ? base + 1 : queue->m_name);
+	}
+
+	prctl(PR_SET_NAME, thread_name);
 #endif
 
 	DF_LOG_DEBUG("process_trampoline %d", ret);
 
-	instance().process();
+	queue->process();
 
 	return nullptr;
 }
 
-HRTWorkQueue &HRTWorkQueue::instance()
+HRTWorkQueue::HRTWorkQueue(unsigned index, const char *name) :
+	m_index(index),
+	m_name(strdup(name))
+{
+}
+
+HRTWorkQueue::~HRTWorkQueue()
+{
+	free(m_name);
+}
+
+HRTWorkQueue *HRTWorkQueue::get(unsigned index)
+{
+	return (index < DF_MAX_WORK_QUEUES) ? g_work_queues[index] : nullptr;
+}
+
+unsigned HRTWorkQueue::getIndex(const char *name)
 {
-	static HRTWorkQueue *instance = nullptr;
+#if DF_WORK_QUEUE_PER_BUS
+
+	if (name == nullptr || g_work_queues_lock == nullptr) {
+		return 0;
+	}
+
+	unsigned index = 0;
 
-	if (!instance) {
-		instance = new HRTWorkQueue();
+	g_work_queues_lock->lock();
+
+	for (unsigned i = 0; i < DF_MAX_WORK_QUEUES; ++i) {
+		if (g_work_queues[i] == nullptr) {
+			// Create a new queue for this bus
+			HRTWorkQueue *queue = new HRTWorkQueue(i, name);
+
+			if (queue->start() == 0) {
+				g_work_queues[i] = queue;
+				index = i;
+
+			} else {
+				DF_LOG_ERR("failed to start work queue for %s", name);
+				delete queue;
+			}
+
+			break;
+
+		} else if (strcmp(g_work_queues[i]->m_name, name) == 0) {
+			index = i;
+			break;
+		}
 	}
 
-	return *instance;
+	g_work_queues_lock->unlock();
+
+	return index;
+#else
+	return 0;
+#endif
+}
+
+int HRTWorkQueue::findIndex(const char *name)
+{
+	if (name == nullptr) {
+		return 0;
+	}
+
+#if DF_WORK_QUEUE_PER_BUS
+
+	if (g_work_queues_lock == nullptr) {
+		return -ENOENT;
+	}
+
+	int index = -ENOENT;
+
+	g_work_queues_lock->lock();
+
+	for (unsigned i = 0; i < DF_MAX_WORK_QUEUES; ++i) {
+		if (g_work_queues[i] != nullptr && strcmp(g_work_queues[i]->m_name, name) == 0) {
+			index = i;
+			break;
+		}
+	}
+
+	g_work_queues_lock->unlock();
+
+	return index;
+#else
+	// All devices share the default queue
+	return 0;
+#endif
 }
 
 int HRTWorkQueue::initialize()
 {
 	DF_LOG_DEBUG("HRTWorkQueue::initialize");
 
+	g_work_queues_lock = new SyncObj;
+
+	// The default queue
+	HRTWorkQueue *queue = new HRTWorkQueue(0, "default");
+
+	int ret = queue->start();
+
+	if (ret < 0) {
+		delete queue;
+		return ret;
+	}
+
+	g_work_queues[0] = queue;
+
+	return 0;
+}
+
+int HRTWorkQueue::start()
+{
 	pthread_attr_t attr {};
 	int ret = pthread_attr_init(&attr);
 
@@ -410,12 +552,15 @@ int HRTWorkQueue::initialize()
 #endif
 
 	// Create high priority worker thread
-	if (pthread_create(&g_tid, &attr, process_trampoline, nullptr)) {
+	if (pthread_create(&m_tid, &attr, process_trampoline, this)) {
 		return -3;
 	}
 
 	DF_LOG_DEBUG("pthread_create success");
 
+	m_running = true;
+	applyAffinity();
+
 	return 0;
 }
 
@@ -425,8 +570,25 @@ void HRTWorkQueue::finalize()
 
 	shutdown();
 
-	// Wait for work queue thread to exit
-	pthread_join(g_tid, nullptr);
+	// Wait for the work queue threads to exit
+	for (unsigned i = 0; i < DF_MAX_WORK_QUEUES; ++i) {
+		if (g_work_queues[i] != nullptr) {
+			pthread_join(g_work_queues[i]->m_tid, nullptr);
+			delete g_work_queues[i];
+			g_work_queues[i] = nullptr;
+		}
+	}
+
+	delete g_work_queues_lock;
+	g_work_queues_lock = nullptr;
+}
+
+void HRTWorkQueue::signal()
+{
+	m_reschedule.lock();
+	m_reschedule_pending = true;
+	m_reschedule.signal();
+	m_reschedule.unlock();
 }
 
 void HRTWorkQueue::scheduleWorkItem(WorkHandle &wh)
@@ -434,15 +596,19 @@ void HRTWorkQueue::scheduleWorkItem(WorkHandle &wh)
 	DF_LOG_DEBUG("HRTWorkQueue::scheduleWorkItem (%p)", &wh);
 
 	// Handle is known to be valid
-	int ret = WorkItems::schedule(wh.m_handle);
+	unsigned index = 0;
+	int ret = WorkItems::schedule(wh.m_handle, index);
 
 	DF_LOG_DEBUG("WorkItems::schedule %d", ret);
 
 	if (ret == 0) {
 		wh.m_errno = 0;
-		m_reschedule.lock();
-		m_reschedule.signal();
-		m_reschedule.unlock();
+
+		HRTWorkQueue *queue = get(index);
+
+		if (queue) {
+			queue->signal();
+		}
 
 	} else if (ret == EBADF) {
 		wh.m_errno = EBADF;
@@ -462,9 +628,66 @@ void HRTWorkQueue::shutdown()
 		g_run_status->terminate();
 	}
 
-	m_reschedule.lock();
-	m_reschedule.signal();
-	m_reschedule.unlock();
+	for (unsigned i = 0; i < DF_MAX_WORK_QUEUES; ++i) {
+		if (g_work_queues[i] != nullptr) {
+			g_work_queues[i]->signal();
+		}
+	}
+}
+
+int HRTWorkQueue::setAffinity(int cpu)
+{
+	m_cpu = cpu;
+
+	return applyAffinity();
+}
+
+int HRTWorkQueue::applyAffinity()
+{
+#ifdef __DF_LINUX
+
+	if (!m_running) {
+		return 0;
+	}
+
+	cpu_set_t cpuset;
+	CPU_ZERO(&cpuset);
+
+	if (m_cpu >= 0) {
+		CPU_SET(m_cpu, &cpuset);
+
+	} else {
+		long num_cpus = sysconf(_SC_NPROCESSORS_CONF);
+
+		for (long i = 0; i < num_cpus && i < CPU_SETSIZE; ++i) {
+			CPU_SET(i, &cpuset);
+		}
+	}
+
+	int ret = pthread_setaffinity_np(m_tid, sizeof(cpuset), &cpuset);
+
+	if (ret != 0) {
+		DF_LOG_ERR("failed to set CPU affinity of work queue %s (%d)", m_name, ret);
+		return -ret;
+	}
+
+	return 0;
+#else
+
+	if (m_cpu >= 0) {
+		DF_LOG_ERR("CPU affinity is not supported");
+		return -ENOTSUP;
+	}
+
+	return 0;
+#endif
+}
+
+void HRTWorkQueue::printStatus()
+{
+	DF_LOG_INFO("%s: cpu %d, %lu wakeups", m_name, m_cpu, m_wakeups);
+
+	WorkItems::printStatus(m_index);
 }
 
 void HRTWorkQueue::process()
@@ -479,7 +702,7 @@ void HRTWorkQueue::process()
 		// Wake up every 10 sec if nothing scheduled
 		next = now + 10000000;
 
-		WorkItems::processExpiredWorkItems(next);
+		WorkItems::processExpiredWorkItems(m_index, next);
 
 		now = offsetTime();
 		DF_LOG_DEBUG("now=%" PRIu64, now);
@@ -494,13 +717,21 @@ void HRTWorkQueue::process()
 			uint64_t wait_time_usec = next - now;
 
 			DF_LOG_DEBUG("HRTWorkQueue::process waiting for work (%" PRIi64 "usec)", wait_time_usec);
-			// Wait until next expiry or until a new item is rescheduled
+			// Wait until next expiry or until a new item is rescheduled. Work
+			// that was scheduled while the items were processed is not missed.
 			m_reschedule.lock();
-			m_reschedule.waitOnSignal(wait_time_usec);
+
+			if (!m_reschedule_pending) {
+				m_reschedule.waitOnSignal(wait_time_usec);
+			}
+
+			m_reschedule_pending = false;
 			m_reschedule.unlock();
 			DF_LOG_DEBUG("Done wait");
 		}
 
+		++m_wakeups;
+
 		DF_LOG_DEBUG("not waiting for work (%" PRIi64 "usec)", wait_time_usec);
 	}
 };
@@ -509,7 +740,44 @@ void HRTWorkQueue::process()
 int WorkMgr::schedule(DriverFramework::WorkHandle &wh)
 {
 	DF_LOG_DEBUG("WorkMgr::schedule");
-	HRTWorkQueue::instance().scheduleWorkItem(wh);
+	HRTWorkQueue::scheduleWorkItem(wh);
 	return (wh.m_errno == 0) ? 0 : -1;
 }
 
+unsigned WorkMgr::getQueue(const char *queue)
+{
+	return HRTWorkQueue::getIndex(queue);
+}
+
+int WorkMgr::setQueueAffinity(const char *queue, int cpu)
+{
+	int index = HRTWorkQueue::findIndex(queue);
+
+	if (index < 0) {
+		return index;
+	}
+
+	HRTWorkQueue *q = HRTWorkQueue::get(index);
+
+	if (q == nullptr) {
+		return -ENOENT;
+	}
+
+	return q->setAffinity(cpu);
+}
+
+void WorkMgr::printStatus()
+{
+	for (unsigned i = 0; i < DF_MAX_WORK_QUEUES; ++i) {
+		HRTWorkQueue *queue = HRTWorkQueue::get(i);
+
+		if (queue != nullptr) {
+			queue->printStatus();
+		}
+	}
+}
+
+void WorkMgr::resetStats()
+{
+	WorkItems::resetStats();
+}
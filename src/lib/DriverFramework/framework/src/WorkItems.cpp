@@ -83,6 +83,12 @@ void WorkItems::WorkItem::updateStats(unsigned int cur_usec)
 
 void WorkItems::WorkItem::resetStats()
 {
+	m_run_count = 0;
+	m_run_total = 0;
+	m_run_max = 0;
+	m_late_total = 0;
+	m_late_max = 0;
+
 #if SHOW_STATS == 1
 	m_last = ~(unsigned long)0;
 	m_min = ~(unsigned long)0;
@@ -111,22 +117,61 @@ void WorkItems::finalize()
 
 void WorkItems::_finalize()
 {
-	m_work_list.clear();
+	for (unsigned i = 0; i < DF_MAX_WORK_QUEUES; ++i) {
+		m_work_list[i] = nullptr;
+	}
+
 	m_work_items.clear();
 }
 
-int WorkItems::schedule(int index)
+void WorkItems::enqueue(WorkItem *item)
+{
+	WorkItem **prev = &m_work_list[item->m_queue];
+	uint64_t deadline = item->deadline();
+
+	// items with the same deadline run in the order they were queued
+	while (*prev != nullptr && (*prev)->deadline() <= deadline) {
+		prev = &(*prev)->m_next;
+	}
+
+	item->m_next = *prev;
+	*prev = item;
+	item->m_queued = true;
+}
+
+void WorkItems::dequeue(WorkItem *item)
+{
+	if (!item->m_queued) {
+		return;
+	}
+
+	WorkItem **prev = &m_work_list[item->m_queue];
+
+	while (*prev != nullptr) {
+		if (*prev == item) {
+			*prev = item->m_next;
+			break;
+		}
+
+		prev = &(*prev)->m_next;
+	}
+
+	item->m_next = nullptr;
+	item->m_queued = false;
+}
+
+int WorkItems::schedule(int index, unsigned &queue)
 {
 	DF_LOG_DEBUG("WorkItems::schedule");
 	WorkItems &inst = instance();
 
 	inst.m_lock.lock();
-	int ret = inst._schedule(index);
+	int ret = inst._schedule(index, queue);
 	inst.m_lock.unlock();
 	return ret;
 }
 
-int WorkItems::_schedule(int index)
+int WorkItems::_schedule(int index, unsigned &queue)
 {
 	DF_LOG_DEBUG("WorkItems::_schedule");
 
@@ -151,6 +196,7 @@ int WorkItems::_schedule(int index)
 				// 2. item has a sampling rate that is a multiple of wi's sampling rate
 				// 3. wi has a sampling rate that is a multiple of item's sampling rate
 				// 4. just pick an arbitrary wi
+				// Only items of the same queue are considered, items of other queues run on another thread.
 				DFPointerList::Index idx = nullptr;
 				idx = m_work_items.next(idx);
 				uint64_t queue_time_equal = 0, queue_time_multiple = 0, queue_time_divider = 0, queue_time_other = 0;
@@ -158,7 +204,7 @@ int WorkItems::_schedule(int index)
 				while (idx != nullptr) {
 					WorkItem *wi = reinterpret_cast<WorkItem *>(m_work_items.get(idx));
 
-					if (wi->m_in_use) {
+					if (wi->m_in_use && wi != item && wi->m_queue == item->m_queue) {
 						if (wi->m_delay_usec == item->m_delay_usec) {
 							queue_time_equal = wi->m_queue_time;
 
@@ -200,7 +246,12 @@ int WorkItems::_schedule(int index)
 				}
 
 				item->m_in_use = true;
-				m_work_list.pushBack(index);
+				queue = item->m_queue;
+
+				// The item might still be queued if it was released and rescheduled
+				// while its callback was running
+				dequeue(item);
+				enqueue(item);
 			}
 
 		} else {
@@ -226,45 +277,28 @@ void WorkItems::unschedule(int index)
 
 void WorkItems::_unschedule(int index)
 {
-	DFUIntList::Index idx = nullptr;
-	idx = m_work_list.next(idx);
-
-	while (idx != nullptr) {
-		// If we find it in the list at the current idx, let's go ahead and delete it.
-		unsigned int cur_index;
+	WorkItem *item = nullptr;
 
-		if (m_work_list.get(idx, cur_index)) {
+	if (!getAt(index, &item)) {
+		DF_LOG_ERR("HRTWorkQueue::unscheduleWorkItem - invalid index");
 
-			if ((int)cur_index == index) {
-				// remove unscheduled item
-				WorkItem *item = nullptr;
-
-				if (!getAt(index, &item)) {
-					DF_LOG_ERR("HRTWorkQueue::unscheduleWorkItem - invalid index");
-
-				} else {
-					item->m_in_use = false;
-					// We're only unscheduling one item, so we can bail out here.
-					break;
-				}
-			}
-		}
-
-		idx = m_work_list.next(idx);
+	} else {
+		item->m_in_use = false;
+		dequeue(item);
 	}
 }
 
-void WorkItems::processExpiredWorkItems(uint64_t &next)
+void WorkItems::processExpiredWorkItems(unsigned queue, uint64_t &next)
 {
 	DF_LOG_DEBUG("WorkItems::processExpiredWorkItems %" PRIu64 "", next);
 	WorkItems &inst = instance();
 
 	inst.m_lock.lock();
-	inst._processExpiredWorkItems(next);
+	inst._processExpiredWorkItems(queue, next);
 	inst.m_lock.unlock();
 }
 
-void WorkItems::_processExpiredWorkItems(uint64_t &next)
+void WorkItems::_processExpiredWorkItems(unsigned queue, uint64_t &next)
 {
 	DF_LOG_DEBUG("WorkItems::processExpiredWorkItems");
 	uint64_t now;
@@ -272,65 +306,69 @@ void WorkItems::_processExpiredWorkItems(uint64_t &next)
 	uint32_t max_too_late_scheduled = 0;
 	bool had_work = false;
 
-	DFUIntList::Index idx = nullptr;
-	idx = m_work_list.next(idx);
-
-	while (g_run_status && g_run_status->check() && (idx != nullptr)) {
+	// The list is sorted by deadline, so only the head can be due
+	while (g_run_status && g_run_status->check() && (m_work_list[queue] != nullptr)) {
 		DF_LOG_DEBUG("HRTWorkQueue::process work exists");
-		unsigned int index;
-		m_work_list.get(idx, index);
+		WorkItem *item = m_work_list[queue];
+		DF_LOG_DEBUG("WorkList (%p) in use=%d delay=%u queue_time=%" PRIu64, item, item->m_in_use, item->m_delay_usec,
+			     item->m_queue_time);
 
+		now = offsetTime();
+		elapsed = now - item->m_queue_time;
+		//DF_LOG_DEBUG("now = %lu elapsed = %lu delay = %luusec\n", now, elapsed, item.m_delay_usec);
 
-		if (index < m_work_items.size()) {
-			WorkItem *item = nullptr;
-			getAt(index, &item);
-			DF_LOG_DEBUG("WorkList (%p) in use=%d delay=%u queue_time=%" PRIu64, item, item->m_in_use, item->m_delay_usec,
-				     item->m_queue_time);
+		if (now < item->m_queue_time || elapsed < item->m_delay_usec) {
+			break;
+		}
 
-			// Remove inactive work items from work list here to prevent use after free
-			if (!item->m_in_use) {
-				// Remove the inactive work item from work list
-				idx = m_work_list.erase(idx);
-				continue;
-			}
+		DF_LOG_DEBUG("WorkItems::processExpiredWorkItems  do work: (%p) (%u)", item, item->m_delay_usec);
+		item->updateStats(now);
 
-			now = offsetTime();
-			elapsed = now - item->m_queue_time;
-			//DF_LOG_DEBUG("now = %lu elapsed = %lu delay = %luusec\n", now, elapsed, item.m_delay_usec);
+		uint32_t late = elapsed - item->m_delay_usec;
 
-			if (elapsed >= item->m_delay_usec) {
-				DF_LOG_DEBUG("WorkItems::processExpiredWorkItems  do work: (%p) (%u)", item, item->m_delay_usec);
-				item->updateStats(now);
+		// reschedule work
+		dequeue(item);
+		item->m_queue_time += item->m_delay_usec;
 
-				// reschedule work
-				item->m_queue_time += item->m_delay_usec;
-				item->m_in_use = true;
+		if (!had_work && late > max_too_late_scheduled) {
+			//only take the first into account, because we don't want to include the callback
+			//execution time of the previous items
+			max_too_late_scheduled = late;
+		}
 
-				if (!had_work && elapsed - item->m_delay_usec > max_too_late_scheduled) {
-					//only take the first into account, because we don't want to include the callback
-					//execution time of the previous items
-					max_too_late_scheduled = elapsed - item->m_delay_usec;
-				}
+		void *tmpptr = item->m_arg;
+		WorkCallback cb = item->m_callback;
+		m_lock.unlock();
+		cb(tmpptr);
+		uint64_t done = offsetTime();
+		had_work = true;
+		m_lock.lock();
 
-				void *tmpptr = item->m_arg;
-				WorkCallback cb = item->m_callback;
-				m_lock.unlock();
-				cb(tmpptr);
-				had_work = true;
-				m_lock.lock();
-			}
+		// The item may have been released, or released and rescheduled, by the callback
+		if (item->m_in_use && !item->m_queued) {
+			uint32_t run = done - now;
 
-			// Get next scheduling time
-			uint64_t cur_next = item->m_queue_time + item->m_delay_usec;
+			item->m_run_count++;
+			item->m_run_total += run;
+			item->m_late_total += late;
+
+			if (run > item->m_run_max) {
+				item->m_run_max = run;
+			}
 
-			if (cur_next < next) {
-				next = cur_next;
+			if (late > item->m_late_max) {
+				item->m_late_max = late;
 			}
 
-			idx = m_work_list.next(idx);
+			enqueue(item);
 		}
 	}
 
+	// Get next scheduling time
+	if (m_work_list[queue] != nullptr && m_work_list[queue]->deadline() < next) {
+		next = m_work_list[queue]->deadline();
+	}
+
 
 #if 0 //debug the scheduling adjustment
 	static int no_work_counter = 0;
@@ -348,7 +386,7 @@ void WorkItems::_processExpiredWorkItems(uint64_t &next)
 
 		if (++counter == 200) {
 			DF_LOG_ERR("max late= %3i us mean late=%3i us  no work=%i, cur_adj=%i",
-				   (int)max_late_stat, (int)(max_late_sum / counter), no_work_counter, m_scheduling_adjustment);
+				   (int)max_late_stat, (int)(max_late_sum / counter), no_work_counter, m_scheduling_adjustment[queue]);
 			counter = 0;
 			max_late_stat = 0;
 			no_work_counter = 0;
@@ -368,34 +406,35 @@ void WorkItems::_processExpiredWorkItems(uint64_t &next)
 	if (had_work) {
 		// Scheduling can have jitter, so adjust only by a fraction.
 		// The chosen factors are a tradeoff between low-latency and CPU overhead
-		m_scheduling_adjustment += max_too_late_scheduled / 5;
+		m_scheduling_adjustment[queue] += max_too_late_scheduled / 5;
 
-		if (m_scheduling_adjustment > 1e4) { //max to 10ms
-			m_scheduling_adjustment = 1e4;
+		if (m_scheduling_adjustment[queue] > 1e4) { //max to 10ms
+			m_scheduling_adjustment[queue] = 1e4;
 		}
 
 	} else {
 		// We woke up for nothing. Reduce the adjustment
-		m_scheduling_adjustment = m_scheduling_adjustment * 90 / 100;
+		m_scheduling_adjustment[queue] = m_scheduling_adjustment[queue] * 90 / 100;
 	}
 
-	next -= m_scheduling_adjustment;
+	next -= m_scheduling_adjustment[queue];
 #endif
 
 	DF_LOG_DEBUG("Setting next=%" PRIu64, next);
 }
 
-int WorkItems::getIndex(WorkCallback cb, void *arg, uint32_t delay_usec, int &index)
+int WorkItems::getIndex(WorkCallback cb, void *arg, uint32_t delay_usec, unsigned queue, const char *name, int &index)
 {
 	WorkItems &inst = instance();
 
 	inst.m_lock.lock();
-	int ret = inst._getIndex(cb, arg, delay_usec, index);
+	int ret = inst._getIndex(cb, arg, delay_usec, queue, name, index);
 	inst.m_lock.unlock();
 	return ret;
 }
 
-int WorkItems::_getIndex(WorkCallback cb, void *arg, uint32_t delay_usec, int &index)
+int WorkItems::_getIndex(WorkCallback cb, void *arg, uint32_t delay_usec, unsigned queue, const char *name,
+			  int &index)
 {
 	int ret;
 
@@ -433,7 +472,7 @@ int WorkItems::_getIndex(WorkCallback cb, void *arg, uint32_t delay_usec, int &i
 		WorkItem *item = nullptr;
 		getAt(index, &item);
 
-		item->set(cb, arg, delay_usec);
+		item->set(cb, arg, delay_usec, queue, name);
 		ret = 0;
 
 	} else {
@@ -443,3 +482,46 @@ int WorkItems::_getIndex(WorkCallback cb, void *arg, uint32_t delay_usec, int &i
 	return ret;
 }
 
+void WorkItems::printStatus(unsigned queue)
+{
+	WorkItems &inst = instance();
+
+	inst.m_lock.lock();
+
+	DFManagedList<WorkItem>::Index idx = nullptr;
+	idx = inst.m_work_items.next(idx);
+
+	while (idx != nullptr) {
+		WorkItem *item = inst.m_work_items.get(idx);
+
+		if (item->m_in_use && item->m_queue == queue) {
+			unsigned long count = item->m_run_count;
+
+			DF_LOG_INFO("   %-16s %6u us: runs %lu, exec mean %" PRIu64 " max %u us, late mean %" PRIu64 " max %u us",
+				    item->m_name ? item->m_name : "-", item->m_delay_usec, count,
+				    count ? item->m_run_total / count : 0, item->m_run_max,
+				    count ? item->m_late_total / count : 0, item->m_late_max);
+		}
+
+		idx = inst.m_work_items.next(idx);
+	}
+
+	inst.m_lock.unlock();
+}
+
+void WorkItems::resetStats()
+{
+	WorkItems &inst = instance();
+
+	inst.m_lock.lock();
+
+	DFManagedList<WorkItem>::Index idx = nullptr;
+	idx = inst.m_work_items.next(idx);
+
+	while (idx != nullptr) {
+		inst.m_work_items.get(idx)->resetStats();
+		idx = inst.m_work_items.next(idx);
+	}
+
+	inst.m_lock.unlock();
+}
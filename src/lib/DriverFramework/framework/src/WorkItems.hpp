@@ -38,6 +38,9 @@
 #include "SyncObj.hpp"
 #include "DFList.hpp"
 
+// Maximum number of work queues, queue 0 is the default queue
+#define DF_MAX_WORK_QUEUES 8
+
 namespace DriverFramework
 {
 class WorkItems
@@ -56,12 +59,16 @@ public:
 		return *instance;
 	}
 
-	static int  getIndex(WorkCallback cb, void *arg, uint32_t delay_usec, int &index);
-	static void processExpiredWorkItems(uint64_t &next);
-	static int  schedule(int index);
+	static int  getIndex(WorkCallback cb, void *arg, uint32_t delay_usec, unsigned queue, const char *name, int &index);
+	static void processExpiredWorkItems(unsigned queue, uint64_t &next);
+	static int  schedule(int index, unsigned &queue);
 	static void unschedule(int index);
 	static void finalize();
 
+	// Print the work items of a queue and their statistics
+	static void printStatus(unsigned queue);
+	static void resetStats();
+
 private:
 	WorkItems() {}
 
@@ -72,11 +79,11 @@ private:
 	void addItem(WorkHandle &wh);
 
 	// These version do not call m_lock.lock()
-	int  _schedule(int index);
+	int  _schedule(int index, unsigned &queue);
 	void _unschedule(int index);
 	void _finalize();
-	void _processExpiredWorkItems(uint64_t &next);
-	int  _getIndex(WorkCallback cb, void *arg, uint32_t delay_usec, int &index);
+	void _processExpiredWorkItems(unsigned queue, uint64_t &next);
+	int  _getIndex(WorkCallback cb, void *arg, uint32_t delay_usec, unsigned queue, const char *name, int &index);
 	bool _isValidIndex(int index);
 
 	class WorkItem
@@ -93,13 +100,21 @@ private:
 		void resetStats();
 		void dumpStats();
 
-		void set(WorkCallback callback, void *arg, uint32_t delay_usec)
+		// Time at which the work is due next
+		uint64_t deadline() const
+		{
+			return m_queue_time + m_delay_usec;
+		}
+
+		void set(WorkCallback callback, void *arg, uint32_t delay_usec, unsigned queue, const char *name)
 		{
 			m_arg = arg;
 			m_queue_time = 0;
 			m_callback = callback;
 			m_delay_usec = delay_usec;
 			m_in_use = false;
+			m_queue = queue;
+			m_name = name;
 
 			resetStats();
 		}
@@ -108,6 +123,19 @@ private:
 		uint64_t	m_queue_time = 0;
 		WorkCallback	m_callback = nullptr;
 		uint32_t	m_delay_usec = 0;
+		unsigned	m_queue = 0;
+		const char	*m_name = nullptr;
+
+		// Next item of the queue, the queues are sorted by deadline
+		WorkItem	*m_next = nullptr;
+		bool		m_queued = false;
+
+		// execution time and lateness against the deadline, always collected
+		unsigned long	m_run_count = 0;
+		uint64_t	m_run_total = 0;
+		uint32_t	m_run_max = 0;
+		uint64_t	m_late_total = 0;
+		uint32_t	m_late_max = 0;
 
 #if SHOW_STATS == 1
 		// statistics
@@ -143,14 +171,17 @@ private:
 		}
 
 		*item = m_work_items.get(idx);
-		return true;
+		return (*item != nullptr);
 	}
 
+	// Insert into / remove from the deadline sorted list of the item's queue
+	void enqueue(WorkItem *item);
+	void dequeue(WorkItem *item);
 
-	DFUIntList		m_work_list; 	// List of active work items
+	WorkItem		*m_work_list[DF_MAX_WORK_QUEUES] {}; 	// Active work items of each queue, earliest deadline first
 	DFManagedList<WorkItem> m_work_items;	// List of all created work items
 	SyncObj			m_lock;
-	uint32_t		m_scheduling_adjustment = 0; // dynamic adjustment to account for scheduling overhead
+	uint32_t		m_scheduling_adjustment[DF_MAX_WORK_QUEUES] {}; // dynamic adjustment to account for scheduling overhead
 };
 
 class RunStatus
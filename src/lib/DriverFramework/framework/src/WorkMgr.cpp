@@ -81,12 +81,13 @@ void WorkMgr::finalize()
 	WorkItems::finalize();
 }
 
-void WorkMgr::getWorkHandle(WorkCallback cb, void *arg, uint32_t delay_usec, WorkHandle &wh)
+void WorkMgr::getWorkHandle(WorkCallback cb, void *arg, uint32_t delay_usec, WorkHandle &wh, const char *queue,
+			    const char *name)
 {
 	// Use -1 to flag that we don't know the index, otherwise we pass undefined.
 	int handle = -1;
 
-	int ret = WorkItems::getIndex(cb, arg, delay_usec, handle);
+	int ret = WorkItems::getIndex(cb, arg, delay_usec, getQueue(queue), name, handle);
 
 	if (ret == 0) {
 		wh.m_errno = 0;
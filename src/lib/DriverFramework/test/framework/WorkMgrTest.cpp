@@ -33,6 +33,7 @@
 * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
 * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *************************************************************************/
+#include <errno.h>
 #include <unistd.h>
 #include "WorkMgrTest.hpp"
 
@@ -48,6 +49,7 @@ void WorkMgrTest::_doTests()
 
 	cb_counter = new SyncObj;
 	reportResult("Verify Schedule", verifySchedule());
+	reportResult("Verify Queues", verifyQueues());
 
 	test.stop();
 	delete cb_counter;
@@ -168,3 +170,82 @@ bool WorkMgrTest::verifySchedule()
 	return true;
 }
 
+static void slowCallback(void *arg)
+{
+	// a slow bus transfer
+	usleep(50000);
+}
+
+static void fastCallback(void *arg)
+{
+	uint64_t now = offsetTime();
+
+	cb_counter->lock();
+	uint64_t *last = reinterpret_cast<uint64_t *>(arg);
+
+	if (last[0] != 0 && now - last[0] > last[1]) {
+		last[1] = now - last[0];
+	}
+
+	last[0] = now;
+	cb_counter->unlock();
+}
+
+bool WorkMgrTest::verifyQueues()
+{
+	// last call and max interval of the fast callback. Static, because a callback
+	// that is already running can still write to it after releaseWorkHandle().
+	static uint64_t fast_state[2];
+
+	cb_counter->lock();
+	fast_state[0] = 0;
+	fast_state[1] = 0;
+	cb_counter->unlock();
+
+	WorkHandle slow;
+	WorkHandle fast;
+
+	// a work item is only reserved once it is scheduled
+	WorkMgr::getWorkHandle(slowCallback, nullptr, 100000, slow, "/dev/test-slow", "slow");
+
+	if (!slow.isValid() || WorkMgr::schedule(slow) != 0) {
+		DF_LOG_ERR("scheduling the slow work failed");
+		return false;
+	}
+
+	WorkMgr::getWorkHandle(fastCallback, fast_state, 2000, fast, "/dev/test-fast", "fast");
+
+	if (!fast.isValid() || WorkMgr::schedule(fast) != 0) {
+		DF_LOG_ERR("scheduling the fast work failed");
+		return false;
+	}
+
+	usleep(300000);
+
+	WorkMgr::printStatus();
+
+	// affinity can only be set for existing queues
+	if (WorkMgr::setQueueAffinity("/dev/test-unknown", 0) != -ENOENT) {
+		DF_LOG_ERR("setQueueAffinity accepted an unknown queue");
+		WorkMgr::releaseWorkHandle(slow);
+		WorkMgr::releaseWorkHandle(fast);
+		return false;
+	}
+
+	WorkMgr::releaseWorkHandle(slow);
+	WorkMgr::releaseWorkHandle(fast);
+
+	cb_counter->lock();
+	uint64_t max_interval = fast_state[1];
+	cb_counter->unlock();
+
+	DF_LOG_INFO("Max interval of the 2000 usec work: %" PRIu64 " usec", max_interval);
+
+	// the slow work of the other queue must not delay this queue
+	if (max_interval == 0 || max_interval > 25000) {
+		DF_LOG_ERR("Work of another queue delayed the work (%" PRIu64 " usec)", max_interval);
+		return false;
+	}
+
+	return true;
+}
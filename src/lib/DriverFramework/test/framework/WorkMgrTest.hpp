@@ -53,6 +53,7 @@ protected:
 
 private:
 	bool verifySchedule();
+	bool verifyQueues();
 
 };
 
@@ -175,6 +175,8 @@ typedef enum {
 	dm_read_func,
 	dm_clear_func,
 	dm_restart_func,
+	dm_read_range_func,
+	dm_write_range_func,
 	dm_number_of_funcs
 } dm_function_t;
 
@@ -185,6 +187,7 @@ typedef struct {
 	unsigned char first;
 	unsigned char func;
 	ssize_t result;
+	hrt_abstime queued_time;	/**< time the item was put on the work queue */
 	union {
 		struct {
 			dm_item_t item;
@@ -199,6 +202,21 @@ typedef struct {
 			void *buf;
 			size_t count;
 		} read_params;
+		struct {
+			dm_item_t item;
+			unsigned index;
+			unsigned num;
+			dm_persitence_t persistence;
+			const void *buf;
+			size_t count;
+		} write_range_params;
+		struct {
+			dm_item_t item;
+			unsigned index;
+			unsigned num;
+			void *buf;
+			size_t count;
+		} read_range_params;
 		struct {
 			dm_item_t item;
 		} clear_params;
@@ -212,6 +230,9 @@ const size_t k_work_item_allocation_chunk_size = 8;
 
 /* Usage statistics */
 static unsigned g_func_counts[dm_number_of_funcs];
+static hrt_abstime g_queue_latency_sum;	/**< time spent by work items on the work queue */
+static hrt_abstime g_queue_latency_max;
+static unsigned g_queue_latency_count;
 
 /* table of maximum number of instances for each item type */
 static const unsigned g_per_item_max_index[DM_KEY_NUM_KEYS] = {
@@ -240,6 +261,26 @@ static const unsigned g_per_item_size[DM_KEY_NUM_KEYS] = {
 /* Table of offset for index 0 of each item type */
 static unsigned int g_key_offsets[DM_KEY_NUM_KEYS];
 
+/* Write-through LRU cache of recently used items, used by the file backend */
+#if defined(MEMORY_CONSTRAINED_SYSTEM)
+#define DM_CACHE_ENTRIES 8
+#else
+#define DM_CACHE_ENTRIES 64
+#endif
+
+typedef struct {
+	uint8_t item;		/**< dm_item_t of the entry, DM_KEY_NUM_KEYS if unused */
+	uint8_t len;		/**< length of the cached user data */
+	uint16_t index;
+	uint32_t last_used;	/**< LRU stamp */
+	uint8_t data[sizeof(struct mission_item_s)];
+} dm_cache_entry_t;
+
+static dm_cache_entry_t *g_cache;
+static uint32_t g_cache_clock;
+static unsigned g_cache_hits;
+static unsigned g_cache_misses;
+
 /* Item type lock mutexes */
 static px4_sem_t *g_item_locks[DM_KEY_NUM_KEYS];
 static px4_sem_t g_sys_state_mutex;
@@ -405,6 +446,8 @@ enqueue_work_item_and_wait_for_result(work_q_item_t *item)
 		g_work_q.max_size = g_work_q.size;
 	}
 
+	item->queued_time = hrt_absolute_time();
+
 	unlock_queue(&g_work_q);
 
 	/* tell the work thread that work is available */
@@ -444,6 +487,109 @@ calculate_offset(dm_item_t item, unsigned index)
 	return g_key_offsets[item] + (index * g_per_item_size[item]);
 }
 
+/* Cache management, only called from the worker thread */
+static void
+_cache_init()
+{
+	g_cache = (dm_cache_entry_t *)malloc(DM_CACHE_ENTRIES * sizeof(dm_cache_entry_t));
+
+	if (g_cache == nullptr) {
+		PX4_WARN("Could not allocate data manager cache");
+		return;
+	}
+
+	for (unsigned i = 0; i < DM_CACHE_ENTRIES; i++) {
+		g_cache[i].item = DM_KEY_NUM_KEYS;
+	}
+
+	g_cache_clock = 0;
+}
+
+static void
+_cache_free()
+{
+	free(g_cache);
+	g_cache = nullptr;
+}
+
+static dm_cache_entry_t *
+_cache_find(dm_item_t item, unsigned index)
+{
+	if (g_cache == nullptr) {
+		return nullptr;
+	}
+
+	for (unsigned i = 0; i < DM_CACHE_ENTRIES; i++) {
+		if (g_cache[i].item == item && g_cache[i].index == index) {
+			g_cache[i].last_used = ++g_cache_clock;
+			return &g_cache[i];
+		}
+	}
+
+	return nullptr;
+}
+
+/* Insert or update an item, evicting the least recently used entry */
+static void
+_cache_store(dm_item_t item, unsigned index, const void *buf, size_t len)
+{
+	if (g_cache == nullptr || len > sizeof(g_cache[0].data)) {
+		return;
+	}
+
+	dm_cache_entry_t *entry = _cache_find(item, index);
+
+	if (entry == nullptr) {
+		entry = &g_cache[0];
+
+		for (unsigned i = 0; i < DM_CACHE_ENTRIES; i++) {
+			if (g_cache[i].item == DM_KEY_NUM_KEYS) {
+				entry = &g_cache[i];
+				break;
+			}
+
+			if (g_cache[i].last_used < entry->last_used) {
+				entry = &g_cache[i];
+			}
+		}
+
+		entry->item = item;
+		entry->index = index;
+		entry->last_used = ++g_cache_clock;
+	}
+
+	entry->len = len;
+
+	if (len > 0) {
+		memcpy(entry->data, buf, len);
+	}
+}
+
+static void
+_cache_drop(dm_item_t item, unsigned index)
+{
+	dm_cache_entry_t *entry = _cache_find(item, index);
+
+	if (entry) {
+		entry->item = DM_KEY_NUM_KEYS;
+	}
+}
+
+/* Invalidate all entries of an item type, or all entries for DM_KEY_NUM_KEYS */
+static void
+_cache_invalidate(dm_item_t item)
+{
+	if (g_cache == nullptr) {
+		return;
+	}
+
+	for (unsigned i = 0; i < DM_CACHE_ENTRIES; i++) {
+		if (item == DM_KEY_NUM_KEYS || g_cache[i].item == item) {
+			g_cache[i].item = DM_KEY_NUM_KEYS;
+		}
+	}
+}
+
 /* Each data item is stored as follows
  *
  * byte 0: Length of user data item
@@ -537,9 +683,12 @@ _file_write(dm_item_t item, unsigned index, dm_persitence_t persistence, const v
 
 	/* Make sure the write succeeded */
 	if (len != count) {
+		_cache_drop(item, index);
 		return -1;
 	}
 
+	_cache_store(item, index, buf, count - DM_SECTOR_HDR_SIZE);
+
 	/* All is well... return the number of user data written */
 	return count - DM_SECTOR_HDR_SIZE;
 }
@@ -627,6 +776,22 @@ _file_read(dm_item_t item, unsigned index, void *buf, size_t count)
 		return -E2BIG;
 	}
 
+	/* Serve recently used items from the cache */
+	dm_cache_entry_t *entry = _cache_find(item, index);
+
+	if (entry) {
+		g_cache_hits++;
+
+		if (entry->len > count) {
+			return -1;
+		}
+
+		memcpy(buf, entry->data, entry->len);
+		return entry->len;
+	}
+
+	g_cache_misses++;
+
 	/* Read the prefix and data */
 	len = -1;
 
@@ -655,6 +820,11 @@ _file_read(dm_item_t item, unsigned index, void *buf, size_t count)
 		memcpy(buf, buffer + DM_SECTOR_HDR_SIZE, buffer[0]);
 	}
 
+	/* Only complete entries go into the cache */
+	if (len == 0 || len >= buffer[0] + DM_SECTOR_HDR_SIZE) {
+		_cache_store(item, index, buf, buffer[0]);
+	}
+
 	/* Return the number of bytes of caller data read */
 	return buffer[0];
 }
@@ -709,6 +879,8 @@ _file_clear(dm_item_t item)
 		return -1;
 	}
 
+	_cache_invalidate(item);
+
 	/* Clear all items of this type */
 	for (i = 0; (unsigned)i < g_per_item_max_index[item]; i++) {
 		char buf[1];
@@ -806,6 +978,9 @@ _file_restart(dm_reset_reason reason)
 {
 	unsigned offset = 0;
 	int result = 0;
+
+	_cache_invalidate(DM_KEY_NUM_KEYS);
+
 	/* We need to scan the entire file and invalidate and data that should not persist after the last reset */
 
 	/* Loop through all of the data segments and delete those that are not persistent */
@@ -923,6 +1098,8 @@ _file_initialize(unsigned max_offset)
 		return -1;
 	}
 
+	_cache_init();
+
 	/* Write current compat info */
 	struct dataman_compat_s compat_state;
 	compat_state.key = DM_COMPAT_KEY;
@@ -998,6 +1175,7 @@ _ram_flash_initialize(unsigned max_offset)
 static void
 _file_shutdown()
 {
+	_cache_free();
 	close(dm_operations_data.file.fd);
 	dm_operations_data.running = false;
 }
@@ -1131,6 +1309,62 @@ dm_read(dm_item_t item, unsigned index, void *buf, size_t count)
 	return (ssize_t)enqueue_work_item_and_wait_for_result(work);
 }
 
+/** Retrieve a range of items from the data manager file */
+__EXPORT ssize_t
+dm_read_range(dm_item_t item, unsigned index, unsigned num, void *buf, size_t count)
+{
+	work_q_item_t *work;
+
+	/* Make sure data manager has been started and is not shutting down */
+	if (!is_running() || g_task_should_exit) {
+		return -1;
+	}
+
+	/* get a work item and queue up a range read request */
+	if ((work = create_work_item()) == nullptr) {
+		return -1;
+	}
+
+	work->func = dm_read_range_func;
+	work->read_range_params.item = item;
+	work->read_range_params.index = index;
+	work->read_range_params.num = num;
+	work->read_range_params.buf = buf;
+	work->read_range_params.count = count;
+
+	/* Enqueue the item on the work queue and wait for the worker thread to complete processing it */
+	return (ssize_t)enqueue_work_item_and_wait_for_result(work);
+}
+
+/** Write a range of items to the data manager file */
+__EXPORT ssize_t
+dm_write_range(dm_item_t item, unsigned index, unsigned num, dm_persitence_t persistence, const void *buf,
+	       size_t count)
+{
+	work_q_item_t *work;
+
+	/* Make sure data manager has been started and is not shutting down */
+	if (!is_running() || g_task_should_exit) {
+		return -1;
+	}
+
+	/* get a work item and queue up a range write request */
+	if ((work = create_work_item()) == nullptr) {
+		return -1;
+	}
+
+	work->func = dm_write_range_func;
+	work->write_range_params.item = item;
+	work->write_range_params.index = index;
+	work->write_range_params.num = num;
+	work->write_range_params.persistence = persistence;
+	work->write_range_params.buf = buf;
+	work->write_range_params.count = count;
+
+	/* Enqueue the item on the work queue and wait for the worker thread to complete processing it */
+	return (ssize_t)enqueue_work_item_and_wait_for_result(work);
+}
+
 /** Clear a data Item */
 __EXPORT int
 dm_clear(dm_item_t item)
@@ -1222,6 +1456,45 @@ dm_flash_sector_description_set(const dm_sector_descriptor_t *description)
 }
 #endif
 
+/* Read consecutive items, returns the number of leading items read completely */
+static ssize_t
+_read_range(dm_item_t item, unsigned index, unsigned num, void *buf, size_t count)
+{
+	uint8_t *buffer = (uint8_t *)buf;
+	ssize_t result = 0;
+
+	for (unsigned i = 0; i < num; i++) {
+		if (g_dm_ops->read(item, index + i, buffer, count) != (ssize_t)count) {
+			break;
+		}
+
+		buffer += count;
+		result++;
+	}
+
+	return result;
+}
+
+/* Write consecutive items, returns the number of leading items written completely */
+static ssize_t
+_write_range(dm_item_t item, unsigned index, unsigned num, dm_persitence_t persistence, const void *buf,
+	     size_t count)
+{
+	const uint8_t *buffer = (const uint8_t *)buf;
+	ssize_t result = 0;
+
+	for (unsigned i = 0; i < num; i++) {
+		if (g_dm_ops->write(item, index + i, persistence, buffer, count) != (ssize_t)count) {
+			break;
+		}
+
+		buffer += count;
+		result++;
+	}
+
+	return result;
+}
+
 static int
 task_main(int argc, char *argv[])
 {
@@ -1263,6 +1536,12 @@ task_main(int argc, char *argv[])
 		g_func_counts[i] = 0;
 	}
 
+	g_queue_latency_sum = 0;
+	g_queue_latency_max = 0;
+	g_queue_latency_count = 0;
+	g_cache_hits = 0;
+	g_cache_misses = 0;
+
 	/* Initialize the item type locks, for now only DM_KEY_MISSION_STATE supports locking */
 	px4_sem_init(&g_sys_state_mutex, 1, 1); /* Initially unlocked */
 
@@ -1347,6 +1626,15 @@ task_main(int argc, char *argv[])
 		/* Empty the work queue */
 		while ((work = dequeue_work_item())) {
 
+			/* time the item spent waiting on the work queue */
+			hrt_abstime latency = hrt_elapsed_time(&work->queued_time);
+			g_queue_latency_sum += latency;
+			g_queue_latency_count++;
+
+			if (latency > g_queue_latency_max) {
+				g_queue_latency_max = latency;
+			}
+
 			/* handle each work item with the appropriate handler */
 			switch (work->func) {
 			case dm_write_func:
@@ -1363,6 +1651,20 @@ task_main(int argc, char *argv[])
 					g_dm_ops->read(work->read_params.item, work->read_params.index, work->read_params.buf, work->read_params.count);
 				break;
 
+			case dm_read_range_func:
+				g_func_counts[dm_read_range_func]++;
+				work->result =
+					_read_range(work->read_range_params.item, work->read_range_params.index, work->read_range_params.num,
+						    work->read_range_params.buf, work->read_range_params.count);
+				break;
+
+			case dm_write_range_func:
+				g_func_counts[dm_write_range_func]++;
+				work->result =
+					_write_range(work->write_range_params.item, work->write_range_params.index, work->write_range_params.num,
+						     work->write_range_params.persistence, work->write_range_params.buf, work->write_range_params.count);
+				break;
+
 			case dm_clear_func:
 				g_func_counts[dm_clear_func]++;
 				work->result = g_dm_ops->clear(work->clear_params.item);
@@ -1443,7 +1745,19 @@ status()
 	PX4_INFO("Reads    %d", g_func_counts[dm_read_func]);
 	PX4_INFO("Clears   %d", g_func_counts[dm_clear_func]);
 	PX4_INFO("Restarts %d", g_func_counts[dm_restart_func]);
+	PX4_INFO("Range reads %d, range writes %d", g_func_counts[dm_read_range_func], g_func_counts[dm_write_range_func]);
 	PX4_INFO("Max Q lengths work %d, free %d", g_work_q.max_size, g_free_q.max_size);
+
+	if (g_queue_latency_count > 0) {
+		PX4_INFO("Q latency avg %.3f ms, max %.3f ms",
+			 (double)(g_queue_latency_sum / g_queue_latency_count) / 1e3, (double)g_queue_latency_max / 1e3);
+	}
+
+	if (backend == BACKEND_FILE) {
+		unsigned lookups = g_cache_hits + g_cache_misses;
+		PX4_INFO("Cache %d entries, hits %u, misses %u, hit rate %.1f%%", DM_CACHE_ENTRIES, g_cache_hits, g_cache_misses,
+			 lookups > 0 ? (double)(100.f * g_cache_hits / lookups) : 0.0);
+	}
 }
 
 static void
@@ -1474,6 +1788,10 @@ Each type has a specific type and a fixed maximum amount of storage items, so th
 Reading and writing a single item is always atomic. If multiple items need to be read/modified atomically, there is
 an additional lock per item type via `dm_lock`.
 
+All requests are processed in order by a worker task. `dm_read_range` and `dm_write_range` transfer a range of
+consecutive items in a single request. The file backend keeps the most recently used items in a write-through RAM
+cache, so repeated reads of the same items (e.g. mission feasibility checks) do not hit the storage.
+
 **DM_KEY_FENCE_POINTS** and **DM_KEY_SAFE_POINTS** items: the first data element is a `mission_stats_entry_s` struct,
 which stores the number of items for these types. These items are always updated atomically in one transaction (from
 the mavlink mission manager). During that time, navigator will try to acquire the geofence item lock, fail, and will not
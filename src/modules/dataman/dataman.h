@@ -135,6 +135,38 @@ dm_write(
 	size_t buflen			/* Length in bytes of data to retrieve */
 );
 
+/**
+ * Retrieve consecutive items from the data manager store in one request.
+ *
+ * Reads the items index ... index + num - 1 into buffer, each occupying buflen bytes.
+ * @return the number of leading items that were read completely (buflen bytes each),
+ *         or -1 if the data manager is not running
+ */
+__EXPORT ssize_t
+dm_read_range(
+	dm_item_t item,			/* The item type to retrieve */
+	unsigned index,			/* The index of the first item */
+	unsigned num,			/* The number of items to retrieve */
+	void *buffer,			/* Pointer to caller data buffer, num * buflen bytes */
+	size_t buflen			/* Length in bytes of each item */
+);
+
+/**
+ * Write consecutive items to the data manager store in one request.
+ *
+ * @return the number of leading items that were written completely,
+ *         or -1 if the data manager is not running
+ */
+__EXPORT ssize_t
+dm_write_range(
+	dm_item_t  item,		/* The item type to store */
+	unsigned index,			/* The index of the first item */
+	unsigned num,			/* The number of items to store */
+	dm_persitence_t persistence,	/* The persistence level of these items */
+	const void *buffer,		/* Pointer to caller data buffer, num * buflen bytes */
+	size_t buflen			/* Length in bytes of each item */
+);
+
 /** Lock all items of this type */
 __EXPORT void
 dm_lock(
@@ -182,3 +214,67 @@ dm_flash_sector_description_set(
 #ifdef __cplusplus
 }
 #endif
+
+#ifdef __cplusplus
+
+/**
+ * Read consecutive items with one dm_read_range() request per chunk instead of
+ * one dm_read() per item.
+ *
+ * The chunk is a copy: call update() after writing an item that may be cached,
+ * and reset() when the items may have been changed by someone else.
+ */
+template<typename T, unsigned CHUNK = 8>
+class DatamanChunkReader
+{
+public:
+	/**
+	 * Read item index, items up to index + CHUNK - 1 are fetched in the same request.
+	 *
+	 * @param end	index after the last item that exists, nothing beyond it is fetched
+	 * @return	true if the item was read completely
+	 */
+	bool read(dm_item_t item, unsigned index, unsigned end, T *buffer)
+	{
+		if (_count == 0 || item != _item || index < _first || index >= _first + _count) {
+			unsigned num = (end > index) ? end - index : 1;
+
+			if (num > CHUNK) {
+				num = CHUNK;
+			}
+
+			const ssize_t num_read = dm_read_range(item, index, num, _chunk, sizeof(T));
+
+			if (num_read <= 0) {
+				_count = 0;
+				return false;
+			}
+
+			_item = item;
+			_first = index;
+			_count = num_read;
+		}
+
+		*buffer = _chunk[index - _first];
+		return true;
+	}
+
+	/** Keep a cached item in sync after it was written with dm_write() */
+	void update(dm_item_t item, unsigned index, const T &value)
+	{
+		if (_count > 0 && item == _item && index >= _first && index < _first + _count) {
+			_chunk[index - _first] = value;
+		}
+	}
+
+	/** Drop the cached chunk */
+	void reset() { _count = 0; }
+
+private:
+	T _chunk[CHUNK];
+	dm_item_t _item{DM_KEY_NUM_KEYS};
+	unsigned _first{0};
+	unsigned _count{0};
+};
+
+#endif /* __cplusplus */
@@ -55,7 +55,7 @@ public:
 	static constexpr Backend BackendMavlink = 1 << 1;
 	static constexpr Backend BackendAll = BackendFile | BackendMavlink;
 
-	LogWriter(Backend configured_backend, size_t file_buffer_size, unsigned int queue_size);
+	LogWriter(Backend configured_backend, size_t file_buffer_size, unsigned int queue_size, bool file_direct_io = false);
 	~LogWriter();
 
 	bool init();
@@ -137,6 +137,18 @@ public:
 		return 0;
 	}
 
+	uint64_t get_file_position() const
+	{
+		if (_log_writer_file) { return _log_writer_file->get_file_position(); }
+
+		return 0;
+	}
+
+	void print_statistics_file() const
+	{
+		if (_log_writer_file) { _log_writer_file->print_statistics(); }
+	}
+
 
 	/**
 	 * Indicate to the underlying backend whether future write_message() calls need a reliable
@@ -34,6 +34,7 @@
 #include "log_writer_file.h"
 #include "messages.h"
 #include <fcntl.h>
+#include <inttypes.h>
 #include <string.h>
 
 #include <mathlib/mathlib.h>
@@ -47,12 +48,17 @@ namespace px4
 namespace logger
 {
 constexpr size_t LogWriterFile::_min_write_chunk;
+constexpr int LogWriterFile::NUM_BUFFERS;
+constexpr size_t LogWriterFile::_sync_bytes_budget;
+constexpr hrt_abstime LogWriterFile::_sync_time_budget;
+const hrt_abstime LogWriterFile::_histogram_bounds[HISTOGRAM_BUCKETS - 1] = {1000, 2000, 5000, 10000, 20000, 50000, 100000};
 
 
-LogWriterFile::LogWriterFile(size_t buffer_size) :
-	//We always write larger chunks (orb messages) to the buffer, so the buffer
-	//needs to be larger than the minimum write chunk (300 is somewhat arbitrary)
-	_buffer_size(math::max(buffer_size, _min_write_chunk + 300))
+LogWriterFile::LogWriterFile(size_t buffer_size, bool direct_io) :
+	_direct_io(direct_io),
+	//Split the buffer into block-sized write buffers. Each needs to be at least one block.
+	_block_buffer_size(math::max(buffer_size / NUM_BUFFERS / _min_write_chunk, (size_t)1) * _min_write_chunk),
+	_buffer_size(_block_buffer_size * NUM_BUFFERS)
 {
 	pthread_mutex_init(&_mtx, nullptr);
 	pthread_cond_init(&_cv, nullptr);
@@ -84,7 +90,28 @@ LogWriterFile::~LogWriterFile()
 
 void LogWriterFile::start_log(const char *filename)
 {
-	_fd = ::open(filename, O_CREAT | O_WRONLY, PX4_O_MODE_666);
+	int flags = O_CREAT | O_WRONLY;
+	_direct_io_active = false;
+
+#ifdef O_DIRECT
+
+	if (_direct_io) {
+		_fd = ::open(filename, flags | O_DIRECT, PX4_O_MODE_666);
+
+		if (_fd >= 0) {
+			_direct_io_active = true;
+
+		} else {
+			// not all file systems support it (e.g. tmpfs)
+			PX4_WARN("O_DIRECT not supported for %s (%i), using buffered I/O", filename, errno);
+		}
+	}
+
+#endif /* O_DIRECT */
+
+	if (!_direct_io_active) {
+		_fd = ::open(filename, flags, PX4_O_MODE_666);
+	}
 
 	if (_fd < 0) {
 		PX4_ERR("Can't open log file %s, errno: %d", filename, errno);
@@ -93,7 +120,8 @@ void LogWriterFile::start_log(const char *filename)
 	}
 
 	if (_buffer == nullptr) {
-		_buffer = new uint8_t[_buffer_size];
+		// over-allocate so that every write buffer can be aligned to the block size
+		_buffer = new uint8_t[_buffer_size + _min_write_chunk];
 
 		if (_buffer == nullptr) {
 			PX4_ERR("Can't create log buffer");
@@ -102,6 +130,12 @@ void LogWriterFile::start_log(const char *filename)
 			_should_run = false;
 			return;
 		}
+
+		uintptr_t aligned = ((uintptr_t)_buffer + _min_write_chunk - 1) & ~(uintptr_t)(_min_write_chunk - 1);
+
+		for (int i = 0; i < NUM_BUFFERS; ++i) {
+			_buffers[i].data = (uint8_t *)aligned + i * _block_buffer_size;
+		}
 	}
 
 	// register the current file with the hardfault handler: if the system crashes,
@@ -119,10 +153,23 @@ void LogWriterFile::start_log(const char *filename)
 	_should_run = true;
 	_running = true;
 
-	// Clear buffer and counters
-	_head = 0;
+	// Clear buffers and counters
+	for (int i = 0; i < NUM_BUFFERS; ++i) {
+		_buffers[i].count = 0;
+	}
+
+	_fill_index = 0;
+	_write_index = 0;
+	_num_full = 0;
 	_count = 0;
 	_total_written = 0;
+	_file_position = 0;
+	_unsynced_bytes = 0;
+	_last_sync = hrt_absolute_time();
+	memset(_write_histogram, 0, sizeof(_write_histogram));
+	memset(_sync_histogram, 0, sizeof(_sync_histogram));
+	_write_max = 0;
+	_sync_max = 0;
 	notify();
 }
 
@@ -228,24 +275,20 @@ void LogWriterFile::run()
 			break;
 		}
 
-		int poll_count = 0;
-		int written = 0;
-
 		while (true) {
-			size_t available = 0;
-			void *read_ptr = nullptr;
-			bool is_part = false;
+			WriteBuffer *buffer = nullptr;
 
-			/* lock _buffer
-			 * wait for sufficient data, cycle on notify()
+			/* wait for a full buffer, cycle on notify().
+			 * When stopping, the partially filled buffer is handed over as well.
 			 */
 			pthread_mutex_lock(&_mtx);
 
 			while (true) {
-				available = get_read_ptr(&read_ptr, &is_part);
+				if (_num_full == 0 && !_should_run) {
+					rotate_fill_buffer();
+				}
 
-				/* if sufficient data available or partial read or terminating, exit this wait loop */
-				if ((available >= _min_write_chunk) || is_part || !_should_run) {
+				if (_num_full > 0 || !_should_run) {
 					/* GOTO end of block */
 					break;
 				}
@@ -256,44 +299,47 @@ void LogWriterFile::run()
 				pthread_cond_wait(&_cv, &_mtx);
 			}
 
+			if (_num_full > 0) {
+				buffer = &_buffers[_write_index];
+			}
+
 			pthread_mutex_unlock(&_mtx);
-			written = 0;
-
-			if (available > 0) {
-				perf_begin(_perf_write);
-				written = ::write(_fd, read_ptr, available);
-				perf_end(_perf_write);
-
-				/* call fsync periodically to minimize potential loss of data */
-				if (++poll_count >= 100) {
-					perf_begin(_perf_fsync);
-					::fsync(_fd);
-					perf_end(_perf_fsync);
-					poll_count = 0;
-				}
+
+			if (buffer) {
+				/* the logger thread does not touch a full buffer, so it can be written without holding the lock */
+				ssize_t written = write_buffer(buffer->data, buffer->count);
 
 				if (written < 0) {
 					PX4_WARN("error writing log file");
 					_should_run = false;
-					/* GOTO end of block */
-					break;
 				}
 
 				pthread_mutex_lock(&_mtx);
-				/* subtract bytes written from number in _buffer (_count -= written) */
-				mark_read(written);
+				_count -= buffer->count;
+				buffer->count = 0;
+				_write_index = (_write_index + 1) % NUM_BUFFERS;
+				--_num_full;
+
+				/* the logger might have filled up the last free buffer in the meantime */
+				if (_buffers[_fill_index].count == _block_buffer_size) {
+					rotate_fill_buffer();
+				}
+
 				pthread_mutex_unlock(&_mtx);
 
-				_total_written += written;
-			}
+				if (written > 0) {
+					_total_written += written;
+					_unsynced_bytes += written;
+				}
+
+				sync_if_needed(false);
 
-			if (!_should_run && written == static_cast<int>(available) && !is_part) {
+			} else {
 				// Stop only when all data written
 				_running = false;
-				_head = 0;
-				_count = 0;
 
 				if (_fd >= 0) {
+					sync_if_needed(true);
 					int res = ::close(_fd);
 					_fd = -1;
 
@@ -311,6 +357,111 @@ void LogWriterFile::run()
 	}
 }
 
+void LogWriterFile::rotate_fill_buffer()
+{
+	if (_buffers[_fill_index].count > 0 && _num_full < NUM_BUFFERS - 1) {
+		++_num_full;
+		_fill_index = (_fill_index + 1) % NUM_BUFFERS;
+		pthread_cond_broadcast(&_cv);
+	}
+}
+
+ssize_t LogWriterFile::write_buffer(const uint8_t *data, size_t count)
+{
+#ifdef O_DIRECT
+
+	/* direct I/O requires block-sized writes, which is only violated by the tail at the end of a log */
+	if (_direct_io_active && (count % _min_write_chunk) != 0) {
+		int flags = fcntl(_fd, F_GETFL);
+
+		if (flags != -1 && fcntl(_fd, F_SETFL, flags & ~O_DIRECT) == 0) {
+			_direct_io_active = false;
+		}
+	}
+
+#endif /* O_DIRECT */
+
+	size_t total = 0;
+
+	while (total < count) {
+		hrt_abstime start = hrt_absolute_time();
+		perf_begin(_perf_write);
+		ssize_t written = ::write(_fd, data + total, count - total);
+		perf_end(_perf_write);
+		hrt_abstime elapsed = hrt_elapsed_time(&start);
+
+		if (written <= 0) {
+			return written < 0 ? written : -1;
+		}
+
+		histogram_add(_write_histogram, elapsed);
+
+		if (elapsed > _write_max) {
+			_write_max = elapsed;
+		}
+
+		total += written;
+	}
+
+	return total;
+}
+
+void LogWriterFile::sync_if_needed(bool force)
+{
+	if (_fd < 0 || _unsynced_bytes == 0) {
+		return;
+	}
+
+	/* sync periodically to minimize potential loss of data, but only as often as the budget requires */
+	if (!force && _unsynced_bytes < _sync_bytes_budget && hrt_elapsed_time(&_last_sync) < _sync_time_budget) {
+		return;
+	}
+
+	hrt_abstime start = hrt_absolute_time();
+	perf_begin(_perf_fsync);
+#if defined(__PX4_LINUX)
+	::fdatasync(_fd);
+#else
+	::fsync(_fd);
+#endif
+	perf_end(_perf_fsync);
+
+	_last_sync = hrt_absolute_time();
+	hrt_abstime elapsed = _last_sync - start;
+	histogram_add(_sync_histogram, elapsed);
+
+	if (elapsed > _sync_max) {
+		_sync_max = elapsed;
+	}
+
+	_unsynced_bytes = 0;
+}
+
+void LogWriterFile::histogram_add(uint32_t *histogram, hrt_abstime elapsed)
+{
+	int i = 0;
+
+	while (i < HISTOGRAM_BUCKETS - 1 && elapsed >= _histogram_bounds[i]) {
+		++i;
+	}
+
+	++histogram[i];
+}
+
+void LogWriterFile::histogram_print(const char *name, const uint32_t *histogram, hrt_abstime max)
+{
+	PX4_INFO("%s [ms]: <1: %" PRIu32 ", <2: %" PRIu32 ", <5: %" PRIu32 ", <10: %" PRIu32 ", <20: %" PRIu32
+		 ", <50: %" PRIu32 ", <100: %" PRIu32 ", >=100: %" PRIu32 ", max: %.1f", name, histogram[0], histogram[1],
+		 histogram[2], histogram[3], histogram[4], histogram[5], histogram[6], histogram[7], (double)max / 1e3);
+}
+
+void LogWriterFile::print_statistics() const
+{
+	PX4_INFO("Write buffers: %i x %zu B%s", NUM_BUFFERS, _block_buffer_size, _direct_io_active ? " (O_DIRECT)" : "");
+	histogram_print("write latency", _write_histogram, _write_max);
+	histogram_print("sync latency", _sync_histogram, _sync_max);
+}
+
 int LogWriterFile::write_message(void *ptr, size_t size, uint64_t dropout_start)
 {
 	if (_need_reliable_transfer) {
@@ -335,8 +486,9 @@ int LogWriterFile::write(void *ptr, size_t size, uint64_t dropout_start)
 		return 0;
 	}
 
-	// Bytes available to write
-	size_t available = _buffer_size - _count;
+	// Bytes available to write: rest of the current buffer plus all free buffers
+	size_t available = _block_buffer_size - _buffers[_fill_index].count +
+			   (NUM_BUFFERS - 1 - _num_full) * _block_buffer_size;
 	size_t dropout_size = 0;
 
 	if (dropout_start) {
@@ -361,41 +513,24 @@ int LogWriterFile::write(void *ptr, size_t size, uint64_t dropout_start)
 
 void LogWriterFile::write_no_check(void *ptr, size_t size)
 {
-	size_t n = _buffer_size - _head;	// bytes to end of the buffer
-
 	uint8_t *buffer_c = reinterpret_cast<uint8_t *>(ptr);
 
-	if (size > n) {
-		// Message goes over the end of the buffer
-		memcpy(&(_buffer[_head]), buffer_c, n);
-		_head = 0;
-
-	} else {
-		n = 0;
-	}
-
-	// now: n = bytes already written
-	size_t p = size - n;	// number of bytes to write
-	memcpy(&(_buffer[_head]), &(buffer_c[n]), p);
-	_head = (_head + p) % _buffer_size;
-	_count += size;
-}
-
-size_t LogWriterFile::get_read_ptr(void **ptr, bool *is_part)
-{
-	// bytes available to read
-	int read_ptr = _head - _count;
-
-	if (read_ptr < 0) {
-		read_ptr += _buffer_size;
-		*ptr = &_buffer[read_ptr];
-		*is_part = true;
-		return _buffer_size - read_ptr;
-
-	} else {
-		*ptr = &_buffer[read_ptr];
-		*is_part = false;
-		return _count;
+	while (size > 0) {
+		WriteBuffer &buffer = _buffers[_fill_index];
+		size_t n = math::min(size, _block_buffer_size - buffer.count);	// bytes that fit into the current buffer
+
+		memcpy(&buffer.data[buffer.count], buffer_c, n);
+		buffer.count += n;
+		_count += n;
+		_file_position += n;
+		buffer_c += n;
+		size -= n;
+
+		if (buffer.count == _block_buffer_size) {
+			// Message goes over the end of the buffer, or fills it exactly: hand it to the writer thread.
+			// If no buffer is free, this is retried when the writer thread finishes one.
+			rotate_fill_buffer();
+		}
 	}
 }
 
@@ -46,12 +46,21 @@ namespace logger
 
 /**
  * @class LogWriterFile
- * Writes logging data to a file
+ * Writes logging data to a file.
+ *
+ * The write buffer is split into NUM_BUFFERS block-aligned buffers: the logger thread fills one while
+ * the writer thread writes out the others, so the mutex is only held to hand over a full buffer.
+ * Every write to the file is a whole buffer (a multiple of the block size), except for the tail when
+ * the log is stopped.
  */
 class LogWriterFile
 {
 public:
-	LogWriterFile(size_t buffer_size);
+	/**
+	 * @param buffer_size total size of all write buffers
+	 * @param direct_io open the log file with O_DIRECT, where supported
+	 */
+	LogWriterFile(size_t buffer_size, bool direct_io = false);
 	~LogWriterFile();
 
 	bool init();
@@ -103,6 +112,19 @@ public:
 		return _count;
 	}
 
+	/**
+	 * File offset at which the next message will be written. Must be called with lock() held.
+	 */
+	uint64_t get_file_position() const
+	{
+		return _file_position;
+	}
+
+	/**
+	 * print write & sync latency histograms
+	 */
+	void print_statistics() const;
+
 	void set_need_reliable_transfer(bool need_reliable)
 	{
 		_need_reliable_transfer = need_reliable;
@@ -118,12 +140,25 @@ private:
 
 	void run();
 
-	size_t get_read_ptr(void **ptr, bool *is_part);
+	/**
+	 * Hand the buffer that is currently being filled over to the writer thread,
+	 * if it contains data and the next buffer is free. Must be called with the mutex held.
+	 */
+	void rotate_fill_buffer();
 
-	void mark_read(size_t n)
-	{
-		_count -= n;
-	}
+	/**
+	 * write a full buffer to the file
+	 * @return bytes written, <0 on error
+	 */
+	ssize_t write_buffer(const uint8_t *data, size_t count);
+
+	/**
+	 * flush the file to the storage if the byte or time budget since the last sync is used up
+	 */
+	void sync_if_needed(bool force);
+
+	static void histogram_add(uint32_t *histogram, hrt_abstime elapsed);
+	static void histogram_print(const char *name, const uint32_t *histogram, hrt_abstime max);
 
 	/**
 	 * permanently store the ulog file name for the hardfault crash handler, so that it can
@@ -143,15 +178,44 @@ private:
 	 */
 	inline void write_no_check(void *ptr, size_t size);
 
-	/* 512 didn't seem to work properly, 4096 should match the FAT cluster size */
+	/* 512 didn't seem to work properly, 4096 should match the FAT cluster size.
+	 * Each buffer is a multiple of this size, and aligned to it (required for O_DIRECT) */
 	static constexpr size_t	_min_write_chunk = 4096;
 
+	static constexpr int NUM_BUFFERS = 3; ///< one being filled, the others being written or waiting to be written
+
+	/* sync the file after this many bytes or this much time, whichever comes first */
+	static constexpr size_t	_sync_bytes_budget = 256 * 1024;
+	static constexpr hrt_abstime _sync_time_budget = 1000000;
+
+	/* latency histogram bucket upper bounds [us], the last bucket counts everything above */
+	static constexpr int HISTOGRAM_BUCKETS = 8;
+	static const hrt_abstime _histogram_bounds[HISTOGRAM_BUCKETS - 1];
+
+	struct WriteBuffer {
+		uint8_t *data;
+		size_t count; ///< number of bytes filled
+	};
+
 	int			_fd = -1;
-	uint8_t 	*_buffer = nullptr;
+	const bool		_direct_io;
+	bool			_direct_io_active = false; ///< file is currently open with O_DIRECT
+	uint8_t 	*_buffer = nullptr; ///< backing allocation of all write buffers (unaligned)
+	const size_t	_block_buffer_size; ///< size of a single write buffer
 	const size_t	_buffer_size;
-	size_t			_head = 0; ///< next position to write to
-	size_t			_count = 0; ///< number of bytes in _buffer to be written
+	WriteBuffer		_buffers[NUM_BUFFERS] = {};
+	int			_fill_index = 0; ///< buffer the logger thread writes into
+	int			_write_index = 0; ///< oldest full buffer, next to be written out
+	int			_num_full = 0; ///< number of buffers handed over to the writer thread
+	size_t			_count = 0; ///< number of bytes in all buffers to be written
 	size_t		_total_written = 0;
+	uint64_t	_file_position = 0; ///< number of bytes added to the buffers since the file was opened
+	size_t		_unsynced_bytes = 0; ///< bytes written since the last sync
+	hrt_abstime	_last_sync = 0;
+	uint32_t	_write_histogram[HISTOGRAM_BUCKETS] = {};
+	uint32_t	_sync_histogram[HISTOGRAM_BUCKETS] = {};
+	hrt_abstime	_write_max = 0;
+	hrt_abstime	_sync_max = 0;
 	bool		_should_run = false;
 	bool		_running = false;
 	bool 		_exit_thread = false;
@@ -34,6 +34,7 @@
 #include <px4_config.h>
 #include "logger.h"
 #include "messages.h"
+#include "ulog_compression.h"
 
 #include <dirent.h>
 #include <sys/stat.h>
@@ -161,6 +162,21 @@ The implementation uses two threads:
 - The writer thread, writing data to the file
 
 In between there is a write buffer with configurable size. It should be large to avoid dropouts.
+The buffer is split into 3 block-aligned parts, so that the main thread can keep filling one part while
+the writer thread writes out the others. The file is synced after 256 KiB or 1 second, whichever comes first.
+
+By default the main thread checks every logged topic instance in each iteration. In event-driven mode (-u),
+the topics set a bit on every publication, and an iteration only visits the topics that have their bit set.
+The `logger_tick` perf counter measures the time spent per iteration in either mode.
+
+With -c, data messages of file logs are encoded: each sample is stored as a zero-run encoded XOR delta to the
+previous sample of the same topic instance, with a full keyframe every 100 samples. This only works well
+for topics with slowly changing fields, and such logs can only be read by tools that know the encoding
+(e.g. replay). The mavlink backend always gets unencoded data.
+
+With -i, a time index is appended to each log file when it is closed: per topic instance, the file offset
+and timestamp of a data message every 100 ms (or less often for long logs, as the index has a fixed size).
+Replay uses it to seek directly to the start of a time window.
 
 ### Examples
 Typical usage to start logging immediately:
@@ -179,6 +195,10 @@ $ logger on
 	PRINT_MODULE_USAGE_PARAM_INT('r', 280, 0, 8000, "Log rate in Hz, 0 means unlimited rate", true);
 	PRINT_MODULE_USAGE_PARAM_INT('b', 12, 4, 10000, "Log buffer size in KiB", true);
 	PRINT_MODULE_USAGE_PARAM_INT('q', 14, 1, 100, "uORB queue size for mavlink mode", true);
+	PRINT_MODULE_USAGE_PARAM_FLAG('d', "Open log files with O_DIRECT (bypass the page cache, where supported)", true);
+	PRINT_MODULE_USAGE_PARAM_FLAG('u', "Event-driven: each iteration only copies topics that were updated", true);
+	PRINT_MODULE_USAGE_PARAM_FLAG('c', "Compress data messages of log files (only readable by replay)", true);
+	PRINT_MODULE_USAGE_PARAM_FLAG('i', "Append a time index to log files (for fast seeking in replay)", true);
 	PRINT_MODULE_USAGE_PARAM_STRING('p', nullptr, "<topic_name>",
 					 "Poll on a topic instead of running with fixed rate (Log rate and topic intervals are ignored if this is set)", true);
 	PRINT_MODULE_USAGE_COMMAND_DESCR("on", "start logging now, override arming (logger must be running)");
@@ -209,6 +229,19 @@ int Logger::print_status()
 {
 	PX4_INFO("Running in mode: %s", configured_backend_mode());
 
+	if (_event_driven) {
+		PX4_INFO("Event-driven: only updated topics are visited");
+	}
+
+	if (_compress) {
+		PX4_INFO("Data compression enabled");
+	}
+
+	if (_index) {
+		PX4_INFO("Time index: %i / %i entries, interval %u ms", _index_count, INDEX_MAX_ENTRIES,
+			 (unsigned)(_index_interval / 1000));
+	}
+
 	if (_writer.is_started(LogWriter::BackendFile)) {
 		PX4_INFO("File Logging Running");
 		print_statistics();
@@ -234,8 +267,19 @@ void Logger::print_statistics()
 
 	PX4_INFO("Log file: %s/%s", _log_dir, _log_file_name);
 	PX4_INFO("Wrote %4.2f MiB (avg %5.2f KiB/s)", (double)mebibytes, (double)(kibibytes / seconds));
+	_writer.print_statistics_file();
 	PX4_INFO("Since last status: dropouts: %zu (max len: %.3f s), max used buffer: %zu / %zu B",
 		 _write_dropouts, (double)_max_dropout_duration, _high_water, _writer.get_buffer_size_file());
+	PX4_INFO("Since last status: lost queued samples: %zu", _lost_queued_samples);
+
+	if (_compress_file_log && _compress_out_bytes > 0) {
+		PX4_INFO("Compression: %.1f KiB -> %.1f KiB (ratio %.2f), avg encode time: %.2f us",
+			 (double)(_compress_raw_bytes / 1024.0f), (double)(_compress_out_bytes / 1024.0f),
+			 (double)((float)_compress_raw_bytes / _compress_out_bytes),
+			 (double)(_compress_count > 0 ? (float)_compress_time / _compress_count : 0.f));
+	}
+
+	_lost_queued_samples = 0;
 	_high_water = 0;
 	_write_dropouts = 0;
 	_max_dropout_duration = 0.f;
@@ -249,6 +293,10 @@ Logger *Logger::instantiate(int argc, char *argv[])
 	bool log_until_shutdown = false;
 	bool error_flag = false;
 	bool log_name_timestamp = false;
+	bool direct_io = false;
+	bool event_driven = false;
+	bool compress = false;
+	bool index = false;
 	unsigned int queue_size = 14; //TODO: we might be able to reduce this if mavlink polled on the topic and/or
 	// topic sizes get reduced
 	LogWriter::Backend backend = LogWriter::BackendAll;
@@ -258,7 +306,7 @@ Logger *Logger::instantiate(int argc, char *argv[])
 	int ch;
 	const char *myoptarg = nullptr;
 
-	while ((ch = px4_getopt(argc, argv, "r:b:etfm:q:p:", &myoptind, &myoptarg)) != EOF) {
+	while ((ch = px4_getopt(argc, argv, "r:b:etfm:q:p:duci", &myoptind, &myoptarg)) != EOF) {
 		switch (ch) {
 		case 'r': {
 				unsigned long r = strtoul(myoptarg, nullptr, 10);
@@ -290,6 +338,22 @@ Logger *Logger::instantiate(int argc, char *argv[])
 			log_name_timestamp = true;
 			break;
 
+		case 'd':
+			direct_io = true;
+			break;
+
+		case 'u':
+			event_driven = true;
+			break;
+
+		case 'c':
+			compress = true;
+			break;
+
+		case 'i':
+			index = true;
+			break;
+
 		case 'f':
 			log_on_start = true;
 			log_until_shutdown = true;
@@ -341,7 +405,7 @@ Logger *Logger::instantiate(int argc, char *argv[])
 	}
 
 	Logger *logger = new Logger(backend, log_buffer_size, log_interval, poll_topic, log_on_start,
-				    log_until_shutdown, log_name_timestamp, queue_size);
+				    log_until_shutdown, log_name_timestamp, queue_size, direct_io, event_driven, compress, index);
 
 #if defined(DBGPRINT) && defined(__PX4_NUTTX)
 	struct mallinfo alloc_info = mallinfo();
@@ -370,14 +434,21 @@ Logger *Logger::instantiate(int argc, char *argv[])
 
 
 Logger::Logger(LogWriter::Backend backend, size_t buffer_size, uint32_t log_interval, const char *poll_topic_name,
-	       bool log_on_start, bool log_until_shutdown, bool log_name_timestamp, unsigned int queue_size) :
+	       bool log_on_start, bool log_until_shutdown, bool log_name_timestamp, unsigned int queue_size, bool direct_io,
+	       bool event_driven, bool compress, bool index) :
 	_arm_override(false),
 	_log_on_start(log_on_start),
 	_log_until_shutdown(log_until_shutdown),
 	_log_name_timestamp(log_name_timestamp),
-	_writer(backend, buffer_size, queue_size),
-	_log_interval(log_interval)
+	_writer(backend, buffer_size, queue_size, direct_io),
+	_log_interval(log_interval),
+	_event_driven(event_driven),
+	_compress(compress),
+	_index(index)
 {
+	_tick_perf = perf_alloc(PC_ELAPSED, "logger_tick");
+	_compress_perf = perf_alloc(PC_ELAPSED, "logger_compress");
+
 	_log_utc_offset = param_find("SDLOG_UTC_OFFSET");
 	_log_dirs_max = param_find("SDLOG_DIRS_MAX");
 	_sdlog_profile_handle = param_find("SDLOG_PROFILE");
@@ -407,6 +478,29 @@ Logger::~Logger()
 	if (_msg_buffer) {
 		delete[](_msg_buffer);
 	}
+
+	if (_compress_buffer) {
+		delete[](_compress_buffer);
+	}
+
+	if (_compression_state) {
+		for (size_t i = 0; i < MAX_TOPICS_NUM * ORB_MULTI_MAX_INSTANCES; ++i) {
+			delete[](_compression_state[i].prev);
+		}
+
+		delete[](_compression_state);
+	}
+
+	if (_index_entries) {
+		delete[](_index_entries);
+	}
+
+	if (_index_topic_state) {
+		delete[](_index_topic_state);
+	}
+
+	perf_free(_tick_perf);
+	perf_free(_compress_perf);
 }
 
 bool Logger::request_stop_static()
@@ -478,6 +572,12 @@ int Logger::add_topic(const char *name, unsigned interval = 0)
 	// if we poll on a topic, we don't set the interval and let the polled topic define the maximum interval
 	if (!_polling_topic_meta && fd >= 0) {
 		orb_set_interval(fd, interval);
+
+		for (LoggerSubscription &sub : _subscriptions) {
+			if (sub.fd[0] == fd) {
+				sub.rate_limited = interval > 0;
+			}
+		}
 	}
 
 	return fd;
@@ -515,14 +615,254 @@ bool Logger::copy_if_updated_multi(LoggerSubscription &sub, int multi_instance,
 		}
 
 	} else if (handle >= 0) {
-		orb_check(handle, &updated);
+		/* check and copy with a single call, which also reports queued samples we were too slow for */
+		uint32_t lost = 0;
+		updated = orb_copy_batch(sub.metadata, handle, buffer, 1, &lost) == 1;
+		_lost_queued_samples += lost;
+	}
+
+	return updated;
+}
+
+bool Logger::write_data_message(const LoggerSubscription &sub, int multi_instance)
+{
+	/* each message consists of a header followed by an orb data object
+	 */
+	size_t msg_size = sizeof(ulog_message_data_header_s) + sub.metadata->o_size_no_padding;
+	uint16_t write_msg_size = static_cast<uint16_t>(msg_size - ULOG_MSG_HEADER_LEN);
+	//write one byte after another (necessary because of alignment)
+	_msg_buffer[0] = (uint8_t)write_msg_size;
+	_msg_buffer[1] = (uint8_t)(write_msg_size >> 8);
+	_msg_buffer[2] = static_cast<uint8_t>(ULogMessageType::DATA);
+	uint16_t write_msg_id = sub.msg_ids[multi_instance];
+	_msg_buffer[3] = (uint8_t)write_msg_id;
+	_msg_buffer[4] = (uint8_t)(write_msg_id >> 8);
+
+	//PX4_INFO("topic: %s, size = %zu, out_size = %zu", sub.metadata->o_name, sub.metadata->o_size, msg_size);
+
+	if (_compress_file_log && _writer.is_started(LogWriter::BackendFile)) {
+		return write_compressed_data_message(sub, multi_instance);
+	}
+
+	const uint64_t file_position = _writer.get_file_position();
+
+	if (write_message(_msg_buffer, msg_size)) {
 
-		if (updated) {
-			orb_copy(sub.metadata, handle, buffer);
+		if (_index) {
+			uint64_t timestamp; // the timestamp is the first field of every topic
+			memcpy(&timestamp, _msg_buffer + sizeof(ulog_message_data_header_s), sizeof(timestamp));
+			add_index_entry(write_msg_id, timestamp, file_position, msg_size);
 		}
+
+#ifdef DBGPRINT
+		_total_bytes += msg_size;
+#endif /* DBGPRINT */
+
+		return true;
 	}
 
-	return updated;
+	return false;
+}
+
+bool Logger::write_compressed_data_message(const LoggerSubscription &sub, int multi_instance)
+{
+	const size_t data_size = sub.metadata->o_size_no_padding;
+	const size_t msg_size = sizeof(ulog_message_data_header_s) + data_size;
+	const uint16_t msg_id = sub.msg_ids[multi_instance];
+	const uint8_t *data = _msg_buffer + sizeof(ulog_message_data_header_s);
+	CompressionState &state = _compression_state[msg_id];
+
+	/* the mavlink log gets the unencoded message (the flag bits are only set for the file) */
+	if (_writer.is_started(LogWriter::BackendMavlink)) {
+		_writer.select_write_backend(LogWriter::BackendMavlink);
+		write_message(_msg_buffer, msg_size);
+	}
+
+	perf_begin(_compress_perf);
+	const hrt_abstime encode_start = hrt_absolute_time();
+
+	if (!state.prev) {
+		state.prev = new uint8_t[data_size];
+	}
+
+	uint64_t timestamp; // the timestamp is the first field of every topic
+	memcpy(&timestamp, data, sizeof(timestamp));
+
+	/* index entries must point to a sample that can be decoded without the previous ones */
+	const bool keyframe = !state.valid || !state.prev || state.samples_since_keyframe >= COMPRESSION_KEYFRAME_INTERVAL ||
+			      (_index && index_entry_due(msg_id, timestamp));
+	const size_t header_size = sizeof(ulog_message_data_header_s) + 1;
+
+	/* only use the encoded data if it's actually smaller than the raw data */
+	size_t encoded_size = ulog_encode(data, keyframe ? nullptr : state.prev, data_size, _compress_buffer + header_size,
+					  data_size - 1);
+	ULogDataEncoding encoding = keyframe ? ULogDataEncoding::KEYFRAME : ULogDataEncoding::DELTA;
+
+	if (encoded_size == 0) {
+		memcpy(_compress_buffer + header_size, data, data_size);
+		encoded_size = data_size;
+		encoding = ULogDataEncoding::RAW;
+	}
+
+	const size_t out_size = header_size + encoded_size;
+	const uint16_t write_msg_size = static_cast<uint16_t>(out_size - ULOG_MSG_HEADER_LEN);
+	memcpy(_compress_buffer, _msg_buffer, sizeof(ulog_message_data_header_s));
+	_compress_buffer[0] = (uint8_t)write_msg_size;
+	_compress_buffer[1] = (uint8_t)(write_msg_size >> 8);
+	_compress_buffer[sizeof(ulog_message_data_header_s)] = static_cast<uint8_t>(encoding);
+
+	_compress_time += hrt_elapsed_time(&encode_start);
+	++_compress_count;
+	perf_end(_compress_perf);
+
+	_writer.select_write_backend(LogWriter::BackendFile);
+	const uint64_t file_position = _writer.get_file_position();
+	const bool written = write_message(_compress_buffer, out_size);
+	_writer.unselect_write_backend();
+
+	if (!written) {
+		/* the reader did not get this sample, so keep the old reference */
+		return false;
+	}
+
+	if (_index && encoding != ULogDataEncoding::DELTA) {
+		add_index_entry(msg_id, timestamp, file_position, out_size);
+	}
+
+	/* RAW and KEYFRAME both give the reader a full sample to delta against */
+	if (state.prev) {
+		memcpy(state.prev, data, data_size);
+		state.valid = true;
+		state.samples_since_keyframe = encoding == ULogDataEncoding::DELTA ? state.samples_since_keyframe + 1 : 0;
+
+	} else {
+		state.valid = false;
+	}
+
+	_compress_raw_bytes += msg_size;
+	_compress_out_bytes += out_size;
+
+#ifdef DBGPRINT
+	_total_bytes += out_size;
+#endif /* DBGPRINT */
+
+	return true;
+}
+
+bool Logger::index_entry_due(uint16_t msg_id, uint64_t timestamp) const
+{
+	const IndexTopicState &state = _index_topic_state[msg_id];
+	return !state.has_entry || timestamp >= state.last_timestamp + _index_interval;
+}
+
+void Logger::add_index_entry(uint16_t msg_id, uint64_t timestamp, uint64_t file_position, size_t msg_size)
+{
+	const uint64_t new_file_position = _writer.get_file_position();
+
+	/* the message might not have gone to the file (e.g. only the mavlink backend was selected) */
+	if (new_file_position - file_position < msg_size || !index_entry_due(msg_id, timestamp)) {
+		return;
+	}
+
+	if (_index_count == INDEX_MAX_ENTRIES) {
+		/* index is full: halve the resolution by dropping every 2nd entry of each msg_id */
+		uint8_t keep[MAX_TOPICS_NUM * ORB_MULTI_MAX_INSTANCES] = {};
+		int count = 0;
+
+		for (int i = 0; i < _index_count; ++i) {
+			if ((keep[_index_entries[i].msg_id]++ & 1) == 0) {
+				_index_entries[count++] = _index_entries[i];
+			}
+		}
+
+		_index_count = count;
+		_index_interval *= 2;
+
+		if (_index_count == INDEX_MAX_ENTRIES) {
+			return; // every msg_id has a single entry (more topic instances than entries)
+		}
+	}
+
+	IndexEntry &entry = _index_entries[_index_count++];
+	entry.timestamp = timestamp;
+	entry.offset = new_file_position - msg_size; // a dropout message might have been written before
+	entry.msg_id = msg_id;
+
+	IndexTopicState &state = _index_topic_state[msg_id];
+	state.last_timestamp = timestamp;
+	state.has_entry = true;
+}
+
+void Logger::write_index()
+{
+	static constexpr int entries_per_message = 64;
+	uint8_t buffer[sizeof(ulog_message_index_header_s) + entries_per_message * sizeof(ulog_index_entry_s)];
+
+	_writer.lock();
+	_writer.select_write_backend(LogWriter::BackendFile);
+
+	ulog_message_index_footer_s footer;
+	footer.index_offset = _writer.get_file_position();
+	memcpy(footer.magic, ULOG_INDEX_FOOTER_MAGIC, sizeof(footer.magic));
+
+	for (uint16_t msg_id = 0; msg_id < _next_topic_id; ++msg_id) {
+		const IndexTopicState &state = _index_topic_state[msg_id];
+
+		if (state.add_logged_offset == 0) {
+			continue;
+		}
+
+		ulog_message_index_header_s header;
+		header.msg_id = msg_id;
+		header.add_logged_offset = state.add_logged_offset;
+
+		/* entries are in chronological order, so they stay sorted per msg_id */
+		int i = 0;
+
+		do {
+			int num_entries = 0;
+			ulog_index_entry_s *entries = (ulog_index_entry_s *)(buffer + sizeof(header));
+
+			for (; i < _index_count && num_entries < entries_per_message; ++i) {
+				if (_index_entries[i].msg_id == msg_id) {
+					entries[num_entries].timestamp = _index_entries[i].timestamp;
+					entries[num_entries].offset = _index_entries[i].offset;
+					++num_entries;
+				}
+			}
+
+			const size_t msg_size = sizeof(header) + num_entries * sizeof(ulog_index_entry_s);
+			header.msg_size = msg_size - ULOG_MSG_HEADER_LEN;
+			memcpy(buffer, &header, sizeof(header));
+			write_message(buffer, msg_size);
+
+		} while (i < _index_count);
+	}
+
+	write_message(&footer, sizeof(footer));
+
+	_writer.unselect_write_backend();
+	_writer.unlock();
+}
+
+void Logger::register_update_callback(int sub_idx, int multi_instance)
+{
+	const int index = sub_idx * ORB_MULTI_MAX_INSTANCES + multi_instance;
+
+	if (_update_callbacks == nullptr || _update_callbacks[index] != nullptr) {
+		return;
+	}
+
+	LoggerUpdateCallback *callback = new LoggerUpdateCallback(_subscriptions[sub_idx].metadata, multi_instance,
+			&_updated_mask[index / 32], 1u << (index % 32));
+
+	if (callback == nullptr || !callback->registerCallback()) {
+		PX4_ERR("failed to register update callback for %s", _subscriptions[sub_idx].metadata->o_name);
+		delete callback;
+		return;
+	}
+
+	_update_callbacks[index] = callback;
 }
 
 void Logger::add_common_topics()
@@ -774,6 +1114,27 @@ void Logger::run()
 		}
 	}
 
+	if (_compress) {
+		// encoding byte + worst case expansion of the encoder (1 control byte per 128 literal bytes)
+		_compress_buffer = new uint8_t[_msg_buffer_len + 1 + _msg_buffer_len / ULOG_COMPRESSION_MAX_RUN + 1];
+		_compression_state = new CompressionState[MAX_TOPICS_NUM * ORB_MULTI_MAX_INSTANCES];
+
+		if (!_compress_buffer || !_compression_state) {
+			PX4_ERR("alloc failed, compression disabled");
+			_compress = false;
+		}
+	}
+
+	if (_index) {
+		_index_entries = new IndexEntry[INDEX_MAX_ENTRIES];
+		_index_topic_state = new IndexTopicState[MAX_TOPICS_NUM * ORB_MULTI_MAX_INSTANCES];
+
+		if (!_index_entries || !_index_topic_state) {
+			PX4_ERR("alloc failed, time index disabled");
+			_index = false;
+		}
+	}
+
 
 	if (!_writer.init()) {
 		PX4_ERR("writer init failed");
@@ -782,7 +1143,6 @@ void Logger::run()
 
 #ifdef DBGPRINT
 	hrt_abstime	timer_start = 0;
-	uint32_t	total_bytes = 0;
 #endif /* DBGPRINT */
 
 	px4_register_shutdown_hook(&Logger::request_stop_static);
@@ -818,6 +1178,22 @@ void Logger::run()
 	hrt_abstime next_subscribe_check = 0;
 	int next_subscribe_topic_index = -1; // this is used to distribute the checks over time
 
+	if (_event_driven) {
+		_update_callbacks = new LoggerUpdateCallback *[MAX_TOPICS_NUM * ORB_MULTI_MAX_INSTANCES];
+
+		if (_update_callbacks) {
+			memset(_update_callbacks, 0, sizeof(LoggerUpdateCallback *) * MAX_TOPICS_NUM * ORB_MULTI_MAX_INSTANCES);
+
+			for (size_t i = 0; i < _subscriptions.size(); ++i) {
+				register_update_callback(i, 0);
+			}
+
+		} else {
+			PX4_ERR("alloc failed, event-driven mode disabled");
+			_event_driven = false;
+		}
+	}
+
 	while (!should_exit()) {
 
 		// Start/stop logging when system arm/disarm
@@ -845,7 +1221,7 @@ void Logger::run()
 
 #ifdef DBGPRINT
 					timer_start = hrt_absolute_time();
-					total_bytes = 0;
+					_total_bytes = 0;
 #endif /* DBGPRINT */
 
 				} else {
@@ -920,48 +1296,86 @@ void Logger::run()
 			/* wait for lock on log buffer */
 			_writer.lock();
 
-			int sub_idx = 0;
+			perf_begin(_tick_perf);
 
-			for (LoggerSubscription &sub : _subscriptions) {
-				/* each message consists of a header followed by an orb data object
-				 */
-				size_t msg_size = sizeof(ulog_message_data_header_s) + sub.metadata->o_size_no_padding;
+			if (_event_driven) {
+				/* only visit the topic instances that were published since the last iteration */
+				for (size_t word = 0; word < UPDATE_MASK_WORDS; ++word) {
+					uint32_t bits = __atomic_exchange_n(&_updated_mask[word], 0, __ATOMIC_ACQUIRE);
 
-				/* if this topic has been updated, copy the new data into the message buffer
-				 * and write a message to the log
-				 */
-				for (uint8_t instance = 0; instance < ORB_MULTI_MAX_INSTANCES; instance++) {
-					if (copy_if_updated_multi(sub, instance, _msg_buffer + sizeof(ulog_message_data_header_s),
-								  sub_idx == next_subscribe_topic_index)) {
+					while (bits != 0) {
+						const int index = word * 32 + __builtin_ctz(bits);
+						bits &= bits - 1;
 
-						uint16_t write_msg_size = static_cast<uint16_t>(msg_size - ULOG_MSG_HEADER_LEN);
-						//write one byte after another (necessary because of alignment)
-						_msg_buffer[0] = (uint8_t)write_msg_size;
-						_msg_buffer[1] = (uint8_t)(write_msg_size >> 8);
-						_msg_buffer[2] = static_cast<uint8_t>(ULogMessageType::DATA);
-						uint16_t write_msg_id = sub.msg_ids[instance];
-						_msg_buffer[3] = (uint8_t)write_msg_id;
-						_msg_buffer[4] = (uint8_t)(write_msg_id >> 8);
+						const int sub_idx = index / ORB_MULTI_MAX_INSTANCES;
+						const int instance = index % ORB_MULTI_MAX_INSTANCES;
+						LoggerSubscription &sub = _subscriptions[sub_idx];
 
-						//PX4_INFO("topic: %s, size = %zu, out_size = %zu", sub.metadata->o_name, sub.metadata->o_size, msg_size);
+						/* the bit is cleared once per wakeup, so drain all the samples queued since then */
+						bool copied = false;
 
-						if (write_message(_msg_buffer, msg_size)) {
+						while (copy_if_updated_multi(sub, instance, _msg_buffer + sizeof(ulog_message_data_header_s), false)) {
+							copied = true;
 
-#ifdef DBGPRINT
-							total_bytes += msg_size;
-#endif /* DBGPRINT */
+							if (write_data_message(sub, instance)) {
+								data_written = true;
+							}
+						}
+
+						if (!copied && sub.rate_limited) {
+							/* the update interval did not expire yet, check again in the next iteration */
+							set_updated(sub_idx, instance);
+						}
+					}
+				}
 
-							data_written = true;
+				/* look for new multi-instances, one topic per iteration */
+				if (next_subscribe_topic_index >= 0 && next_subscribe_topic_index < (int)_subscriptions.size()) {
+					LoggerSubscription &sub = _subscriptions[next_subscribe_topic_index];
 
-						} else {
-							break;	// Write buffer overflow, skip this record
+					for (uint8_t instance = 0; instance < ORB_MULTI_MAX_INSTANCES; instance++) {
+						if (sub.fd[instance] >= 0) {
+							continue;
+						}
+
+						if (copy_if_updated_multi(sub, instance, _msg_buffer + sizeof(ulog_message_data_header_s), true)) {
+							if (write_data_message(sub, instance)) {
+								data_written = true;
+							}
+						}
+
+						if (sub.fd[instance] >= 0) {
+							register_update_callback(next_subscribe_topic_index, instance);
 						}
 					}
 				}
 
-				++sub_idx;
+			} else {
+				int sub_idx = 0;
+
+				for (LoggerSubscription &sub : _subscriptions) {
+					/* if this topic has been updated, copy the new data into the message buffer
+					 * and write a message to the log
+					 */
+					for (uint8_t instance = 0; instance < ORB_MULTI_MAX_INSTANCES; instance++) {
+						if (copy_if_updated_multi(sub, instance, _msg_buffer + sizeof(ulog_message_data_header_s),
+									  sub_idx == next_subscribe_topic_index)) {
+
+							if (write_data_message(sub, instance)) {
+								data_written = true;
+
+							} else {
+								break;	// Write buffer overflow, skip this record
+							}
+						}
+					}
+
+					++sub_idx;
+				}
 			}
 
+			perf_end(_tick_perf);
+
 			//check for new logging message(s)
 			bool log_message_updated = false;
 			ret = orb_check(log_message_sub, &log_message_updated);
@@ -1014,14 +1428,14 @@ void Logger::run()
 
 			if (deltat > 4.0) {
 				alloc_info = mallinfo();
-				double throughput = total_bytes / deltat;
+				double throughput = _total_bytes / deltat;
 				PX4_INFO("%8.1f kB/s, %zu highWater,  %d dropouts, %5.3f sec max, free heap: %d",
 					 throughput / 1.e3, _high_water, _write_dropouts, (double)_max_dropout_duration,
 					 alloc_info.fordblks);
 
 				_high_water = 0;
 				_max_dropout_duration = 0.f;
-				total_bytes = 0;
+				_total_bytes = 0;
 				timer_start = hrt_absolute_time();
 			}
 
@@ -1066,6 +1480,15 @@ void Logger::run()
 	// stop the writer thread
 	_writer.thread_stop();
 
+	if (_update_callbacks) {
+		for (size_t i = 0; i < MAX_TOPICS_NUM * ORB_MULTI_MAX_INSTANCES; ++i) {
+			delete _update_callbacks[i];
+		}
+
+		delete[] _update_callbacks;
+		_update_callbacks = nullptr;
+	}
+
 	//unsubscribe
 	for (LoggerSubscription &sub : _subscriptions) {
 		for (uint8_t instance = 0; instance < ORB_MULTI_MAX_INSTANCES; instance++) {
@@ -1318,10 +1741,19 @@ void Logger::start_log_file()
 	/* print logging path, important to find log file later */
 	mavlink_log_info(&_mavlink_log_pub, "[logger] file: %s", file_name);
 
+	if (_index) {
+		_index_count = 0;
+		_index_interval = INDEX_INITIAL_INTERVAL;
+
+		for (size_t i = 0; i < MAX_TOPICS_NUM * ORB_MULTI_MAX_INSTANCES; ++i) {
+			_index_topic_state[i] = IndexTopicState{};
+		}
+	}
+
 	_writer.start_log_file(file_name);
 	_writer.select_write_backend(LogWriter::BackendFile);
 	_writer.set_need_reliable_transfer(true);
-	write_header();
+	write_header(_compress);
 	write_version();
 	write_formats();
 	write_parameters();
@@ -1336,6 +1768,19 @@ void Logger::start_log_file()
 
 	_start_time_file = hrt_absolute_time();
 
+	if (_compress) {
+		/* every topic starts with a keyframe in the new file */
+		for (size_t i = 0; i < MAX_TOPICS_NUM * ORB_MULTI_MAX_INSTANCES; ++i) {
+			_compression_state[i].valid = false;
+		}
+
+		_compress_raw_bytes = 0;
+		_compress_out_bytes = 0;
+		_compress_time = 0;
+		_compress_count = 0;
+		_compress_file_log = true;
+	}
+
 	initialize_load_output();
 }
 
@@ -1347,8 +1792,14 @@ void Logger::stop_log_file()
 
 	_writer.set_need_reliable_transfer(true);
 	write_perf_data(false);
+
+	if (_index) {
+		write_index();
+	}
+
 	_writer.set_need_reliable_transfer(false);
 	_writer.stop_log_file();
+	_compress_file_log = false;
 }
 
 void Logger::start_log_mavlink()
@@ -1524,8 +1975,13 @@ void Logger::write_add_logged_msg(LoggerSubscription &subscription, int instance
 
 	bool prev_reliable = _writer.need_reliable_transfer();
 	_writer.set_need_reliable_transfer(true);
+	const uint64_t file_position = _writer.get_file_position();
 	write_message(&msg, msg_size);
 	_writer.set_need_reliable_transfer(prev_reliable);
+
+	if (_index && _writer.get_file_position() - file_position >= msg_size) {
+		_index_topic_state[msg.msg_id].add_logged_offset = _writer.get_file_position() - msg_size;
+	}
 }
 
 /* write info message */
@@ -1614,7 +2070,7 @@ void Logger::write_info_template(const char *name, T value, const char *type_str
 	_writer.unlock();
 }
 
-void Logger::write_header()
+void Logger::write_header(bool compressed)
 {
 	ulog_file_header_s header;
 	header.magic[0] = 'U';
@@ -1636,6 +2092,10 @@ void Logger::write_header()
 	flag_bits.msg_size = sizeof(flag_bits) - ULOG_MSG_HEADER_LEN;
 	flag_bits.msg_type = static_cast<uint8_t>(ULogMessageType::FLAG_BITS);
 
+	if (compressed) {
+		flag_bits.incompat_flags[0] |= ULOG_INCOMPAT_FLAG0_DATA_COMPRESSED_MASK;
+	}
+
 	write_message(&flag_bits, sizeof(flag_bits));
 
 	_writer.unlock();
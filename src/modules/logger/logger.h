@@ -70,6 +70,7 @@ struct LoggerSubscription {
 	int fd[ORB_MULTI_MAX_INSTANCES];
 	uint16_t msg_ids[ORB_MULTI_MAX_INSTANCES];
 	const orb_metadata *metadata = nullptr;
+	bool rate_limited = false; ///< an update interval is set, so an update might not be collectable right away
 
 	LoggerSubscription() {}
 
@@ -88,11 +89,35 @@ struct LoggerSubscription {
 	}
 };
 
+/**
+ * @class LoggerUpdateCallback
+ * Sets a bit in the logger's update mask whenever a logged topic instance is published
+ */
+class LoggerUpdateCallback : public uORB::SubscriptionCallback
+{
+public:
+	LoggerUpdateCallback(const orb_metadata *meta, unsigned instance, uint32_t *mask_word, uint32_t mask_bit) :
+		uORB::SubscriptionCallback(meta, instance),
+		_mask_word(mask_word),
+		_mask_bit(mask_bit)
+	{}
+
+	void call() override
+	{
+		__atomic_fetch_or(_mask_word, _mask_bit, __ATOMIC_RELEASE);
+	}
+
+private:
+	uint32_t *_mask_word;
+	const uint32_t _mask_bit;
+};
+
 class Logger : public ModuleBase<Logger>
 {
 public:
 	Logger(LogWriter::Backend backend, size_t buffer_size, uint32_t log_interval, const char *poll_topic_name,
-	       bool log_on_start, bool log_until_shutdown, bool log_name_timestamp, unsigned int queue_size);
+	       bool log_on_start, bool log_until_shutdown, bool log_name_timestamp, unsigned int queue_size, bool direct_io,
+	       bool event_driven, bool compress, bool index);
 
 	~Logger();
 
@@ -205,7 +230,10 @@ private:
 	/**
 	 * write the file header with file magic and timestamp.
 	 */
-	void write_header();
+	/**
+	 * @param compressed set the flag for encoded data messages
+	 */
+	void write_header(bool compressed = false);
 
 	void write_formats();
 
@@ -242,6 +270,54 @@ private:
 
 	inline bool copy_if_updated_multi(LoggerSubscription &sub, int multi_instance, void *buffer, bool try_to_subscribe);
 
+	/**
+	 * Write the topic data in _msg_buffer (filled by copy_if_updated_multi()) as a ulog data message.
+	 * Must be called with _writer.lock() held.
+	 * @return true if data written, false otherwise (on overflow)
+	 */
+	bool write_data_message(const LoggerSubscription &sub, int multi_instance);
+
+	/**
+	 * Write the topic data in _msg_buffer encoded (@see ulog_compression.h) to the file backend.
+	 * Must be called with _writer.lock() held.
+	 * @return true if data written, false otherwise (on overflow)
+	 */
+	bool write_compressed_data_message(const LoggerSubscription &sub, int multi_instance);
+
+	/**
+	 * check if the time index wants an entry for a msg_id
+	 * @param timestamp timestamp of the topic data
+	 */
+	bool index_entry_due(uint16_t msg_id, uint64_t timestamp) const;
+
+	/**
+	 * add a data message to the time index, if it is due and the message went to the file.
+	 * Must be called with _writer.lock() held, right after writing the message.
+	 * @param file_position file position before writing the message
+	 * @param msg_size size of the written message
+	 */
+	void add_index_entry(uint16_t msg_id, uint64_t timestamp, uint64_t file_position, size_t msg_size);
+
+	/**
+	 * append the time index to the log file (@see ulog_message_index_header_s)
+	 */
+	void write_index();
+
+	/**
+	 * Event-driven mode: get notified about publications of a subscribed topic instance
+	 * @param sub_idx index into _subscriptions
+	 */
+	void register_update_callback(int sub_idx, int multi_instance);
+
+	/**
+	 * Event-driven mode: mark a topic instance to be visited in the next iteration
+	 */
+	void set_updated(int sub_idx, int multi_instance)
+	{
+		const int index = sub_idx * ORB_MULTI_MAX_INSTANCES + multi_instance;
+		__atomic_fetch_or(&_updated_mask[index / 32], 1u << (index % 32), __ATOMIC_RELAXED);
+	}
+
 	/**
 	 * Write exactly one ulog message to the logger and handle dropouts.
 	 * Must be called with _writer.lock() held.
@@ -283,6 +359,7 @@ private:
 
 
 	static constexpr size_t 	MAX_TOPICS_NUM = 64; /**< Maximum number of logged topics */
+	static constexpr size_t		UPDATE_MASK_WORDS = (MAX_TOPICS_NUM * ORB_MULTI_MAX_INSTANCES + 31) / 32;
 	static constexpr unsigned	MAX_NO_LOGFILE = 999;	/**< Maximum number of log files */
 #if defined(__PX4_POSIX_EAGLE) || defined(__PX4_POSIX_EXCELSIOR)
 	static constexpr const char	*LOG_ROOT = PX4_ROOTFSDIR"/log";
@@ -306,6 +383,8 @@ private:
 	float						_max_dropout_duration = 0.f; ///< max duration of dropout [s]
 	size_t						_write_dropouts = 0; ///< failed buffer writes due to buffer overflow
 	size_t						_high_water = 0; ///< maximum used write buffer
+	size_t						_lost_queued_samples = 0; ///< samples of queued topics overwritten before they were logged
+	uint32_t					_total_bytes = 0; ///< bytes written since the last throughput output (DBGPRINT)
 
 	const bool 					_log_on_start;
 	const bool 					_log_until_shutdown;
@@ -314,6 +393,56 @@ private:
 	LogWriter					_writer;
 	uint32_t					_log_interval;
 	const orb_metadata				*_polling_topic_meta = nullptr; ///< if non-null, poll on this topic instead of sleeping
+	bool						_event_driven; ///< only visit topic instances that signalled an update
+	uint32_t					_updated_mask[UPDATE_MASK_WORDS] = {}; ///< bit per topic instance, set on publication
+	LoggerUpdateCallback				**_update_callbacks = nullptr; ///< per topic instance (event-driven mode only)
+	perf_counter_t					_tick_perf; ///< time spent copying & writing topic data per iteration
+
+	/** per msg_id state of the data encoder */
+	struct CompressionState {
+		uint8_t *prev = nullptr; ///< last written sample (allocated on first use)
+		uint16_t samples_since_keyframe = 0;
+		bool valid = false; ///< prev holds a sample of the current log file
+	};
+
+	static constexpr uint16_t			COMPRESSION_KEYFRAME_INTERVAL = 100; ///< write a keyframe every N samples per topic
+
+	bool						_compress; ///< encode data messages of file logs
+	bool						_compress_file_log = false; ///< the current file log is encoded
+	CompressionState				*_compression_state = nullptr; ///< indexed by msg_id
+	uint8_t						*_compress_buffer = nullptr; ///< encoded data message
+	uint64_t					_compress_raw_bytes = 0; ///< data message bytes before encoding
+	uint64_t					_compress_out_bytes = 0; ///< data message bytes after encoding
+	uint64_t					_compress_time = 0; ///< total time spent encoding [us]
+	uint32_t					_compress_count = 0; ///< number of encoded messages
+	perf_counter_t					_compress_perf;
+
+	struct IndexEntry {
+		uint64_t timestamp;
+		uint64_t offset;
+		uint16_t msg_id;
+	};
+
+	/** per msg_id state of the time index */
+	struct IndexTopicState {
+		uint64_t add_logged_offset = 0; ///< 0 if the ADD_LOGGED_MSG message was not written to the file
+		uint64_t last_timestamp = 0; ///< timestamp of the last entry
+		bool has_entry = false;
+	};
+
+#ifdef __PX4_NUTTX
+	static constexpr int				INDEX_MAX_ENTRIES = 512;
+#else
+	static constexpr int				INDEX_MAX_ENTRIES = 8192;
+#endif
+	static constexpr uint32_t			INDEX_INITIAL_INTERVAL = 100000; ///< [us] per msg_id, doubled when the index is full
+
+	bool						_index; ///< append a time index to log files
+	IndexEntry					*_index_entries = nullptr;
+	IndexTopicState					*_index_topic_state = nullptr; ///< indexed by msg_id
+	int						_index_count = 0;
+	uint32_t					_index_interval = INDEX_INITIAL_INTERVAL;
+
 	param_t						_log_utc_offset;
 	param_t						_log_dirs_max;
 	orb_advert_t					_mavlink_log_pub = nullptr;
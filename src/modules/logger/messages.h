@@ -45,6 +45,8 @@ enum class ULogMessageType : uint8_t {
 	DROPOUT = 'O',
 	LOGGING = 'L',
 	FLAG_BITS = 'B',
+	INDEX = 'X',
+	INDEX_FOOTER = 'Z',
 };
 
 
@@ -143,6 +145,35 @@ struct ulog_message_parameter_header_s {
 
 
 #define ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK (1<<0)
+#define ULOG_INCOMPAT_FLAG0_DATA_COMPRESSED_MASK (1<<1) ///< data messages are encoded, @see ulog_compression.h
+
+/** entry of the time index: a data message of a msg_id that can be decoded on its own */
+struct ulog_index_entry_s {
+	uint64_t timestamp; ///< timestamp of the topic data
+	uint64_t offset; ///< file offset of the data message
+};
+
+/**
+ * The time index is appended to the end of a log file (before any appended data): a sequence of INDEX
+ * messages (one or more per msg_id, each followed by ulog_index_entry_s entries sorted by timestamp),
+ * and an INDEX_FOOTER message as the very last message.
+ */
+struct ulog_message_index_header_s {
+	uint16_t msg_size; //size of message - ULOG_MSG_HEADER_LEN
+	uint8_t msg_type = static_cast<uint8_t>(ULogMessageType::INDEX);
+
+	uint16_t msg_id;
+	uint64_t add_logged_offset; ///< file offset of the ADD_LOGGED_MSG message for msg_id
+};
+
+#define ULOG_INDEX_FOOTER_MAGIC "ULogIdx"
+struct ulog_message_index_footer_s {
+	uint16_t msg_size = sizeof(ulog_message_index_footer_s) - ULOG_MSG_HEADER_LEN;
+	uint8_t msg_type = static_cast<uint8_t>(ULogMessageType::INDEX_FOOTER);
+
+	uint64_t index_offset; ///< file offset of the first INDEX message
+	char magic[8]; ///< ULOG_INDEX_FOOTER_MAGIC
+};
 
 struct ulog_message_flag_bits_s {
 	uint16_t msg_size;
@@ -0,0 +1,180 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file ulog_compression.h
+ * Encoding of ULog data messages, used if ULOG_INCOMPAT_FLAG0_DATA_COMPRESSED_MASK is set.
+ *
+ * Each data message is encoded on its own, so that a reader can still find and decode the messages
+ * of a single topic without touching the others. The payload after the msg_id starts with a
+ * ULogDataEncoding byte:
+ * - RAW: the topic data as in an uncompressed log
+ * - KEYFRAME: the topic data, zero-run encoded
+ * - DELTA: the XOR of the topic data with the previous sample of the same msg_id, zero-run encoded.
+ *   Fields that did not change become zero, so slowly changing topics shrink to a few bytes.
+ *
+ * Zero-run encoding is a sequence of tokens, each starting with a control byte c:
+ * - c & 0x80: (c & 0x7f) + 1 zero bytes
+ * - otherwise: c + 1 literal bytes follow
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace px4
+{
+namespace logger
+{
+
+enum class ULogDataEncoding : uint8_t {
+	RAW = 0,
+	KEYFRAME = 1,
+	DELTA = 2,
+};
+
+static constexpr int ULOG_COMPRESSION_MAX_RUN = 128;
+
+/**
+ * Zero-run encode data, optionally XOR'ed with a previous sample.
+ * @param data topic data
+ * @param prev previous sample of the same size, or nullptr for a keyframe
+ * @param size size of data in bytes
+ * @param out output buffer
+ * @param out_size size of the output buffer
+ * @return number of bytes written to out, 0 if it did not fit (store the data raw then)
+ */
+static inline size_t ulog_encode(const uint8_t *data, const uint8_t *prev, size_t size, uint8_t *out, size_t out_size)
+{
+	size_t in = 0;
+	size_t pos = 0;
+
+	while (in < size) {
+		/* count the zero run at the current position */
+		size_t run = 0;
+
+		while (in + run < size && run < ULOG_COMPRESSION_MAX_RUN &&
+		       (data[in + run] ^ (prev ? prev[in + run] : 0)) == 0) {
+			++run;
+		}
+
+		if (run > 0) {
+			if (pos + 1 > out_size) {
+				return 0;
+			}
+
+			out[pos++] = 0x80 | (uint8_t)(run - 1);
+			in += run;
+			continue;
+		}
+
+		/* literal run: until the next pair of zeros (a single zero is cheaper to keep as literal) */
+		size_t literal = 0;
+
+		while (in + literal < size && literal < ULOG_COMPRESSION_MAX_RUN) {
+			const bool zero = (data[in + literal] ^ (prev ? prev[in + literal] : 0)) == 0;
+			const bool next_zero = in + literal + 1 >= size ||
+					       (data[in + literal + 1] ^ (prev ? prev[in + literal + 1] : 0)) == 0;
+
+			if (zero && next_zero) {
+				break;
+			}
+
+			++literal;
+		}
+
+		if (pos + 1 + literal > out_size) {
+			return 0;
+		}
+
+		out[pos++] = (uint8_t)(literal - 1);
+
+		for (size_t i = 0; i < literal; ++i) {
+			out[pos++] = data[in + i] ^ (prev ? prev[in + i] : 0);
+		}
+
+		in += literal;
+	}
+
+	return pos;
+}
+
+/**
+ * Decode data encoded with ulog_encode().
+ * @param in encoded data
+ * @param in_size size of the encoded data
+ * @param data for a delta: the previous sample on input. Decoded topic data on output.
+ * @param size size of data in bytes
+ * @param delta true if in was encoded against the previous sample
+ * @return true if the encoded data decoded to exactly size bytes
+ */
+static inline bool ulog_decode(const uint8_t *in, size_t in_size, uint8_t *data, size_t size, bool delta)
+{
+	size_t pos = 0;
+	size_t out = 0;
+
+	while (pos < in_size) {
+		const uint8_t c = in[pos++];
+		const size_t run = (c & 0x7f) + 1;
+
+		if (out + run > size) {
+			return false;
+		}
+
+		if (c & 0x80) {
+			if (!delta) {
+				memset(data + out, 0, run);
+			}
+
+		} else {
+			if (pos + run > in_size) {
+				return false;
+			}
+
+			for (size_t i = 0; i < run; ++i) {
+				data[out + i] = delta ? (data[out + i] ^ in[pos + i]) : in[pos + i];
+			}
+
+			pos += run;
+		}
+
+		out += run;
+	}
+
+	return out == size;
+}
+
+} //namespace logger
+} //namespace px4
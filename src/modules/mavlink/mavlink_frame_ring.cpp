@@ -0,0 +1,130 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file mavlink_frame_ring.cpp
+ * Lock-free ring of encoded MAVLink frames.
+ */
+
+#include "mavlink_frame_ring.h"
+
+#include <string.h>
+
+static constexpr unsigned FRAME_HEADER_LEN = 2;
+
+MavlinkFrameRing::MavlinkFrameRing(unsigned size) :
+	_data(new uint8_t[size]),
+	_mask(size - 1),
+	_head(0),
+	_tail(0)
+{
+}
+
+MavlinkFrameRing::~MavlinkFrameRing()
+{
+	delete[] _data;
+}
+
+void
+MavlinkFrameRing::copy_in(unsigned pos, const uint8_t *src, unsigned len)
+{
+	const unsigned offset = pos & _mask;
+	const unsigned first = (len < _mask + 1 - offset) ? len : _mask + 1 - offset;
+
+	memcpy(&_data[offset], src, first);
+	memcpy(_data, src + first, len - first);
+}
+
+void
+MavlinkFrameRing::copy_out(unsigned pos, uint8_t *dst, unsigned len) const
+{
+	const unsigned offset = pos & _mask;
+	const unsigned first = (len < _mask + 1 - offset) ? len : _mask + 1 - offset;
+
+	memcpy(dst, &_data[offset], first);
+	memcpy(dst + first, _data, len - first);
+}
+
+bool
+MavlinkFrameRing::push(const uint8_t *frame, unsigned len)
+{
+	const unsigned head = _head;
+	const unsigned tail = __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+
+	if (len == 0 || len > 0xffff || (_mask + 1) - (head - tail) < FRAME_HEADER_LEN + len) {
+		return false;
+	}
+
+	const uint8_t header[FRAME_HEADER_LEN] = {(uint8_t)(len & 0xff), (uint8_t)(len >> 8)};
+	copy_in(head, header, FRAME_HEADER_LEN);
+	copy_in(head + FRAME_HEADER_LEN, frame, len);
+
+	/* publish the frame only after its bytes are in place */
+	__atomic_store_n(&_head, head + FRAME_HEADER_LEN + len, __ATOMIC_RELEASE);
+	return true;
+}
+
+unsigned
+MavlinkFrameRing::front_size()
+{
+	const unsigned tail = _tail;
+
+	if (__atomic_load_n(&_head, __ATOMIC_ACQUIRE) == tail) {
+		return 0;
+	}
+
+	uint8_t header[FRAME_HEADER_LEN];
+	copy_out(tail, header, FRAME_HEADER_LEN);
+	return header[0] | (header[1] << 8);
+}
+
+unsigned
+MavlinkFrameRing::pop(uint8_t *frame, unsigned max_len)
+{
+	const unsigned len = front_size();
+
+	if (len == 0) {
+		return 0;
+	}
+
+	const unsigned tail = _tail;
+
+	if (len <= max_len) {
+		copy_out(tail + FRAME_HEADER_LEN, frame, len);
+	}
+
+	/* hand the space back to the producer only after the frame was copied out */
+	__atomic_store_n(&_tail, tail + FRAME_HEADER_LEN + len, __ATOMIC_RELEASE);
+	return (len <= max_len) ? len : 0;
+}
@@ -0,0 +1,104 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file mavlink_frame_ring.h
+ * Lock-free ring of encoded MAVLink frames, used to forward messages between instances.
+ */
+
+#ifndef MAVLINK_FRAME_RING_H_
+#define MAVLINK_FRAME_RING_H_
+
+#include <stdint.h>
+
+/**
+ * Single producer, single consumer ring of variable length frames.
+ *
+ * Each frame is stored as a 16 bit length followed by the raw bytes. The producer only writes the
+ * head index and the consumer only writes the tail index, so push() and pop() can run concurrently
+ * on two threads without a lock. Indices run freely and are wrapped with a mask, which requires the
+ * size to be a power of two.
+ */
+class MavlinkFrameRing
+{
+public:
+	/**
+	 * @param size capacity in bytes, must be a power of two
+	 */
+	MavlinkFrameRing(unsigned size);
+	~MavlinkFrameRing();
+
+	/**
+	 * @return false if the memory allocation failed
+	 */
+	bool valid() const { return _data != nullptr; }
+
+	/**
+	 * Append a frame. Only call from the producer thread.
+	 *
+	 * @return false if there is not enough space (the frame is dropped)
+	 */
+	bool push(const uint8_t *frame, unsigned len);
+
+	/**
+	 * Length of the oldest frame. Only call from the consumer thread.
+	 *
+	 * @return frame length, 0 if the ring is empty
+	 */
+	unsigned front_size();
+
+	/**
+	 * Remove the oldest frame. Only call from the consumer thread.
+	 *
+	 * @param frame buffer for the frame
+	 * @param max_len size of the buffer, a longer frame is discarded
+	 * @return frame length, 0 if the ring is empty
+	 */
+	unsigned pop(uint8_t *frame, unsigned max_len);
+
+private:
+	void copy_in(unsigned pos, const uint8_t *src, unsigned len);
+	void copy_out(unsigned pos, uint8_t *dst, unsigned len) const;
+
+	uint8_t *_data;
+	const unsigned _mask;
+	unsigned _head; ///< next write position, written by the producer
+	unsigned _tail; ///< next read position, written by the consumer
+
+	/* do not allow copying this class */
+	MavlinkFrameRing(const MavlinkFrameRing &);
+	MavlinkFrameRing operator=(const MavlinkFrameRing &);
+};
+
+#endif /* MAVLINK_FRAME_RING_H_ */
@@ -53,6 +53,7 @@ constexpr const char MavlinkFTP::_root_dir[];
 
 MavlinkFTP::MavlinkFTP(Mavlink *mavlink) :
 	_session_info{},
+	_stream_next_session(0),
 	_utRcvMsgFunc{},
 	_worker_data{},
 	_mavlink(mavlink),
@@ -60,12 +61,18 @@ MavlinkFTP::MavlinkFTP(Mavlink *mavlink) :
 	_work_buffer2{nullptr},
 	_last_work_buffer_access{0}
 {
-	// initialize session
-	_session_info.fd = -1;
+	// initialize sessions
+	for (unsigned i = 0; i < kMaxSessions; i++) {
+		_session_info[i].fd = -1;
+	}
 }
 
 MavlinkFTP::~MavlinkFTP()
 {
+	for (unsigned i = 0; i < kMaxSessions; i++) {
+		_close_session(_session_info[i]);
+	}
+
 	if (_work_buffer1) {
 		delete[] _work_buffer1;
 	}
@@ -79,12 +86,54 @@ MavlinkFTP::~MavlinkFTP()
 unsigned
 MavlinkFTP::get_size()
 {
-	if (_session_info.stream_download) {
-		return MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+	for (unsigned i = 0; i < kMaxSessions; i++) {
+		if (_stream_ready(_session_info[i])) {
+			return MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL_LEN + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+		}
+	}
 
-	} else {
-		return 0;
+	return 0;
+}
+
+MavlinkFTP::SessionInfo *
+MavlinkFTP::_get_session(const PayloadHeader *payload)
+{
+	if (payload->session >= kMaxSessions || _session_info[payload->session].fd < 0) {
+		return nullptr;
+	}
+
+	return &_session_info[payload->session];
+}
+
+void
+MavlinkFTP::_close_session(SessionInfo &session)
+{
+	if (session.fd >= 0) {
+		::close(session.fd);
+		session.fd = -1;
+	}
+
+	session.stream_download = false;
+
+	delete[] session.read_ahead;
+	session.read_ahead = nullptr;
+	session.read_ahead_len = 0;
+}
+
+bool
+MavlinkFTP::_stream_ready(const SessionInfo &session) const
+{
+	if (!session.stream_download) {
+		return false;
 	}
+
+	if (!session.stream_windowed || session.resend_count > 0) {
+		return true;
+	}
+
+	// keep going until the window is full (the EOF Nak is always sent)
+	return session.stream_offset >= session.file_size
+	       || session.stream_offset - session.stream_acked_offset < session.stream_window;
 }
 
 #ifdef MAVLINK_FTP_UNIT_TEST
@@ -211,7 +260,17 @@ MavlinkFTP::_process_request(mavlink_file_transfer_protocol_t *ftp_req, uint8_t
 		break;
 
 	case kCmdBurstReadFile:
-		errorCode = _workBurst(payload, target_system_id);
+		errorCode = _workBurst(payload, target_system_id, false);
+		stream_send = true;
+		break;
+
+	case kCmdBurstReadWindowed:
+		errorCode = _workBurst(payload, target_system_id, true);
+		stream_send = true;
+		break;
+
+	case kCmdBurstAck:
+		errorCode = _workBurstAck(payload);
 		stream_send = true;
 		break;
 
@@ -478,7 +537,13 @@ MavlinkFTP::_workList(PayloadHeader *payload, bool list_hidden)
 MavlinkFTP::ErrorCode
 MavlinkFTP::_workOpen(PayloadHeader *payload, int oflag)
 {
-	if (_session_info.fd >= 0) {
+	unsigned session_id = 0;
+
+	while (session_id < kMaxSessions && _session_info[session_id].fd >= 0) {
+		session_id++;
+	}
+
+	if (session_id >= kMaxSessions) {
 		warnx("FTP: Open failed - out of sessions\n");
 		return kErrNoSessionsAvailable;
 	}
@@ -512,11 +577,13 @@ MavlinkFTP::_workOpen(PayloadHeader *payload, int oflag)
 		return kErrFailErrno;
 	}
 
-	_session_info.fd = fd;
-	_session_info.file_size = fileSize;
-	_session_info.stream_download = false;
+	SessionInfo &session = _session_info[session_id];
+	session.fd = fd;
+	session.file_size = fileSize;
+	session.stream_download = false;
+	session.read_ahead_len = 0;
 
-	payload->session = 0;
+	payload->session = session_id;
 	payload->size = sizeof(uint32_t);
 	std::memcpy(payload->data, &fileSize, payload->size);
 
@@ -527,7 +594,9 @@ MavlinkFTP::_workOpen(PayloadHeader *payload, int oflag)
 MavlinkFTP::ErrorCode
 MavlinkFTP::_workRead(PayloadHeader *payload)
 {
-	if (payload->session != 0 || _session_info.fd < 0) {
+	SessionInfo *session = _get_session(payload);
+
+	if (session == nullptr) {
 		return kErrInvalidSession;
 	}
 
@@ -536,17 +605,17 @@ MavlinkFTP::_workRead(PayloadHeader *payload)
 #endif
 
 	// We have to test seek past EOF ourselves, lseek will allow seek past EOF
-	if (payload->offset >= _session_info.file_size) {
+	if (payload->offset >= session->file_size) {
 		warnx("request past EOF");
 		return kErrEOF;
 	}
 
-	if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
+	if (lseek(session->fd, payload->offset, SEEK_SET) < 0) {
 		warnx("seek fail");
 		return kErrFailErrno;
 	}
 
-	int bytes_read = ::read(_session_info.fd, &payload->data[0], kMaxDataLength);
+	int bytes_read = ::read(session->fd, &payload->data[0], kMaxDataLength);
 
 	if (bytes_read < 0) {
 		// Negative return indicates error other than eof
@@ -561,21 +630,87 @@ MavlinkFTP::_workRead(PayloadHeader *payload)
 
 /// @brief Responds to a Stream command
 MavlinkFTP::ErrorCode
-MavlinkFTP::_workBurst(PayloadHeader *payload, uint8_t target_system_id)
+MavlinkFTP::_workBurst(PayloadHeader *payload, uint8_t target_system_id, bool windowed)
 {
-	if (payload->session != 0 && _session_info.fd < 0) {
+	SessionInfo *session = _get_session(payload);
+
+	if (session == nullptr) {
 		return kErrInvalidSession;
 	}
 
+	uint32_t window = 0;
+
+	if (windowed) {
+		if (payload->size != sizeof(uint32_t)) {
+			return kErrInvalidDataSize;
+		}
+
+		std::memcpy(&window, payload->data, sizeof(window));
+
+		// at least one packet has to fit
+		if (window < kMaxDataLength) {
+			window = kMaxDataLength;
+		}
+	}
+
 #ifdef MAVLINK_FTP_DEBUG
-	warnx("FTP: burst offset:%d", payload->offset);
+	warnx("FTP: burst offset:%d window:%d", payload->offset, window);
 #endif
+
+	// the read-ahead buffer is optional, without it every packet is read from the file
+	if (session->read_ahead == nullptr) {
+		session->read_ahead = new uint8_t[kReadAheadLen];
+		session->read_ahead_len = 0;
+	}
+
 	// Setup for streaming sends
-	_session_info.stream_download = true;
-	_session_info.stream_offset = payload->offset;
-	_session_info.stream_chunk_transmitted = 0;
-	_session_info.stream_seq_number = payload->seq_number + 1;
-	_session_info.stream_target_system_id = target_system_id;
+	session->stream_download = true;
+	session->stream_windowed = windowed;
+	session->stream_offset = payload->offset;
+	session->stream_acked_offset = payload->offset;
+	session->stream_window = window;
+	session->resend_count = 0;
+	session->stream_chunk_transmitted = 0;
+	session->stream_seq_number = payload->seq_number + 1;
+	session->stream_target_system_id = target_system_id;
+
+	return kErrNone;
+}
+
+/// @brief Responds to a BurstAck command: slides the window of a windowed stream and queues resends
+MavlinkFTP::ErrorCode
+MavlinkFTP::_workBurstAck(PayloadHeader *payload)
+{
+	SessionInfo *session = _get_session(payload);
+
+	if (session == nullptr || !session->stream_windowed) {
+		return kErrInvalidSession;
+	}
+
+	if (payload->size % sizeof(uint32_t) != 0) {
+		return kErrInvalidDataSize;
+	}
+
+	// the acknowledged offset only moves forward and never beyond what was sent
+	if (payload->offset > session->stream_acked_offset && payload->offset <= session->stream_offset) {
+		session->stream_acked_offset = payload->offset;
+	}
+
+	// a new ack replaces the previous resend list: the client reports everything that is still missing
+	session->resend_count = 0;
+
+	for (unsigned i = 0; i < payload->size / sizeof(uint32_t) && i < kMaxResend; i++) {
+		uint32_t offset;
+		std::memcpy(&offset, &payload->data[i * sizeof(uint32_t)], sizeof(offset));
+
+		if (offset < session->stream_offset && offset < session->file_size) {
+			session->resend_offsets[session->resend_count++] = offset;
+		}
+	}
+
+	// resume after the EOF Nak if the client is missing data, stream packets continue the sequence of this request
+	session->stream_download = true;
+	session->stream_seq_number = payload->seq_number + 1;
 
 	return kErrNone;
 }
@@ -584,17 +719,19 @@ MavlinkFTP::_workBurst(PayloadHeader *payload, uint8_t target_system_id)
 MavlinkFTP::ErrorCode
 MavlinkFTP::_workWrite(PayloadHeader *payload)
 {
-	if (payload->session != 0 && _session_info.fd < 0) {
+	SessionInfo *session = _get_session(payload);
+
+	if (session == nullptr) {
 		return kErrInvalidSession;
 	}
 
-	if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
+	if (lseek(session->fd, payload->offset, SEEK_SET) < 0) {
 		// Unable to see to the specified location
 		warnx("seek fail");
 		return kErrFailErrno;
 	}
 
-	int bytes_written = ::write(_session_info.fd, &payload->data[0], payload->size);
+	int bytes_written = ::write(session->fd, &payload->data[0], payload->size);
 
 	if (bytes_written < 0) {
 		// Negative return indicates error other than eof
@@ -724,13 +861,13 @@ MavlinkFTP::_workTruncateFile(PayloadHeader *payload)
 MavlinkFTP::ErrorCode
 MavlinkFTP::_workTerminate(PayloadHeader *payload)
 {
-	if (payload->session != 0 || _session_info.fd < 0) {
+	SessionInfo *session = _get_session(payload);
+
+	if (session == nullptr) {
 		return kErrInvalidSession;
 	}
 
-	::close(_session_info.fd);
-	_session_info.fd = -1;
-	_session_info.stream_download = false;
+	_close_session(*session);
 
 	payload->size = 0;
 
@@ -741,10 +878,8 @@ MavlinkFTP::_workTerminate(PayloadHeader *payload)
 MavlinkFTP::ErrorCode
 MavlinkFTP::_workReset(PayloadHeader *payload)
 {
-	if (_session_info.fd != -1) {
-		::close(_session_info.fd);
-		_session_info.fd = -1;
-		_session_info.stream_download = false;
+	for (unsigned i = 0; i < kMaxSessions; i++) {
+		_close_session(_session_info[i]);
 	}
 
 	payload->size = 0;
@@ -952,7 +1087,7 @@ void MavlinkFTP::send(const hrt_abstime t)
 	}
 
 	// Anything to stream?
-	if (!_session_info.stream_download) {
+	if (get_size() == 0) {
 		return;
 	}
 
@@ -969,31 +1104,57 @@ void MavlinkFTP::send(const hrt_abstime t)
 
 #endif
 
-	// Send stream packets until buffer is full
+	// Send stream packets until buffer is full, the streaming sessions take turns
 
 	bool more_data;
 
 	do {
 		more_data = false;
 
+		unsigned session_id = _stream_next_session;
+		unsigned tried = 0;
+
+		while (tried < kMaxSessions && !_stream_ready(_session_info[session_id])) {
+			session_id = (session_id + 1) % kMaxSessions;
+			tried++;
+		}
+
+		if (tried >= kMaxSessions) {
+			break;
+		}
+
+		_stream_next_session = (session_id + 1) % kMaxSessions;
+		SessionInfo &session = _session_info[session_id];
+
 		ErrorCode error_code = kErrNone;
 
 		mavlink_file_transfer_protocol_t ftp_msg;
 		PayloadHeader *payload = reinterpret_cast<PayloadHeader *>(&ftp_msg.payload[0]);
 
-		payload->seq_number = _session_info.stream_seq_number;
-		payload->session = 0;
+		payload->seq_number = session.stream_seq_number;
+		payload->session = session_id;
 		payload->opcode = kRspAck;
-		payload->req_opcode = kCmdBurstReadFile;
-		payload->offset = _session_info.stream_offset;
-		_session_info.stream_seq_number++;
+		payload->req_opcode = session.stream_windowed ? kCmdBurstReadWindowed : kCmdBurstReadFile;
+		payload->burst_complete = false;
+		payload->padding = 0;
+		session.stream_seq_number++;
+
+		// a windowed stream first resends what the client reported missing
+		const bool resend = session.stream_windowed && session.resend_count > 0;
+
+		if (resend) {
+			payload->offset = session.resend_offsets[--session.resend_count];
+
+		} else {
+			payload->offset = session.stream_offset;
+		}
 
 #ifdef MAVLINK_FTP_DEBUG
-		warnx("stream send: offset %d", _session_info.stream_offset);
+		warnx("stream send: session %d offset %d", session_id, payload->offset);
 #endif
 
 		// We have to test seek past EOF ourselves, lseek will allow seek past EOF
-		if (_session_info.stream_offset >= _session_info.file_size) {
+		if (payload->offset >= session.file_size) {
 			error_code = kErrEOF;
 #ifdef MAVLINK_FTP_DEBUG
 			warnx("stream download: sending Nak EOF");
@@ -1001,16 +1162,7 @@ void MavlinkFTP::send(const hrt_abstime t)
 		}
 
 		if (error_code == kErrNone) {
-			if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
-				error_code = kErrFailErrno;
-#ifdef MAVLINK_FTP_DEBUG
-				warnx("stream download: seek fail");
-#endif
-			}
-		}
-
-		if (error_code == kErrNone) {
-			int bytes_read = ::read(_session_info.fd, &payload->data[0], kMaxDataLength);
+			int bytes_read = _stream_read(session, payload->offset, &payload->data[0]);
 
 			if (bytes_read < 0) {
 				// Negative return indicates error other than eof
@@ -1019,10 +1171,17 @@ void MavlinkFTP::send(const hrt_abstime t)
 				warnx("stream download: read fail");
 #endif
 
+			} else if (bytes_read == 0) {
+				// the file got shorter since it was opened
+				error_code = kErrEOF;
+
 			} else {
 				payload->size = bytes_read;
-				_session_info.stream_offset += bytes_read;
-				_session_info.stream_chunk_transmitted += bytes_read;
+
+				if (!resend) {
+					session.stream_offset += bytes_read;
+					session.stream_chunk_transmitted += bytes_read;
+				}
 			}
 		}
 
@@ -1038,7 +1197,8 @@ void MavlinkFTP::send(const hrt_abstime t)
 				payload->data[1] = r_errno;
 			}
 
-			_session_info.stream_download = false;
+			// a windowed stream stays open for resend requests until the session is terminated
+			session.stream_download = false;
 
 		} else {
 #ifndef MAVLINK_FTP_UNIT_TEST
@@ -1046,17 +1206,17 @@ void MavlinkFTP::send(const hrt_abstime t)
 			if (max_bytes_to_send < (get_size() * 2)) {
 				more_data = false;
 
-				/* perform transfers in 35K chunks - this is determined empirical */
-				if (_session_info.stream_chunk_transmitted > 35000) {
+				/* perform transfers in 35K chunks - this is determined empirical.
+				 * A windowed stream is paced by the acks of the client instead. */
+				if (!session.stream_windowed && session.stream_chunk_transmitted > 35000) {
 					payload->burst_complete = true;
-					_session_info.stream_download = false;
-					_session_info.stream_chunk_transmitted = 0;
+					session.stream_download = false;
+					session.stream_chunk_transmitted = 0;
 				}
 
 			} else {
 #endif
 				more_data = true;
-				payload->burst_complete = false;
 #ifndef MAVLINK_FTP_UNIT_TEST
 				max_bytes_to_send -= get_size();
 			}
@@ -1064,7 +1224,55 @@ void MavlinkFTP::send(const hrt_abstime t)
 #endif
 		}
 
-		ftp_msg.target_system = _session_info.stream_target_system_id;
+		ftp_msg.target_system = session.stream_target_system_id;
 		_reply(&ftp_msg);
 	} while (more_data);
 }
+
+int
+MavlinkFTP::_stream_read(SessionInfo &session, uint32_t offset, uint8_t *data)
+{
+	const uint32_t buffer_end = session.read_ahead_offset + session.read_ahead_len;
+
+	// the buffered data has to cover a full packet, unless the buffer already ends at EOF
+	bool buffered = session.read_ahead != nullptr && session.read_ahead_len > 0
+			&& offset >= session.read_ahead_offset && offset < buffer_end
+			&& (offset + kMaxDataLength <= buffer_end || buffer_end >= session.file_size);
+
+	if (!buffered) {
+		if (lseek(session.fd, offset, SEEK_SET) < 0) {
+#ifdef MAVLINK_FTP_DEBUG
+			warnx("stream download: seek fail");
+#endif
+			return -1;
+		}
+
+		if (session.read_ahead == nullptr) {
+			return ::read(session.fd, data, kMaxDataLength);
+		}
+
+		int bytes_read = ::read(session.fd, session.read_ahead, kReadAheadLen);
+
+		if (bytes_read < 0) {
+			session.read_ahead_len = 0;
+			return -1;
+		}
+
+		session.read_ahead_offset = offset;
+		session.read_ahead_len = bytes_read;
+
+#ifdef __PX4_LINUX
+		// let the kernel fetch the next block in the background while this one is sent
+		posix_fadvise(session.fd, offset + bytes_read, kReadAheadLen, POSIX_FADV_WILLNEED);
+#endif
+	}
+
+	unsigned len = session.read_ahead_offset + session.read_ahead_len - offset;
+
+	if (len > kMaxDataLength) {
+		len = kMaxDataLength;
+	}
+
+	std::memcpy(data, &session.read_ahead[offset - session.read_ahead_offset], len);
+	return len;
+}
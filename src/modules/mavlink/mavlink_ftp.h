@@ -103,6 +103,8 @@ public:
 		kCmdRename,		///< Rename <path1> to <path2>
 		kCmdCalcFileCRC32,	///< Calculate CRC32 for file at <path>
 		kCmdBurstReadFile,	///< Burst download session file
+		kCmdBurstReadWindowed,	///< Stream session file from <offset>, with at most <data[0..3]> unacknowledged bytes
+		kCmdBurstAck,		///< Client has windowed stream data up to <offset>, <data> lists uint32 offsets to resend
 
 		kRspAck = 128,		///< Ack response
 		kRspNak			///< Nak response
@@ -132,7 +134,8 @@ private:
 	ErrorCode	_workList(PayloadHeader *payload, bool list_hidden = false);
 	ErrorCode	_workOpen(PayloadHeader *payload, int oflag);
 	ErrorCode	_workRead(PayloadHeader *payload);
-	ErrorCode	_workBurst(PayloadHeader *payload, uint8_t target_system_id);
+	ErrorCode	_workBurst(PayloadHeader *payload, uint8_t target_system_id, bool windowed);
+	ErrorCode	_workBurstAck(PayloadHeader *payload);
 	ErrorCode	_workWrite(PayloadHeader *payload);
 	ErrorCode	_workTerminate(PayloadHeader *payload);
 	ErrorCode	_workReset(PayloadHeader *payload);
@@ -143,6 +146,25 @@ private:
 	ErrorCode	_workRename(PayloadHeader *payload);
 	ErrorCode	_workCalcFileCRC32(PayloadHeader *payload);
 
+	struct SessionInfo;
+
+	/**
+	 * @return the open session addressed by the request, nullptr if it is invalid
+	 */
+	SessionInfo	*_get_session(const PayloadHeader *payload);
+	void		_close_session(SessionInfo &session);
+
+	/**
+	 * @return true if the session has a stream packet to send now
+	 */
+	bool		_stream_ready(const SessionInfo &session) const;
+
+	/**
+	 * Read stream data from the read-ahead buffer of the session, refilling it from the file as needed.
+	 * @return number of bytes copied to data (at most kMaxDataLength), -1 on error with errno set
+	 */
+	int		_stream_read(SessionInfo &session, uint32_t offset, uint8_t *data);
+
 	uint8_t _getServerSystemId(void);
 	uint8_t _getServerComponentId(void);
 	uint8_t _getServerChannel(void);
@@ -160,16 +182,35 @@ private:
 	/// @brief Maximum data size in RequestHeader::data
 	static const uint8_t	kMaxDataLength = MAVLINK_MSG_FILE_TRANSFER_PROTOCOL_FIELD_PAYLOAD_LEN - sizeof(PayloadHeader);
 
+#ifdef __PX4_NUTTX
+	static constexpr unsigned kMaxSessions = 2;
+	static constexpr unsigned kReadAheadChunks = 4;
+#else
+	static constexpr unsigned kMaxSessions = 4;
+	static constexpr unsigned kReadAheadChunks = 64;
+#endif
+	static constexpr unsigned kReadAheadLen = kReadAheadChunks * kMaxDataLength;	///< file data read with one read() while streaming
+	static constexpr unsigned kMaxResend = kMaxDataLength / sizeof(uint32_t);	///< offsets a single kCmdBurstAck can list
+
 	struct SessionInfo {
 		int		fd;
 		uint32_t	file_size;
 		bool		stream_download;
+		bool		stream_windowed;	///< started by kCmdBurstReadWindowed instead of kCmdBurstReadFile
 		uint32_t	stream_offset;
+		uint32_t	stream_acked_offset;	///< windowed: the client has all data before this offset
+		uint32_t	stream_window;		///< windowed: maximum number of bytes sent beyond stream_acked_offset
 		uint16_t	stream_seq_number;
 		uint8_t		stream_target_system_id;
 		unsigned	stream_chunk_transmitted;
+		uint32_t	resend_offsets[kMaxResend];	///< windowed: packets the client asked for again
+		unsigned	resend_count;
+		uint8_t		*read_ahead;		///< file data starting at read_ahead_offset, allocated while streaming
+		uint32_t	read_ahead_offset;
+		unsigned	read_ahead_len;
 	};
-	struct SessionInfo _session_info;	///< Session info, fd=-1 for no active session
+	struct SessionInfo _session_info[kMaxSessions];	///< Session info, fd=-1 for no active session
+	unsigned _stream_next_session;	///< streaming sessions take turns, starting with this one
 
 	ReceiveMessageFunc_t	_utRcvMsgFunc;	///< Unit test override for mavlink message sending
 	void			*_worker_data;	///< Additional parameter to _utRcvMsgFunc;
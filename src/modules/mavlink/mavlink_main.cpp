@@ -64,6 +64,10 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#ifdef __PX4_POSIX
+#include <netinet/tcp.h>
+#endif
+
 #include <drivers/device/device.h>
 #include <drivers/drv_hrt.h>
 #include <arch/board/board.h>
@@ -102,9 +106,21 @@
 #define DEFAULT_DEVICE_NAME			"/dev/ttyS1"
 #define MAX_DATA_RATE				10000000	///< max data rate in bytes/s
 #define MAIN_LOOP_DELAY 			10000	///< 100 Hz @ 1000 bytes/s data rate
+#define MAIN_LOOP_MIN_DELAY			1000	///< minimum sleep of the main loop, even if a stream is due earlier
+#ifdef __PX4_NUTTX
+#define FORWARD_RING_SIZE			2048	///< bytes per source instance, must be a power of two
+#else
+#define FORWARD_RING_SIZE			16384	///< bytes per source instance, must be a power of two
+#endif
 #define FLOW_CONTROL_DISABLE_THRESHOLD		40	///< picked so that some messages still would fit it.
 //#define MAVLINK_PRINT_PACKETS
 
+#ifdef MSG_NOSIGNAL
+#define TCP_SEND_FLAGS				(MSG_DONTWAIT | MSG_NOSIGNAL)
+#else
+#define TCP_SEND_FLAGS				MSG_DONTWAIT	///< SIGPIPE is disabled per socket with SO_NOSIGPIPE
+#endif
+
 static Mavlink *_mavlink_instances = nullptr;
 
 /**
@@ -210,6 +226,8 @@ Mavlink::Mavlink() :
 	_main_loop_delay(1000),
 	_subscriptions(nullptr),
 	_streams(nullptr),
+	_stream_scheduler(this),
+	_next_rate_mult_update(0),
 	_mavlink_shell(nullptr),
 	_mavlink_ulog(nullptr),
 	_mavlink_ulog_stop_requested(false),
@@ -242,6 +260,8 @@ Mavlink::Mavlink() :
 	_bytes_tx(0),
 	_bytes_txerr(0),
 	_bytes_rx(0),
+	_tx_message_count(0),
+	_tx_byte_count(0),
 	_bytes_timestamp(0),
 	_rate_tx(0.0f),
 	_rate_txerr(0.0f),
@@ -255,15 +275,28 @@ Mavlink::Mavlink() :
 	_broadcast_address_not_found_warned(false),
 	_broadcast_failed_warned(false),
 	_network_buf{},
-	_network_buf_len(0),
+	_network_buf_len{},
+	_network_batch_count(0),
+#ifdef __PX4_LINUX
+	_network_msgs{},
+	_network_iov{},
+#endif
+	_tcp_client(false),
+	_tcp_listen_fd(-1),
+	_tcp_conn_fd(-1),
+	_tcp_last_connect_attempt(0),
+	_tcp_pending{},
+	_tcp_pending_len(0),
+	_tcp_pending_offset(0),
 #endif
 	_socket_fd(-1),
 	_protocol(SERIAL),
 	_network_port(14556),
 	_remote_port(DEFAULT_REMOTE_PORT_UDP),
 	_rstatus {},
-	_message_buffer {},
-	_message_buffer_mutex {},
+	_forward_rings{},
+	_forward_count(0),
+	_forward_drop_count(0),
 	_send_mutex {},
 	_param_initialized(false),
 	_broadcast_mode(Mavlink::BROADCAST_MODE_OFF),
@@ -351,6 +384,12 @@ Mavlink::~Mavlink()
 			}
 		} while (_task_running);
 	}
+
+	/* the receive threads of the other instances may pass frames until all
+	 * instances stopped, so the rings only go away with the unlinked instance */
+	for (int i = 0; i < MAVLINK_COMM_NUM_BUFFERS; i++) {
+		delete _forward_rings[i];
+	}
 }
 
 void
@@ -479,7 +518,7 @@ Mavlink::destroy_all_instances()
 }
 
 int
-Mavlink::get_status_all_instances()
+Mavlink::get_status_all_instances(bool show_streams)
 {
 	Mavlink *inst = ::_mavlink_instances;
 
@@ -490,6 +529,10 @@ Mavlink::get_status_all_instances()
 		printf("\ninstance #%u:\n", iterations);
 		inst->display_status();
 
+		if (show_streams) {
+			inst->display_status_streams();
+		}
+
 		/* move on */
 		inst = inst->next;
 		iterations++;
@@ -520,9 +563,13 @@ Mavlink::instance_exists(const char *device_name, Mavlink *self)
 void
 Mavlink::forward_message(const mavlink_message_t *msg, Mavlink *self)
 {
+	/* encoded once, on the first instance that takes the message */
+	uint8_t frame[MAVLINK_MAX_PACKET_LEN];
+	unsigned frame_len = 0;
+
 	Mavlink *inst;
 	LL_FOREACH(_mavlink_instances, inst) {
-		if (inst != self) {
+		if (inst != self && inst->get_forwarding_on()) {
 			const mavlink_msg_entry_t *meta = mavlink_get_msg_entry(msg->msgid);
 
 			// Extract target system and target component if set
@@ -534,7 +581,11 @@ Mavlink::forward_message(const mavlink_message_t *msg, Mavlink *self)
 			if ((target_system_id == 0 || target_system_id == self->get_system_id())
 			    && (target_component_id == 0 || target_component_id != self->get_component_id())) {
 
-				inst->pass_message(msg);
+				if (frame_len == 0) {
+					frame_len = mavlink_msg_to_send_buffer(frame, msg);
+				}
+
+				inst->pass_frame(frame, frame_len, self);
 			}
 		}
 	}
@@ -936,6 +987,10 @@ Mavlink::begin_send()
 	// must protect the network buffer so other calls from receive_thread do not
 	// mangle the message.
 	pthread_mutex_lock(&_send_mutex);
+
+	if (should_transmit()) {
+		_tx_message_count++;
+	}
 }
 
 int
@@ -945,58 +1000,218 @@ Mavlink::send_packet()
 
 #ifdef __PX4_POSIX
 
+	unsigned packet_len = _network_buf_len[_network_batch_count];
+
 	/* Only send packets if there is something in the buffer. */
-	if (_network_buf_len == 0) {
+	if (packet_len == 0) {
 		pthread_mutex_unlock(&_send_mutex);
 		return 0;
 	}
 
 	if (get_protocol() == UDP) {
+		/* the packet is complete, keep it and start the next one in the batch */
+		_network_batch_count++;
+		ret = packet_len;
 
+		if (_network_batch_count >= NETWORK_BATCH_SIZE) {
+			flush_network_batch();
+		}
 
-		ret = sendto(_socket_fd, _network_buf, _network_buf_len, 0,
-			     (struct sockaddr *)&_src_addr, sizeof(_src_addr));
+	} else if (get_protocol() == TCP) {
+		ret = tcp_send(_network_buf[_network_batch_count], packet_len);
+		_network_buf_len[_network_batch_count] = 0;
 
-		struct telemetry_status_s &tstatus = get_rx_status();
+		if (ret < 0) {
+			count_txerr();
+			count_txerrbytes(packet_len);
+		}
+	}
 
-		/* resend message via broadcast if no valid connection exists */
-		if ((_mode != MAVLINK_MODE_ONBOARD) && broadcast_enabled() &&
-		    (!get_client_source_initialized()
-		     || (hrt_elapsed_time(&tstatus.heartbeat_time) > 3 * 1000 * 1000))) {
+#endif
 
-			if (!_broadcast_address_found) {
-				find_broadcast_address();
-			}
+	pthread_mutex_unlock(&_send_mutex);
+	return ret;
+}
 
-			if (_broadcast_address_found && _network_buf_len > 0) {
+void
+Mavlink::send_flush()
+{
+#ifdef __PX4_POSIX
 
-				int bret = sendto(_socket_fd, _network_buf, _network_buf_len, 0,
-						  (struct sockaddr *)&_bcast_addr, sizeof(_bcast_addr));
+	if (get_protocol() == UDP) {
+		pthread_mutex_lock(&_send_mutex);
+		flush_network_batch();
+		pthread_mutex_unlock(&_send_mutex);
 
-				if (bret <= 0) {
-					if (!_broadcast_failed_warned) {
-						PX4_ERR("sending broadcast failed, errno: %d: %s", errno, strerror(errno));
-						_broadcast_failed_warned = true;
-					}
+	} else if (get_protocol() == TCP && _tcp_pending_len > 0) {
+		pthread_mutex_lock(&_send_mutex);
+		tcp_flush_pending();
+		pthread_mutex_unlock(&_send_mutex);
+	}
 
-				} else {
-					_broadcast_failed_warned = false;
-				}
-			}
+#endif
+}
+
+#ifdef __PX4_POSIX
+bool
+Mavlink::broadcast_needed()
+{
+	struct telemetry_status_s &tstatus = get_rx_status();
+
+	/* resend message via broadcast if no valid connection exists */
+	if ((_mode != MAVLINK_MODE_ONBOARD) && broadcast_enabled() &&
+	    (!get_client_source_initialized()
+	     || (hrt_elapsed_time(&tstatus.heartbeat_time) > 3 * 1000 * 1000))) {
+
+		if (!_broadcast_address_found) {
+			find_broadcast_address();
 		}
 
-	} else if (get_protocol() == TCP) {
-		/* not implemented, but possible to do so */
-		PX4_ERR("TCP transport pending implementation");
+		return _broadcast_address_found;
+	}
+
+	return false;
+}
+
+void
+Mavlink::flush_network_batch()
+{
+	if (_network_batch_count == 0) {
+		return;
+	}
+
+	const bool broadcast = broadcast_needed();
+	bool broadcast_failed = false;
+
+#ifdef __PX4_LINUX
+	/* one sendmmsg() for the whole batch, with the broadcast copy of each packet right after it */
+	unsigned msg_count = 0;
+
+	for (unsigned i = 0; i < _network_batch_count; i++) {
+		_network_iov[i].iov_base = _network_buf[i];
+		_network_iov[i].iov_len = _network_buf_len[i];
+
+		for (unsigned copy = 0; copy < (broadcast ? 2u : 1u); copy++) {
+			struct msghdr &hdr = _network_msgs[msg_count++].msg_hdr;
+			memset(&hdr, 0, sizeof(hdr));
+			hdr.msg_name = (copy == 0) ? &_src_addr : &_bcast_addr;
+			hdr.msg_namelen = sizeof(struct sockaddr_in);
+			hdr.msg_iov = &_network_iov[i];
+			hdr.msg_iovlen = 1;
+		}
+	}
+
+	unsigned sent = 0;
+
+	while (sent < msg_count) {
+		int ret = sendmmsg(_socket_fd, &_network_msgs[sent], msg_count - sent, 0);
+
+		if (ret > 0) {
+			sent += ret;
+			continue;
+		}
+
+		/* the first remaining packet failed: skip it like a failed sendto() and carry on */
+		if (_network_msgs[sent].msg_hdr.msg_name == &_bcast_addr) {
+			broadcast_failed = true;
+		}
+
+		sent++;
+	}
+
+#else
+
+	for (unsigned i = 0; i < _network_batch_count; i++) {
+		sendto(_socket_fd, _network_buf[i], _network_buf_len[i], 0,
+		       (struct sockaddr *)&_src_addr, sizeof(_src_addr));
+
+		if (broadcast) {
+			int bret = sendto(_socket_fd, _network_buf[i], _network_buf_len[i], 0,
+					  (struct sockaddr *)&_bcast_addr, sizeof(_bcast_addr));
+
+			if (bret <= 0) {
+				broadcast_failed = true;
+			}
+		}
 	}
 
-	_network_buf_len = 0;
 #endif
 
-	pthread_mutex_unlock(&_send_mutex);
-	return ret;
+	if (broadcast) {
+		if (broadcast_failed) {
+			if (!_broadcast_failed_warned) {
+				PX4_ERR("sending broadcast failed, errno: %d: %s", errno, strerror(errno));
+				_broadcast_failed_warned = true;
+			}
+
+		} else {
+			_broadcast_failed_warned = false;
+		}
+	}
+
+	for (unsigned i = 0; i < _network_batch_count; i++) {
+		_network_buf_len[i] = 0;
+	}
+
+	_network_batch_count = 0;
+}
+
+bool
+Mavlink::tcp_flush_pending()
+{
+	if (_tcp_pending_len == 0) {
+		return true;
+	}
+
+	if (_tcp_conn_fd < 0) {
+		_tcp_pending_len = 0;
+		_tcp_pending_offset = 0;
+		return true;
+	}
+
+	ssize_t ret = ::send(_tcp_conn_fd, &_tcp_pending[_tcp_pending_offset], _tcp_pending_len - _tcp_pending_offset,
+			     TCP_SEND_FLAGS);
+
+	if (ret > 0) {
+		_tcp_pending_offset += ret;
+	}
+
+	if (_tcp_pending_offset < _tcp_pending_len) {
+		return false;
+	}
+
+	_tcp_pending_len = 0;
+	_tcp_pending_offset = 0;
+	return true;
 }
 
+int
+Mavlink::tcp_send(const uint8_t *buf, unsigned len)
+{
+	/* without a peer, or while the previous packet is still incomplete, the packet is dropped:
+	 * writing it would break the framing of the stream */
+	if (_tcp_conn_fd < 0 || !tcp_flush_pending()) {
+		return -1;
+	}
+
+	ssize_t ret = ::send(_tcp_conn_fd, buf, len, TCP_SEND_FLAGS);
+
+	if (ret < 0) {
+		/* a broken connection is noticed and closed by the receiver thread */
+		return -1;
+	}
+
+	if ((unsigned)ret < len) {
+		/* the socket buffer is full: keep the tail and send it before the next packet */
+		_tcp_pending_len = len - ret;
+		_tcp_pending_offset = 0;
+		memcpy(_tcp_pending, buf + ret, _tcp_pending_len);
+	}
+
+	return len;
+}
+#endif
+
 void
 Mavlink::send_bytes(const uint8_t *buf, unsigned packet_len)
 {
@@ -1007,6 +1222,7 @@ Mavlink::send_bytes(const uint8_t *buf, unsigned packet_len)
 	}
 
 	_last_write_try_time = hrt_absolute_time();
+	_tx_byte_count += packet_len;
 
 	if (_mavlink_start_time == 0) {
 		_mavlink_start_time = _last_write_try_time;
@@ -1034,9 +1250,12 @@ Mavlink::send_bytes(const uint8_t *buf, unsigned packet_len)
 #ifdef __PX4_POSIX
 
 	else {
-		if (_network_buf_len + packet_len < sizeof(_network_buf) / sizeof(_network_buf[0])) {
-			memcpy(&_network_buf[_network_buf_len], buf, packet_len);
-			_network_buf_len += packet_len;
+		/* append to the current packet of the batch, send_packet() completes it */
+		unsigned &buf_len = _network_buf_len[_network_batch_count];
+
+		if (buf_len + packet_len <= MAVLINK_MAX_PACKET_LEN) {
+			memcpy(&_network_buf[_network_batch_count][buf_len], buf, packet_len);
+			buf_len += packet_len;
 
 			ret = packet_len;
 		}
@@ -1234,6 +1453,121 @@ Mavlink::init_udp()
 #endif
 }
 
+void
+Mavlink::init_tcp()
+{
+#if defined (__PX4_LINUX) || defined (__PX4_DARWIN)
+
+	if (_tcp_client) {
+		/* the connection is (re-)established by the receiver thread */
+		_src_addr.sin_port = htons(_remote_port);
+		return;
+	}
+
+	PX4_DEBUG("Setting up TCP server with port %d", _network_port);
+
+	_myaddr.sin_family = AF_INET;
+	_myaddr.sin_addr.s_addr = htonl(INADDR_ANY);
+	_myaddr.sin_port = htons(_network_port);
+
+	if ((_tcp_listen_fd = socket(AF_INET, SOCK_STREAM, 0)) < 0) {
+		PX4_WARN("create socket failed: %s", strerror(errno));
+		return;
+	}
+
+	int reuse = 1;
+	setsockopt(_tcp_listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+	if (bind(_tcp_listen_fd, (struct sockaddr *)&_myaddr, sizeof(_myaddr)) < 0
+	    || listen(_tcp_listen_fd, 1) < 0) {
+		PX4_WARN("bind failed: %s", strerror(errno));
+		close(_tcp_listen_fd);
+		_tcp_listen_fd = -1;
+		return;
+	}
+
+	/* accept() is polled from the receiver thread and must not block it */
+	fcntl(_tcp_listen_fd, F_SETFL, fcntl(_tcp_listen_fd, F_GETFL, 0) | O_NONBLOCK);
+
+#endif
+}
+
+#ifdef __PX4_POSIX
+int
+Mavlink::tcp_update_connection()
+{
+	/* in server mode look for a new client on every call while there is none, once a second otherwise */
+	const hrt_abstime retry_interval = (_tcp_client || _tcp_conn_fd >= 0) ? 1000000 : 0;
+
+	if ((_tcp_client && _tcp_conn_fd >= 0) || hrt_elapsed_time(&_tcp_last_connect_attempt) < retry_interval) {
+		return (_tcp_conn_fd >= 0) ? _tcp_conn_fd : _tcp_listen_fd;
+	}
+
+	_tcp_last_connect_attempt = hrt_absolute_time();
+
+	int fd = -1;
+
+	if (_tcp_client) {
+		fd = socket(AF_INET, SOCK_STREAM, 0);
+
+		if (fd >= 0) {
+			/* bound the time connect() may block the receiver thread (honoured by Linux and macOS) */
+			struct timeval tv = {0, 200000};
+			setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+			if (connect(fd, (struct sockaddr *)&_src_addr, sizeof(_src_addr)) < 0) {
+				close(fd);
+				fd = -1;
+			}
+		}
+
+	} else if (_tcp_listen_fd >= 0) {
+		fd = accept(_tcp_listen_fd, nullptr, nullptr);
+	}
+
+	if (fd >= 0) {
+		int one = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+#ifdef SO_NOSIGPIPE
+		setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+		/* a new client replaces the current one */
+		pthread_mutex_lock(&_send_mutex);
+
+		if (_tcp_conn_fd >= 0) {
+			close(_tcp_conn_fd);
+		}
+
+		_tcp_conn_fd = fd;
+		_tcp_pending_len = 0;
+		_tcp_pending_offset = 0;
+		pthread_mutex_unlock(&_send_mutex);
+
+		set_client_source_initialized();
+		PX4_INFO("TCP connection established");
+	}
+
+	return (_tcp_conn_fd >= 0) ? _tcp_conn_fd : _tcp_listen_fd;
+}
+
+void
+Mavlink::tcp_close_connection()
+{
+	pthread_mutex_lock(&_send_mutex);
+
+	if (_tcp_conn_fd >= 0) {
+		close(_tcp_conn_fd);
+		_tcp_conn_fd = -1;
+		PX4_INFO("TCP connection closed");
+	}
+
+	_tcp_pending_len = 0;
+	_tcp_pending_offset = 0;
+	pthread_mutex_unlock(&_send_mutex);
+}
+#endif
+
 void
 Mavlink::handle_message(const mavlink_message_t *msg)
 {
@@ -1381,6 +1715,7 @@ Mavlink::configure_stream(const char *stream_name, const float rate)
 				delete stream;
 			}
 
+			_stream_scheduler.invalidate();
 			return OK;
 		}
 	}
@@ -1398,6 +1733,7 @@ Mavlink::configure_stream(const char *stream_name, const float rate)
 			stream = streams_list[i]->new_instance(this);
 			stream->set_interval(interval);
 			LL_APPEND(_streams, stream);
+			_stream_scheduler.invalidate();
 
 			return OK;
 		}
@@ -1432,6 +1768,8 @@ Mavlink::adjust_stream_rates(const float multiplier)
 		/* set new interval */
 		stream->set_interval(interval * multiplier);
 	}
+
+	_stream_scheduler.invalidate();
 }
 
 void
@@ -1464,132 +1802,69 @@ Mavlink::configure_stream_threadsafe(const char *stream_name, const float rate)
 	}
 }
 
-int
-Mavlink::message_buffer_init(int size)
-{
-
-	_message_buffer.size = size;
-	_message_buffer.write_ptr = 0;
-	_message_buffer.read_ptr = 0;
-	_message_buffer.data = (char *)malloc(_message_buffer.size);
-
-	int ret;
-
-	if (_message_buffer.data == nullptr) {
-		ret = PX4_ERROR;
-		_message_buffer.size = 0;
-
-	} else {
-		ret = OK;
-	}
-
-	return ret;
-}
-
 void
-Mavlink::message_buffer_destroy()
-{
-	_message_buffer.size = 0;
-	_message_buffer.write_ptr = 0;
-	_message_buffer.read_ptr = 0;
-	free(_message_buffer.data);
-}
-
-int
-Mavlink::message_buffer_count()
+Mavlink::pass_frame(const uint8_t *frame, unsigned len, Mavlink *source)
 {
-	int n = _message_buffer.write_ptr - _message_buffer.read_ptr;
-
-	if (n < 0) {
-		n += _message_buffer.size;
+	if (!_forwarding_on) {
+		return;
 	}
 
-	return n;
-}
-
-int
-Mavlink::message_buffer_is_empty()
-{
-	return _message_buffer.read_ptr == _message_buffer.write_ptr;
-}
-
-
-bool
-Mavlink::message_buffer_write(const void *ptr, int size)
-{
-	// bytes available to write
-	int available = _message_buffer.read_ptr - _message_buffer.write_ptr - 1;
+	const int index = source->get_instance_id();
 
-	if (available < 0) {
-		available += _message_buffer.size;
+	if (index < 0 || index >= MAVLINK_COMM_NUM_BUFFERS) {
+		return;
 	}
 
-	if (size > available) {
-		// buffer overflow
-		return false;
-	}
+	/* only the source writes this slot, the main loop of this instance reads it */
+	MavlinkFrameRing *ring = __atomic_load_n(&_forward_rings[index], __ATOMIC_ACQUIRE);
 
-	char *c = (char *) ptr;
-	int n = _message_buffer.size - _message_buffer.write_ptr;	// bytes to end of the buffer
+	if (ring == nullptr) {
+		ring = new MavlinkFrameRing(FORWARD_RING_SIZE);
 
-	if (n < size) {
-		// message goes over end of the buffer
-		memcpy(&(_message_buffer.data[_message_buffer.write_ptr]), c, n);
-		_message_buffer.write_ptr = 0;
+		if (ring == nullptr || !ring->valid()) {
+			delete ring;
+			__atomic_fetch_add(&_forward_drop_count, 1, __ATOMIC_RELAXED);
+			return;
+		}
 
-	} else {
-		n = 0;
+		__atomic_store_n(&_forward_rings[index], ring, __ATOMIC_RELEASE);
 	}
 
-	// now: n = bytes already written
-	int p = size - n;	// number of bytes to write
-	memcpy(&(_message_buffer.data[_message_buffer.write_ptr]), &(c[n]), p);
-	_message_buffer.write_ptr = (_message_buffer.write_ptr + p) % _message_buffer.size;
-	return true;
+	if (!ring->push(frame, len)) {
+		__atomic_fetch_add(&_forward_drop_count, 1, __ATOMIC_RELAXED);
+	}
 }
 
-int
-Mavlink::message_buffer_get_ptr(void **ptr, bool *is_part)
+void
+Mavlink::send_forwarded_frames()
 {
-	// bytes available to read
-	int available = _message_buffer.write_ptr - _message_buffer.read_ptr;
-
-	if (available == 0) {
-		return 0;	// buffer is empty
-	}
+	uint8_t frame[MAVLINK_MAX_PACKET_LEN];
 
-	int n = 0;
+	for (int i = 0; i < MAVLINK_COMM_NUM_BUFFERS; i++) {
+		MavlinkFrameRing *ring = __atomic_load_n(&_forward_rings[i], __ATOMIC_ACQUIRE);
 
-	if (available > 0) {
-		// read pointer is before write pointer, all available bytes can be read
-		n = available;
-		*is_part = false;
+		if (ring == nullptr) {
+			continue;
+		}
 
-	} else {
-		// read pointer is after write pointer, read bytes from read_ptr to end of the buffer
-		n = _message_buffer.size - _message_buffer.read_ptr;
-		*is_part = _message_buffer.write_ptr > 0;
-	}
+		unsigned len;
 
-	*ptr = &(_message_buffer.data[_message_buffer.read_ptr]);
-	return n;
-}
+		/* drain everything that is queued, but leave frames that do not fit into the UART for the next loop */
+		while ((len = ring->front_size()) > 0) {
+			if (get_protocol() == SERIAL && get_free_tx_buf() < (int)len) {
+				break;
+			}
 
-void
-Mavlink::message_buffer_mark_read(int n)
-{
-	_message_buffer.read_ptr = (_message_buffer.read_ptr + n) % _message_buffer.size;
-}
+			if (ring->pop(frame, sizeof(frame)) == 0) {
+				continue;
+			}
 
-void
-Mavlink::pass_message(const mavlink_message_t *msg)
-{
-	if (_forwarding_on) {
-		/* size is 8 bytes plus variable payload */
-		int size = MAVLINK_NUM_NON_PAYLOAD_BYTES + msg->len;
-		pthread_mutex_lock(&_message_buffer_mutex);
-		message_buffer_write(msg, size);
-		pthread_mutex_unlock(&_message_buffer_mutex);
+			/* the frame is sent as received, with its original sequence number and CRC */
+			begin_send();
+			send_bytes(frame, len);
+			send_packet();
+			_forward_count++;
+		}
 	}
 }
 
@@ -1742,9 +2017,10 @@ Mavlink::task_main(int argc, char *argv[])
 #ifdef __PX4_POSIX
 	char *eptr;
 	int temp_int_arg;
+	bool tcp = false;
 #endif
 
-	while ((ch = px4_getopt(argc, argv, "b:r:d:u:o:m:t:fvwx", &myoptind, &myoptarg)) != EOF) {
+	while ((ch = px4_getopt(argc, argv, "b:r:d:u:o:m:t:Tfvwx", &myoptind, &myoptarg)) != EOF) {
 		switch (ch) {
 		case 'b':
 			_baudrate = strtoul(myoptarg, nullptr, 10);
@@ -1813,11 +2089,16 @@ Mavlink::task_main(int argc, char *argv[])
 			}
 
 			break;
+
+		case 'T':
+			tcp = true;
+			break;
 #else
 
 		case 'u':
 		case 'o':
 		case 't':
+		case 'T':
 			warnx("UDP options not supported on this platform");
 			err_flag = true;
 			break;
@@ -1881,6 +2162,16 @@ Mavlink::task_main(int argc, char *argv[])
 		return PX4_ERROR;
 	}
 
+#ifdef __PX4_POSIX
+
+	if (tcp) {
+		/* with a partner IP we connect to it, otherwise we wait for a client */
+		set_protocol(TCP);
+		_tcp_client = _src_addr_initialized;
+	}
+
+#endif
+
 	if (_datarate == 0) {
 		/* convert bits to bytes and use 1/2 of bandwidth by default */
 		_datarate = _baudrate / 20;
@@ -1922,26 +2213,30 @@ Mavlink::task_main(int argc, char *argv[])
 
 		PX4_INFO("mode: %s, data rate: %d B/s on udp port %hu remote port %hu",
 			 mavlink_mode_str(_mode), _datarate, _network_port, _remote_port);
-	}
 
-	/* initialize send mutex */
-	pthread_mutex_init(&_send_mutex, nullptr);
+	} else if (get_protocol() == TCP) {
+#ifdef __PX4_POSIX
 
-	/* if we are passing on mavlink messages, we need to prepare a buffer for this instance */
-	if (_forwarding_on || _ftp_on) {
-		/* initialize message buffer if multiplexing is on or its needed for FTP.
-		 * make space for two messages plus off-by-one space as we use the empty element
-		 * marker ring buffer approach.
-		 */
-		if (OK != message_buffer_init(2 * sizeof(mavlink_message_t) + 1)) {
-			warnx("msg buf:");
-			return 1;
+		if (_tcp_client) {
+			PX4_INFO("mode: %s, data rate: %d B/s on tcp connection to %s:%hu",
+				 mavlink_mode_str(_mode), _datarate, inet_ntoa(_src_addr.sin_addr), _remote_port);
+
+		} else {
+			if (Mavlink::get_instance_for_network_port(_network_port) != nullptr) {
+				warnx("port %d already occupied", _network_port);
+				return PX4_ERROR;
+			}
+
+			PX4_INFO("mode: %s, data rate: %d B/s on tcp port %hu",
+				 mavlink_mode_str(_mode), _datarate, _network_port);
 		}
 
-		/* initialize message buffer mutex */
-		pthread_mutex_init(&_message_buffer_mutex, nullptr);
+#endif
 	}
 
+	/* initialize send mutex */
+	pthread_mutex_init(&_send_mutex, nullptr);
+
 	/* Initialize system properties */
 	mavlink_update_system();
 
@@ -1957,13 +2252,10 @@ Mavlink::task_main(int argc, char *argv[])
 	 * beginning and not just when the topic exists. */
 	ack_sub->subscribe_from_beginning(true);
 
-	uint64_t ack_time = 0;
 	MavlinkOrbSubscription *mavlink_log_sub = add_orb_subscription(ORB_ID(mavlink_log));
 
 	struct vehicle_status_s status;
 	status_sub->update(&status_time, &status);
-	struct vehicle_command_ack_s command_ack;
-	ack_sub->update(&ack_time, &command_ack);
 
 	/* add default streams depending on mode */
 
@@ -2125,6 +2417,9 @@ Mavlink::task_main(int argc, char *argv[])
 	/* init socket if necessary */
 	if (get_protocol() == UDP) {
 		init_udp();
+
+	} else if (get_protocol() == TCP) {
+		init_tcp();
 	}
 
 	/* if the protocol is serial, we send the system version blindly */
@@ -2132,15 +2427,29 @@ Mavlink::task_main(int argc, char *argv[])
 		send_autopilot_capabilites();
 	}
 
+	hrt_abstime next_deadline = 0;
+
 	while (!_task_should_exit) {
-		/* main loop */
-		usleep(_main_loop_delay);
+		/* main loop: sleep until the next stream is due, but not longer than the main loop delay,
+		 * as other things (forwarding, parameters, ...) are polled here as well */
+		hrt_abstime now = hrt_absolute_time();
+		hrt_abstime wakeup = now + _main_loop_delay;
+
+		if (next_deadline < wakeup) {
+			wakeup = (next_deadline > now + MAIN_LOOP_MIN_DELAY) ? next_deadline : now + MAIN_LOOP_MIN_DELAY;
+		}
+
+		usleep(wakeup - now);
 
 		perf_begin(_loop_perf);
 
 		hrt_abstime t = hrt_absolute_time();
 
-		update_rate_mult();
+		/* the link budget does not need to be updated faster than the original loop rate */
+		if (t >= _next_rate_mult_update) {
+			update_rate_mult();
+			_next_rate_mult_update = t + _main_loop_delay;
+		}
 
 		if (param_sub->update(&param_time, nullptr)) {
 			/* parameters updated */
@@ -2202,22 +2511,25 @@ Mavlink::task_main(int argc, char *argv[])
 			set_manual_input_mode_generation(status.rc_input_mode == vehicle_status_s::RC_IN_MODE_GENERATED);
 		}
 
-		/* send command ACK */
+		/* send command ACKs, draining the whole queue so that back-to-back ACKs are not dropped */
 		uint16_t current_command_ack = 0;
+		struct vehicle_command_ack_s command_acks[vehicle_command_ack_s::ORB_QUEUE_LENGTH];
+		unsigned num_acks = ack_sub->update_batch(command_acks, vehicle_command_ack_s::ORB_QUEUE_LENGTH);
 
-		if (ack_sub->update(&ack_time, &command_ack)) {
+		for (unsigned i = 0; i < num_acks; i++) {
 			mavlink_command_ack_t msg;
-			msg.result = command_ack.result;
-			msg.command = command_ack.command;
-			current_command_ack = command_ack.command;
+			msg.result = command_acks[i].result;
+			msg.command = command_acks[i].command;
+			current_command_ack = command_acks[i].command;
 
 			mavlink_msg_command_ack_send_struct(get_channel(), &msg);
 		}
 
-		struct mavlink_log_s mavlink_log;
+		struct mavlink_log_s mavlink_logs[MAVLINK_LOG_QUEUE_SIZE];
+		unsigned num_logs = mavlink_log_sub->update_batch(mavlink_logs, MAVLINK_LOG_QUEUE_SIZE);
 
-		if (mavlink_log_sub->update_if_changed(&mavlink_log)) {
-			_logbuffer.put(&mavlink_log);
+		for (unsigned i = 0; i < num_logs; i++) {
+			_logbuffer.put(&mavlink_logs[i]);
 		}
 
 		/* check for shell output */
@@ -2292,60 +2604,17 @@ Mavlink::task_main(int argc, char *argv[])
 			_subscribe_to_stream = nullptr;
 		}
 
-		/* update streams */
-		MavlinkStream *stream;
-		LL_FOREACH(_streams, stream) {
-			stream->update(t);
-		}
-
-		/* pass messages from other UARTs or FTP worker */
-		if (_forwarding_on || _ftp_on) {
-
-			bool is_part;
-			uint8_t *read_ptr;
-			uint8_t *write_ptr;
-
-			pthread_mutex_lock(&_message_buffer_mutex);
-			int available = message_buffer_get_ptr((void **)&read_ptr, &is_part);
-			pthread_mutex_unlock(&_message_buffer_mutex);
-
-			if (available > 0) {
-				// Reconstruct message from buffer
-
-				mavlink_message_t msg;
-				write_ptr = (uint8_t *)&msg;
+		/* update the streams that are due */
+		next_deadline = _stream_scheduler.update(t);
 
-				// Pull a single message from the buffer
-				size_t read_count = available;
-
-				if (read_count > sizeof(mavlink_message_t)) {
-					read_count = sizeof(mavlink_message_t);
-				}
-
-				memcpy(write_ptr, read_ptr, read_count);
-
-				// We hold the mutex until after we complete the second part of the buffer. If we don't
-				// we may end up breaking the empty slot overflow detection semantics when we mark the
-				// possibly partial read below.
-				pthread_mutex_lock(&_message_buffer_mutex);
-
-				message_buffer_mark_read(read_count);
-
-				/* write second part of buffer if there is some */
-				if (is_part && read_count < sizeof(mavlink_message_t)) {
-					write_ptr += read_count;
-					available = message_buffer_get_ptr((void **)&read_ptr, &is_part);
-					read_count = sizeof(mavlink_message_t) - read_count;
-					memcpy(write_ptr, read_ptr, read_count);
-					message_buffer_mark_read(available);
-				}
-
-				pthread_mutex_unlock(&_message_buffer_mutex);
-
-				resend_message(&msg);
-			}
+		/* pass messages from other UARTs */
+		if (_forwarding_on) {
+			send_forwarded_frames();
 		}
 
+		/* send what is left of the network batch */
+		send_flush();
+
 		/* update TX/RX rates*/
 		if (t > _bytes_timestamp + 1000000) {
 			if (_bytes_timestamp != 0) {
@@ -2356,6 +2625,11 @@ Mavlink::task_main(int argc, char *argv[])
 				_bytes_tx = 0;
 				_bytes_txerr = 0;
 				_bytes_rx = 0;
+
+				MavlinkStream *stream;
+				LL_FOREACH(_streams, stream) {
+					stream->update_rate_stats(dt / 1000.0f);
+				}
 			}
 
 			_bytes_timestamp = t;
@@ -2407,11 +2681,20 @@ Mavlink::task_main(int argc, char *argv[])
 		_socket_fd = -1;
 	}
 
-	if (_forwarding_on || _ftp_on) {
-		message_buffer_destroy();
-		pthread_mutex_destroy(&_message_buffer_mutex);
+#ifdef __PX4_POSIX
+
+	if (_tcp_conn_fd >= 0) {
+		close(_tcp_conn_fd);
+		_tcp_conn_fd = -1;
+	}
+
+	if (_tcp_listen_fd >= 0) {
+		close(_tcp_listen_fd);
+		_tcp_listen_fd = -1;
 	}
 
+#endif
+
 	if (_mavlink_ulog) {
 		_mavlink_ulog->stop();
 		_mavlink_ulog = nullptr;
@@ -2544,6 +2827,7 @@ Mavlink::display_status()
 	printf("\ttxerr: %.3f kB/s\n", (double)_rate_txerr);
 	printf("\trx: %.3f kB/s\n", (double)_rate_rx);
 	printf("\trate mult: %.3f\n", (double)_rate_mult);
+	_stream_scheduler.print_status();
 
 	if (_mavlink_ulog) {
 		printf("\tULog rate: %.1f%% of max %.1f%%\n", (double)_mavlink_ulog->current_data_rate() * 100.,
@@ -2551,6 +2835,12 @@ Mavlink::display_status()
 	}
 
 	printf("\taccepting commands: %s\n", (accepting_commands()) ? "YES" : "NO");
+
+	if (_forwarding_on) {
+		printf("\tforwarding: %u frames sent, %u dropped\n", _forward_count,
+		       __atomic_load_n(&_forward_drop_count, __ATOMIC_RELAXED));
+	}
+
 	printf("\tMAVLink version: %i\n", _protocol_version);
 
 	printf("\ttransport protocol: ");
@@ -2561,7 +2851,18 @@ Mavlink::display_status()
 		break;
 
 	case TCP:
+#ifdef __PX4_POSIX
+		if (_tcp_client) {
+			printf("TCP client (%s:%i), %s\n", inet_ntoa(_src_addr.sin_addr), _remote_port,
+			       (_tcp_conn_fd >= 0) ? "connected" : "not connected");
+
+		} else {
+			printf("TCP server (%i), %s\n", _network_port, (_tcp_conn_fd >= 0) ? "client connected" : "no client");
+		}
+
+#else
 		printf("TCP\n");
+#endif
 		break;
 
 	case SERIAL:
@@ -2570,6 +2871,22 @@ Mavlink::display_status()
 	}
 }
 
+void
+Mavlink::display_status_streams()
+{
+	printf("\t%-32s %10s %10s %10s %10s\n", "stream", "req. [Hz]", "sched [Hz]", "sent [Hz]", "sent [B/s]");
+
+	MavlinkStream *stream;
+	LL_FOREACH(_streams, stream) {
+		const unsigned interval = stream->get_interval();
+		const float requested = (interval > 0) ? 1000000.0f / interval : 0.0f;
+		const float scheduled = stream->const_rate() ? requested : requested * _rate_mult;
+
+		printf("\t%-32s %10.2f %10.2f %10.2f %10.0f\n", stream->get_name(), (double)requested, (double)scheduled,
+		       (double)stream->get_achieved_rate(), (double)stream->get_achieved_bandwidth());
+	}
+}
+
 int
 Mavlink::stream_command(int argc, char *argv[])
 {
@@ -2738,6 +3055,7 @@ $ mavlink stream -u 14556 -s HIGHRES_IMU -r 50
 	PRINT_MODULE_USAGE_PARAM_INT('o', 14550, 0, 65536, "Select UDP Network Port (remote)", true);
 	PRINT_MODULE_USAGE_PARAM_STRING('t', "127.0.0.1", nullptr,
 					"Partner IP (broadcasting can be enabled via MAV_BROADCAST param)", true);
+	PRINT_MODULE_USAGE_PARAM_FLAG('T', "Use TCP: listen on the local port, or connect to -t on the remote port", true);
 #endif
 	PRINT_MODULE_USAGE_PARAM_STRING('m', "normal", "custom|camera|onboard|osd|magic|config|iridium",
 					"Mode: sets default streams and rates", true);
@@ -2749,6 +3067,7 @@ $ mavlink stream -u 14556 -s HIGHRES_IMU -r 50
 	PRINT_MODULE_USAGE_COMMAND_DESCR("stop-all", "Stop all instances");
 
 	PRINT_MODULE_USAGE_COMMAND_DESCR("status", "Print status for all instances");
+	PRINT_MODULE_USAGE_ARG("streams", "Print the requested, scheduled and achieved rate of each stream", true);
 
 	PRINT_MODULE_USAGE_COMMAND_DESCR("stream", "Configure the sending rate of a stream for a running instance");
 #ifdef __PX4_POSIX
@@ -2782,7 +3101,7 @@ int mavlink_main(int argc, char *argv[])
 		return Mavlink::destroy_all_instances();
 
 	} else if (!strcmp(argv[1], "status")) {
-		return Mavlink::get_status_all_instances();
+		return Mavlink::get_status_all_instances(argc > 2 && !strcmp(argv[2], "streams"));
 
 	} else if (!strcmp(argv[1], "stream")) {
 		return Mavlink::stream_command(argc, argv);
@@ -64,6 +64,8 @@
 #include "mavlink_bridge_header.h"
 #include "mavlink_orb_subscription.h"
 #include "mavlink_stream.h"
+#include "mavlink_stream_scheduler.h"
+#include "mavlink_frame_ring.h"
 #include "mavlink_messages.h"
 #include "mavlink_shell.h"
 #include "mavlink_ulog.h"
@@ -100,6 +102,11 @@ public:
 	 */
 	void			display_status();
 
+	/**
+	 * Display requested, scheduled and achieved rates of all streams.
+	 */
+	void			display_status_streams();
+
 	static int		stream_command(int argc, char *argv[]);
 
 	static int		instance_count();
@@ -127,7 +134,10 @@ public:
 
 	static int		destroy_all_instances();
 
-	static int		get_status_all_instances();
+	/**
+	 * @param show_streams also print the rates of all streams
+	 */
+	static int		get_status_all_instances(bool show_streams);
 
 	static bool		instance_exists(const char *device_name, Mavlink *self);
 
@@ -287,6 +297,14 @@ public:
 	 */
 	int             send_packet();
 
+	/**
+	 * Send all packets that are batched up for the network link.
+	 *
+	 * Called at the end of every main and receiver loop iteration, so a packet
+	 * is never held back for longer than one loop.
+	 */
+	void			send_flush();
+
 	/**
 	 * Resend message as is, don't change sequence number and CRC.
 	 */
@@ -370,11 +388,6 @@ public:
 	bool			get_wait_to_transmit() { return _wait_to_transmit; }
 	bool			should_transmit() { return (_boot_complete && (!_wait_to_transmit || (_wait_to_transmit && _received_messages))); }
 
-	bool			message_buffer_write(const void *ptr, int size);
-
-	void			lockMessageBufferMutex(void) { pthread_mutex_lock(&_message_buffer_mutex); }
-	void			unlockMessageBufferMutex(void) { pthread_mutex_unlock(&_message_buffer_mutex); }
-
 	/**
 	 * Count a transmision error
 	 */
@@ -395,6 +408,16 @@ public:
 	 */
 	void			count_rxbytes(unsigned n) { _bytes_rx += n; };
 
+	/**
+	 * Get the number of messages handed to the link so far (wraps around)
+	 */
+	unsigned		get_tx_message_count() const { return _tx_message_count; }
+
+	/**
+	 * Get the number of bytes handed to the link so far, including failed ones (wraps around)
+	 */
+	unsigned		get_tx_byte_count() const { return _tx_byte_count; }
+
 	/**
 	 * Get the receive status of this MAVLink link
 	 */
@@ -411,6 +434,26 @@ public:
 	unsigned short		get_remote_port() { return _remote_port; }
 
 	int 			get_socket_fd() { return _socket_fd; };
+
+#ifdef __PX4_POSIX
+	/**
+	 * Maintain the TCP connection: accept a new client in server mode or
+	 * reconnect to the partner in client mode. Called from the receiver thread.
+	 *
+	 * @return the file descriptor the receiver should poll, or -1 if there is none
+	 */
+	int			tcp_update_connection();
+
+	/**
+	 * Drop the current TCP connection, e.g. after the peer closed it.
+	 */
+	void			tcp_close_connection();
+
+	/**
+	 * @return true if the given fd is the connected TCP stream (and not the listening socket)
+	 */
+	bool			tcp_is_connection(int fd) { return fd >= 0 && fd == _tcp_conn_fd; }
+#endif
 #ifdef __PX4_POSIX
 	struct sockaddr_in 	*get_client_source_address() { return &_src_addr; }
 
@@ -465,6 +508,11 @@ private:
 	bool			_task_running;
 	static bool		_boot_complete;
 	static const unsigned MAVLINK_MAX_INSTANCES = 4;
+#ifdef __PX4_LINUX
+	static const unsigned NETWORK_BATCH_SIZE = 16;	///< UDP packets sent with a single sendmmsg()
+#else
+	static const unsigned NETWORK_BATCH_SIZE = 1;
+#endif
 	mavlink_message_t _mavlink_buffer;
 	mavlink_status_t _mavlink_status;
 
@@ -481,6 +529,8 @@ private:
 
 	MavlinkOrbSubscription	*_subscriptions;
 	MavlinkStream		*_streams;
+	MavlinkStreamScheduler	_stream_scheduler;
+	hrt_abstime		_next_rate_mult_update;
 
 	MavlinkShell			*_mavlink_shell;
 	MavlinkULog			*_mavlink_ulog;
@@ -531,6 +581,8 @@ private:
 	unsigned		_bytes_tx;
 	unsigned		_bytes_txerr;
 	unsigned		_bytes_rx;
+	unsigned		_tx_message_count;
+	unsigned		_tx_byte_count;
 	uint64_t		_bytes_timestamp;
 	float			_rate_tx;
 	float			_rate_txerr;
@@ -544,8 +596,20 @@ private:
 	bool _broadcast_address_found;
 	bool _broadcast_address_not_found_warned;
 	bool _broadcast_failed_warned;
-	uint8_t _network_buf[MAVLINK_MAX_PACKET_LEN];
-	unsigned _network_buf_len;
+	uint8_t _network_buf[NETWORK_BATCH_SIZE][MAVLINK_MAX_PACKET_LEN];
+	unsigned _network_buf_len[NETWORK_BATCH_SIZE];
+	unsigned _network_batch_count;			///< number of finished packets in _network_buf
+#ifdef __PX4_LINUX
+	struct mmsghdr _network_msgs[2 * NETWORK_BATCH_SIZE];	///< unicast plus broadcast copy of each packet
+	struct iovec _network_iov[NETWORK_BATCH_SIZE];
+#endif
+	bool _tcp_client;				///< connect to the partner instead of listening
+	int _tcp_listen_fd;
+	int _tcp_conn_fd;
+	hrt_abstime _tcp_last_connect_attempt;
+	uint8_t _tcp_pending[MAVLINK_MAX_PACKET_LEN];	///< unsent tail of a partially written packet
+	unsigned _tcp_pending_len;
+	unsigned _tcp_pending_offset;
 #endif
 	int _socket_fd;
 	Protocol	_protocol;
@@ -554,16 +618,14 @@ private:
 
 	struct telemetry_status_s	_rstatus;			///< receive status
 
-	struct mavlink_message_buffer {
-		int write_ptr;
-		int read_ptr;
-		int size;
-		char *data;
-	};
-
-	mavlink_message_buffer	_message_buffer;
-
-	pthread_mutex_t		_message_buffer_mutex;
+	/**
+	 * Frames forwarded to this instance, one ring per source instance (indexed by its instance id),
+	 * so each ring has exactly one producer (the receiver thread of the source) and one consumer (the
+	 * main loop of this instance). Allocated by the producer on the first forwarded frame.
+	 */
+	MavlinkFrameRing	*_forward_rings[MAVLINK_COMM_NUM_BUFFERS];
+	unsigned		_forward_count;		///< frames sent out from the forwarding rings
+	unsigned		_forward_drop_count;	///< frames dropped because a ring was full
 	pthread_mutex_t		_send_mutex;
 
 	bool			_param_initialized;
@@ -605,28 +667,53 @@ private:
 	 */
 	void adjust_stream_rates(const float multiplier);
 
-	int message_buffer_init(int size);
+	/**
+	 * Queue an encoded frame from another instance for sending. Called from the receiver thread of
+	 * the source instance.
+	 */
+	void pass_frame(const uint8_t *frame, unsigned len, Mavlink *source);
 
-	void message_buffer_destroy();
+	/**
+	 * Send all frames queued by other instances. Called from the main loop.
+	 */
+	void send_forwarded_frames();
 
-	int message_buffer_count();
+	/**
+	 * Update rate mult so total bitrate will be equal to _datarate.
+	 */
+	void update_rate_mult();
 
-	int message_buffer_is_empty();
+	void find_broadcast_address();
 
-	int message_buffer_get_ptr(void **ptr, bool *is_part);
+	void init_udp();
 
-	void message_buffer_mark_read(int n);
+	void init_tcp();
 
-	void pass_message(const mavlink_message_t *msg);
+#ifdef __PX4_POSIX
+	/**
+	 * Send the batched packets. Must be called with _send_mutex held.
+	 */
+	void flush_network_batch();
 
 	/**
-	 * Update rate mult so total bitrate will be equal to _datarate.
+	 * @return true if packets should also go to the broadcast address because no partner is known
 	 */
-	void update_rate_mult();
+	bool broadcast_needed();
 
-	void find_broadcast_address();
+	/**
+	 * Write a packet to the TCP stream without blocking. Must be called with _send_mutex held.
+	 *
+	 * @return the number of bytes of buf accepted, or -1 if the packet had to be dropped
+	 */
+	int tcp_send(const uint8_t *buf, unsigned len);
 
-	void init_udp();
+	/**
+	 * Try to send the rest of a partially written packet. Must be called with _send_mutex held.
+	 *
+	 * @return true if nothing is pending anymore
+	 */
+	bool tcp_flush_pending();
+#endif
 
 	/**
 	 * Main mavlink task.
@@ -437,7 +437,6 @@ public:
 
 private:
 	MavlinkOrbSubscription *_cmd_sub;
-	uint64_t _cmd_time;
 
 	/* do not allow top copying this class */
 	MavlinkStreamCommandLong(MavlinkStreamCommandLong &);
@@ -445,15 +444,17 @@ private:
 
 protected:
 	explicit MavlinkStreamCommandLong(Mavlink *mavlink) : MavlinkStream(mavlink),
-		_cmd_sub(_mavlink->add_orb_subscription(ORB_ID(vehicle_command))),
-		_cmd_time(0)
+		_cmd_sub(_mavlink->add_orb_subscription(ORB_ID(vehicle_command)))
 	{}
 
 	void send(const hrt_abstime t)
 	{
-		struct vehicle_command_s cmd;
+		/* forward every queued command, not just the most recent one */
+		struct vehicle_command_s cmds[vehicle_command_s::ORB_QUEUE_LENGTH];
+		unsigned num_cmds = _cmd_sub->update_batch(cmds, vehicle_command_s::ORB_QUEUE_LENGTH);
 
-		if (_cmd_sub->update(&_cmd_time, &cmd)) {
+		for (unsigned i = 0; i < num_cmds; i++) {
+			const struct vehicle_command_s &cmd = cmds[i];
 
 			/* only send commands for other systems/components, don't forward broadcast commands */
 			if ((cmd.target_system != mavlink_system.sysid || cmd.target_component != mavlink_system.compid) &&
@@ -234,7 +234,7 @@ MavlinkMissionManager::send_mission_item(uint8_t sysid, uint8_t compid, uint16_t
 	dm_item_t dm_item = DM_KEY_WAYPOINTS_OFFBOARD(_dataman_id);
 	struct mission_item_s mission_item;
 
-	if (dm_read(dm_item, seq, &mission_item, sizeof(struct mission_item_s)) == sizeof(struct mission_item_s)) {
+	if (_item_reader.read(dm_item, seq, _count, &mission_item)) {
 		_time_last_sent = hrt_absolute_time();
 
 		if (_int_mode) {
@@ -553,6 +553,7 @@ MavlinkMissionManager::handle_mission_request_list(const mavlink_message_t *msg)
 			_state = MAVLINK_WPM_STATE_SENDLIST;
 			_transfer_seq = 0;
 			_transfer_count = _count;
+			_item_reader.reset();	// the items may have changed since the last download
 			_transfer_partner_sysid = msg->sysid;
 			_transfer_partner_compid = msg->compid;
 
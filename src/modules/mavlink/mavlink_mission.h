@@ -42,6 +42,7 @@
 
 #pragma once
 
+#include <dataman/dataman.h>
 #include <uORB/uORB.h>
 
 #include "mavlink_bridge_header.h"
@@ -111,6 +112,7 @@ private:
 
 	static int		_last_reached;				///< Last reached waypoint in active mission (-1 means nothing reached)
 
+	DatamanChunkReader<mission_item_s> _item_reader;		///< items read ahead for the current download
 	int			_transfer_dataman_id;			///< Dataman storage ID for current transmission
 	unsigned		_transfer_count;			///< Items count in current transmission
 	unsigned		_transfer_seq;				///< Item sequence in current transmission
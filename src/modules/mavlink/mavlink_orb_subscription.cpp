@@ -152,6 +152,22 @@ MavlinkOrbSubscription::update_if_changed(void *data)
 	return update(data);
 }
 
+unsigned
+MavlinkOrbSubscription::update_batch(void *data, unsigned max_n, uint32_t *lost)
+{
+	if (lost != nullptr) {
+		*lost = 0;
+	}
+
+	if (!is_published()) {
+		return 0;
+	}
+
+	int n = orb_copy_batch(_topic, _fd, data, max_n, lost);
+
+	return n > 0 ? n : 0;
+}
+
 bool
 MavlinkOrbSubscription::is_published()
 {
@@ -79,6 +79,16 @@ public:
 	 */
 	bool update_if_changed(void *data);
 
+	/**
+	 * Copy all samples of a queued topic published since the last copy.
+	 *
+	 * @param data buffer with room for max_n samples, filled oldest first.
+	 * @param lost if not null, set to the number of samples that were
+	 * overwritten in the queue before they could be copied.
+	 * @return number of samples copied, 0 if there were none.
+	 */
+	unsigned update_batch(void *data, unsigned max_n, uint32_t *lost = nullptr);
+
 	/**
 	 * Check if the topic has been published.
 	 *
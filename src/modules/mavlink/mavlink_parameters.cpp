@@ -51,6 +51,10 @@
 
 MavlinkParametersManager::MavlinkParametersManager(Mavlink *mavlink) :
 	_send_all_index(-1),
+	_send_changed_index(-1),
+	_sync_hash(0),
+	_sync_value_hashes(nullptr),
+	_sync_count(0),
 	_uavcan_open_request_list(nullptr),
 	_uavcan_waiting_for_request_response(false),
 	_uavcan_queued_request_items(0),
@@ -70,6 +74,8 @@ MavlinkParametersManager::~MavlinkParametersManager()
 	if (_uavcan_parameter_request_pub) {
 		orb_unadvertise(_uavcan_parameter_request_pub);
 	}
+
+	delete[] _sync_value_hashes;
 }
 
 unsigned
@@ -89,6 +95,8 @@ MavlinkParametersManager::handle_message(const mavlink_message_t *msg)
 
 			if (req_list.target_system == mavlink_system.sysid &&
 			    (req_list.target_component == mavlink_system.compid || req_list.target_component == MAV_COMP_ID_ALL)) {
+				_send_changed_index = -1;
+
 				if (_send_all_index < 0) {
 					_send_all_index = PARAM_HASH;
 
@@ -131,9 +139,29 @@ MavlinkParametersManager::handle_message(const mavlink_message_t *msg)
 				/* enforce null termination */
 				name[MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN] = '\0';
 
-				/* Whatever the value is, we're being told to stop sending */
+				/* The GCS tells us which parameter state it has cached */
 				if (strncmp(name, "_HASH_CHECK", sizeof(name)) == 0) {
+					uint32_t gcs_hash;
+					memcpy(&gcs_hash, &set.param_value, sizeof(gcs_hash));
+
 					_send_all_index = -1;
+					_send_changed_index = -1;
+
+					if (_sync_count > 0 && gcs_hash == _sync_hash && _sync_count == param_count_used()) {
+						/* it holds the last synced state: send only what changed since */
+						_send_changed_index = 0;
+
+					} else if (gcs_hash == param_hash_check()) {
+						/* its cache is current, remember it for the next reconnect */
+						if (gcs_hash != _sync_hash || _sync_count == 0) {
+							save_sync_state();
+						}
+
+					} else {
+						/* unknown state, fall back to the full list */
+						_send_all_index = 0;
+					}
+
 					/* No other action taken, return */
 					return;
 				}
@@ -414,27 +442,55 @@ MavlinkParametersManager::send_one()
 			return true;
 		}
 
-		/* look for the first parameter which is used */
-		param_t p;
-
-		do {
-			/* walk through all parameters, including unused ones */
-			p = param_for_index(_send_all_index);
-			_send_all_index++;
-		} while (p != PARAM_INVALID && !param_used(p));
+		/* send the next used parameter */
+		param_t p = param_for_used_index(_send_all_index);
+		_send_all_index++;
 
 		if (p != PARAM_INVALID) {
 			send_param(p);
 		}
 
-		if ((p == PARAM_INVALID) || (_send_all_index >= (int) param_count())) {
+		if ((p == PARAM_INVALID) || (_send_all_index >= (int) param_count_used())) {
 			_send_all_index = -1;
+			save_sync_state();
 			return false;
 
 		} else {
 			return true;
 		}
 
+	} else if (_send_changed_index >= 0 && _mavlink->boot_complete()) {
+		/* send the parameters changed since the last sync */
+
+		if (!space_available) {
+			return false;
+		}
+
+		unsigned count = param_count_used();
+
+		if (count != _sync_count) {
+			/* new parameters shifted the used indices, the GCS needs them all */
+			_send_changed_index = -1;
+			_send_all_index = 0;
+			return false;
+		}
+
+		/* skip the parameters still holding their synced value */
+		while ((unsigned)_send_changed_index < count &&
+		       param_value_hash(param_for_used_index(_send_changed_index)) == _sync_value_hashes[_send_changed_index]) {
+			_send_changed_index++;
+		}
+
+		if ((unsigned)_send_changed_index < count) {
+			send_param(param_for_used_index(_send_changed_index));
+			_send_changed_index++;
+			return true;
+		}
+
+		_send_changed_index = -1;
+		save_sync_state();
+		return false;
+
 	} else if (_send_all_index == PARAM_HASH && hrt_absolute_time() > 20 * 1000 * 1000) {
 		/* the boot did not seem to ever complete, warn user and set boot complete */
 		_mavlink->send_statustext_critical("WARNING: SYSTEM BOOT INCOMPLETE. CHECK CONFIG.");
@@ -444,6 +500,22 @@ MavlinkParametersManager::send_one()
 	return false;
 }
 
+void
+MavlinkParametersManager::save_sync_state()
+{
+	unsigned count = param_count_used();
+
+	if (count != _sync_count) {
+		delete[] _sync_value_hashes;
+		_sync_value_hashes = new uint32_t[count];
+		_sync_count = (_sync_value_hashes != nullptr) ? count : 0;
+	}
+
+	if (_sync_count > 0) {
+		_sync_hash = param_hash_check_values(_sync_value_hashes, _sync_count);
+	}
+}
+
 int
 MavlinkParametersManager::send_param(param_t param, int component_id)
 {
@@ -69,6 +69,15 @@ public:
 
 private:
 	int		_send_all_index;
+	int		_send_changed_index;	///< next used index to check in a changed-only sync, -1 if idle
+
+	/*
+	 * Parameter state the GCS last synced to. A GCS reconnecting with this hash
+	 * in a _HASH_CHECK PARAM_SET only gets the values whose hash differs.
+	 */
+	uint32_t	_sync_hash;
+	uint32_t	*_sync_value_hashes;	///< per-value hashes by used index
+	unsigned	_sync_count;		///< entries in _sync_value_hashes, 0 if nothing synced yet
 
 	/* do not allow top copying this class */
 	MavlinkParametersManager(MavlinkParametersManager &);
@@ -81,6 +90,9 @@ protected:
 
 	int send_param(param_t param, int component_id = -1);
 
+	/// remember the current parameter state as the one the GCS holds
+	void save_sync_state();
+
 	// Item of a single-linked list to store requested uavcan parameters
 	struct _uavcan_open_request_list_item {
 		uavcan_parameter_request_s req;
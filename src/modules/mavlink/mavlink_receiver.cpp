@@ -2388,14 +2388,22 @@ MavlinkReceiver::receive_thread(void *arg)
 	const int timeout = 10;
 
 #ifdef __PX4_POSIX
-	/* 1500 is the Wifi MTU, so we make sure to fit a full packet */
-	uint8_t buf[1600 * 5];
+	/* 1500 is the Wifi MTU, so we make sure to fit a full packet into each segment */
+	const unsigned segment_size = 1600;
+	const unsigned max_segments = 5;
+	uint8_t buf[segment_size * max_segments];
 #else
 	/* the serial port buffers internally as well, we just need to fit a small chunk */
-	uint8_t buf[64];
+	const unsigned segment_size = 64;
+	const unsigned max_segments = 1;
+	uint8_t buf[segment_size];
 #endif
 	mavlink_message_t msg;
 
+	/* a read fills buf in one piece, a batched UDP read puts one datagram at the start of each segment */
+	ssize_t segment_len[max_segments] = {};
+	unsigned segment_count = 0;
+
 	struct pollfd fds[1] = {};
 
 	if (_mavlink->get_protocol() == SERIAL) {
@@ -2405,7 +2413,20 @@ MavlinkReceiver::receive_thread(void *arg)
 
 #ifdef __PX4_POSIX
 	struct sockaddr_in srcaddr = {};
+
+#ifdef __PX4_LINUX
+	struct sockaddr_in srcaddrs[max_segments] = {};
+	struct iovec iov[max_segments];
+	struct mmsghdr msgs[max_segments];
+
+	for (unsigned i = 0; i < max_segments; i++) {
+		iov[i].iov_base = &buf[i * segment_size];
+		iov[i].iov_len = segment_size;
+	}
+
+#else
 	socklen_t addrlen = sizeof(srcaddr);
+#endif
 
 	if (_mavlink->get_protocol() == UDP || _mavlink->get_protocol() == TCP) {
 		// make sure mavlink app has booted before we start using the socket
@@ -2422,7 +2443,19 @@ MavlinkReceiver::receive_thread(void *arg)
 	hrt_abstime last_send_update = 0;
 
 	while (!_mavlink->_task_should_exit) {
+#ifdef __PX4_POSIX
+
+		if (_mavlink->get_protocol() == TCP) {
+			/* either the connected stream or the listening socket, poll() skips a negative fd */
+			fds[0].fd = _mavlink->tcp_update_connection();
+		}
+
+#endif
+
 		if (poll(&fds[0], 1, timeout) > 0) {
+			nread = 0;
+			segment_count = 0;
+
 			if (_mavlink->get_protocol() == SERIAL) {
 
 				/*
@@ -2442,11 +2475,42 @@ MavlinkReceiver::receive_thread(void *arg)
 
 			if (_mavlink->get_protocol() == UDP) {
 				if (fds[0].revents & POLLIN) {
+#ifdef __PX4_LINUX
+					/* pick up all queued datagrams (up to one per segment) with a single call */
+					for (unsigned i = 0; i < max_segments; i++) {
+						memset(&msgs[i], 0, sizeof(msgs[i]));
+						msgs[i].msg_hdr.msg_name = &srcaddrs[i];
+						msgs[i].msg_hdr.msg_namelen = sizeof(srcaddrs[i]);
+						msgs[i].msg_hdr.msg_iov = &iov[i];
+						msgs[i].msg_hdr.msg_iovlen = 1;
+					}
+
+					int count = recvmmsg(_mavlink->get_socket_fd(), msgs, max_segments, MSG_DONTWAIT, nullptr);
+
+					for (int i = 0; i < count; i++) {
+						segment_len[i] = msgs[i].msg_len;
+						nread += msgs[i].msg_len;
+					}
+
+					if (count > 0) {
+						segment_count = count;
+						srcaddr = srcaddrs[count - 1];
+					}
+
+#else
 					nread = recvfrom(_mavlink->get_socket_fd(), buf, sizeof(buf), 0, (struct sockaddr *)&srcaddr, &addrlen);
+#endif
 				}
 
-			} else {
-				// could be TCP or other protocol
+			} else if (_mavlink->get_protocol() == TCP) {
+				if (_mavlink->tcp_is_connection(fds[0].fd) && (fds[0].revents & (POLLIN | POLLHUP | POLLERR))) {
+					nread = recv(fds[0].fd, buf, sizeof(buf), MSG_DONTWAIT);
+
+					/* the peer closed the connection or it broke */
+					if (nread == 0 || (nread < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+						_mavlink->tcp_close_connection();
+					}
+				}
 			}
 
 			struct sockaddr_in *srcaddr_last = _mavlink->get_client_source_address();
@@ -2472,34 +2536,44 @@ MavlinkReceiver::receive_thread(void *arg)
 #endif
 			// only start accepting messages once we're sure who we talk to
 
+			if (segment_count == 0) {
+				/* a plain read: everything is in the first segment(s) back to back */
+				segment_len[0] = nread;
+				segment_count = 1;
+			}
+
 			if (_mavlink->get_client_source_initialized()) {
-				/* if read failed, this loop won't execute */
-				for (ssize_t i = 0; i < nread; i++) {
-					if (mavlink_parse_char(_mavlink->get_channel(), buf[i], &msg, &_status)) {
-
-						/* check if we received version 2 and request a switch. */
-						if (!(_mavlink->get_status()->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1)) {
-							/* this will only switch to proto version 2 if allowed in settings */
-							_mavlink->set_proto_version(2);
-						}
+				for (unsigned s = 0; s < segment_count; s++) {
+					const uint8_t *segment = (segment_count > 1) ? &buf[s * segment_size] : buf;
 
-						/* handle generic messages and commands */
-						handle_message(&msg);
+					/* if read failed, this loop won't execute */
+					for (ssize_t i = 0; i < segment_len[s]; i++) {
+						if (mavlink_parse_char(_mavlink->get_channel(), segment[i], &msg, &_status)) {
 
-						/* handle packet with mission manager */
-						_mission_manager.handle_message(&msg);
+							/* check if we received version 2 and request a switch. */
+							if (!(_mavlink->get_status()->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1)) {
+								/* this will only switch to proto version 2 if allowed in settings */
+								_mavlink->set_proto_version(2);
+							}
 
-						/* handle packet with parameter component */
-						_parameters_manager.handle_message(&msg);
+							/* handle generic messages and commands */
+							handle_message(&msg);
 
-						/* handle packet with ftp component */
-						_mavlink_ftp.handle_message(&msg);
+							/* handle packet with mission manager */
+							_mission_manager.handle_message(&msg);
 
-						/* handle packet with log component */
-						_mavlink_log_handler.handle_message(&msg);
+							/* handle packet with parameter component */
+							_parameters_manager.handle_message(&msg);
 
-						/* handle packet with parent object */
-						_mavlink->handle_message(&msg);
+							/* handle packet with ftp component */
+							_mavlink_ftp.handle_message(&msg);
+
+							/* handle packet with log component */
+							_mavlink_log_handler.handle_message(&msg);
+
+							/* handle packet with parent object */
+							_mavlink->handle_message(&msg);
+						}
 					}
 				}
 
@@ -2521,6 +2595,9 @@ MavlinkReceiver::receive_thread(void *arg)
 			last_send_update = t;
 		}
 
+		/* do not keep replies batched until the main loop runs */
+		_mavlink->send_flush();
+
 	}
 
 	return nullptr;
@@ -47,7 +47,11 @@ MavlinkStream::MavlinkStream(Mavlink *mavlink) :
 	next(nullptr),
 	_mavlink(mavlink),
 	_interval(1000000),
-	_last_sent(0 /* 0 means unlimited - updates on every iteration */)
+	_last_sent(0 /* 0 means unlimited - updates on every iteration */),
+	_msg_count(0),
+	_byte_count(0),
+	_achieved_rate(0.0f),
+	_achieved_bandwidth(0.0f)
 {
 }
 
@@ -77,9 +81,7 @@ MavlinkStream::update(const hrt_abstime t)
 		// initial timestamp which will help spacing them out
 		// on the link scheduling
 		_last_sent = hrt_absolute_time();
-#ifndef __PX4_QURT
-		send(t);
-#endif
+		send_counted(t);
 		return 0;
 	}
 
@@ -90,11 +92,7 @@ MavlinkStream::update(const hrt_abstime t)
 	}
 
 	int64_t dt = t - _last_sent;
-	int interval = _interval;
-
-	if (!const_rate()) {
-		interval /= _mavlink->get_rate_mult();
-	}
+	int interval = get_scaled_interval();
 
 	// send the message if it is due or
 	// if it will overrun the next scheduled send interval
@@ -106,11 +104,9 @@ MavlinkStream::update(const hrt_abstime t)
 	// This method is not theoretically optimal but a suitable
 	// stopgap as it hits its deadlines well (0.5 Hz, 50 Hz and 250 Hz)
 
-	if (dt > (interval - (_mavlink->get_main_loop_delay() / 10) * 4)) {
+	if (dt > interval - get_send_tolerance()) {
 		// interval expired, send message
-#ifndef __PX4_QURT
-		send(t);
-#endif
+		send_counted(t);
 		// if the interval is non-zero do not use the actual time but
 		// increment at a fixed rate, so that processing delays do not
 		// distort the average rate
@@ -121,3 +117,61 @@ MavlinkStream::update(const hrt_abstime t)
 
 	return -1;
 }
+
+hrt_abstime
+MavlinkStream::get_deadline()
+{
+	if (_last_sent == 0) {
+		return 0;
+	}
+
+	// the first time at which update() sees dt > interval - tolerance
+	int64_t wait = get_scaled_interval() - get_send_tolerance() + 1;
+
+	return (wait > 0) ? _last_sent + wait : _last_sent;
+}
+
+void
+MavlinkStream::update_rate_stats(float dt)
+{
+	if (dt > 0.0f) {
+		_achieved_rate = _msg_count / dt;
+		_achieved_bandwidth = _byte_count / dt;
+	}
+
+	_msg_count = 0;
+	_byte_count = 0;
+}
+
+void
+MavlinkStream::send_counted(const hrt_abstime t)
+{
+#ifndef __PX4_QURT
+	const unsigned msgs_before = _mavlink->get_tx_message_count();
+	const unsigned bytes_before = _mavlink->get_tx_byte_count();
+
+	send(t);
+
+	// streams only send if they have new data, so count what actually went out
+	_msg_count += _mavlink->get_tx_message_count() - msgs_before;
+	_byte_count += _mavlink->get_tx_byte_count() - bytes_before;
+#endif
+}
+
+int
+MavlinkStream::get_scaled_interval()
+{
+	int interval = _interval;
+
+	if (!const_rate()) {
+		interval /= _mavlink->get_rate_mult();
+	}
+
+	return interval;
+}
+
+int
+MavlinkStream::get_send_tolerance()
+{
+	return (_mavlink->get_main_loop_delay() / 10) * 4;
+}
@@ -72,6 +72,31 @@ public:
 	 * @return 0 if updated / sent, -1 if unchanged
 	 */
 	int update(const hrt_abstime t);
+
+	/**
+	 * Get the earliest time at which update() will send the stream
+	 *
+	 * @return absolute time in us, 0 if the stream is due right away
+	 */
+	hrt_abstime get_deadline();
+
+	/**
+	 * Update the achieved rate statistics, to be called periodically
+	 *
+	 * @param dt time since the last call in seconds
+	 */
+	void update_rate_stats(float dt);
+
+	/**
+	 * @return rate of sent messages in Hz, as measured by update_rate_stats()
+	 */
+	float get_achieved_rate() const { return _achieved_rate; }
+
+	/**
+	 * @return sent bytes per second, as measured by update_rate_stats()
+	 */
+	float get_achieved_bandwidth() const { return _achieved_bandwidth; }
+
 	virtual const char *get_name() const = 0;
 	virtual uint16_t get_id() = 0;
 
@@ -106,6 +131,26 @@ protected:
 private:
 	hrt_abstime _last_sent;
 
+	unsigned _msg_count;		///< messages sent since the last update_rate_stats()
+	unsigned _byte_count;		///< bytes sent since the last update_rate_stats()
+	float _achieved_rate;
+	float _achieved_bandwidth;
+
+	/**
+	 * Call send() and count the messages it sent
+	 */
+	void send_counted(const hrt_abstime t);
+
+	/**
+	 * @return the current interval, scaled by the link rate multiplier
+	 */
+	int get_scaled_interval();
+
+	/**
+	 * @return tolerance in us by which update() sends early
+	 */
+	int get_send_tolerance();
+
 	/* do not allow top copying this class */
 	MavlinkStream(const MavlinkStream &);
 	MavlinkStream &operator=(const MavlinkStream &);
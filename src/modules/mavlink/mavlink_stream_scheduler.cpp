@@ -0,0 +1,256 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_stream_scheduler.cpp
+ * Deadline-ordered scheduling of the MAVLink streams of an instance.
+ */
+
+#include <stdio.h>
+#include <math.h>
+
+#include "mavlink_stream_scheduler.h"
+#include "mavlink_stream.h"
+#include "mavlink_main.h"
+
+MavlinkStreamScheduler::MavlinkStreamScheduler(Mavlink *mavlink) :
+	_mavlink(mavlink),
+	_heap(nullptr),
+	_size(0),
+	_capacity(0),
+	_dirty(true),
+	_rate_mult(1.0f),
+	_budget(0.0f),
+	_budget_time(0),
+	_updates(0),
+	_deferred(0),
+	_stats_time(0),
+	_updates_rate(0.0f),
+	_deferred_rate(0.0f)
+{
+}
+
+MavlinkStreamScheduler::~MavlinkStreamScheduler()
+{
+	delete[] _heap;
+}
+
+void
+MavlinkStreamScheduler::rebuild(const hrt_abstime t)
+{
+	unsigned count = 0;
+	MavlinkStream *stream;
+	LL_FOREACH(_mavlink->get_streams(), stream) {
+		count++;
+	}
+
+	if (count > _capacity) {
+		delete[] _heap;
+		_heap = new Entry[count];
+		_capacity = (_heap != nullptr) ? count : 0;
+	}
+
+	_size = 0;
+
+	LL_FOREACH(_mavlink->get_streams(), stream) {
+		if (_size < _capacity) {
+			_heap[_size].deadline = stream->get_deadline();
+			_heap[_size].stream = stream;
+			_size++;
+		}
+	}
+
+	for (unsigned i = _size / 2; i-- > 0;) {
+		sift_down(i);
+	}
+
+	_rate_mult = _mavlink->get_rate_mult();
+	_dirty = false;
+}
+
+void
+MavlinkStreamScheduler::sift_down(unsigned i)
+{
+	Entry entry = _heap[i];
+
+	while (2 * i + 1 < _size) {
+		unsigned child = 2 * i + 1;
+
+		if (child + 1 < _size && _heap[child + 1].deadline < _heap[child].deadline) {
+			child++;
+		}
+
+		if (entry.deadline <= _heap[child].deadline) {
+			break;
+		}
+
+		_heap[i] = _heap[child];
+		i = child;
+	}
+
+	_heap[i] = entry;
+}
+
+void
+MavlinkStreamScheduler::refill_budget(const hrt_abstime t)
+{
+	if (_mavlink->get_flow_control_enabled()) {
+		// the link pushes back itself, rates are not limited to the data rate
+		_budget = 0.0f;
+		_budget_time = t;
+		return;
+	}
+
+	const float data_rate = _mavlink->get_data_rate();
+
+	if (_budget_time > 0) {
+		_budget += data_rate * (t - _budget_time) / 1e6f;
+	}
+
+	_budget_time = t;
+
+	// allow bursts of two main loop iterations, but at least two maximum size packets
+	const float max_budget = fmaxf(data_rate * 2 * _mavlink->get_main_loop_delay() / 1e6f, 2 * MAVLINK_MAX_PACKET_LEN);
+
+	if (_budget > max_budget) {
+		_budget = max_budget;
+	}
+}
+
+hrt_abstime
+MavlinkStreamScheduler::update(const hrt_abstime t)
+{
+	// a higher rate multiplier moves deadlines forward, so they need to be recomputed
+	if (_dirty || fabsf(_mavlink->get_rate_mult() - _rate_mult) > 0.05f * _rate_mult) {
+		rebuild(t);
+	}
+
+	refill_budget(t);
+
+	const bool limited = !_mavlink->get_flow_control_enabled();
+	bool deferred = false;
+
+	while (_size > 0 && _heap[0].deadline <= t) {
+		MavlinkStream *stream = _heap[0].stream;
+
+		if (limited && _budget <= 0.0f && !stream->const_rate()) {
+			_deferred++;
+			deferred = true;
+			break;
+		}
+
+		update_stream(0, t);
+	}
+
+	hrt_abstime next = (_size > 0) ? _heap[0].deadline : t + 1000000;
+
+	if (deferred) {
+		// the head waits for the budget, but due const rate streams further down are sent anyway
+		hrt_abstime next_const_rate = update_const_rate(t);
+
+		// wake up when the budget is positive again, not at the deadline of the head which has passed
+		const float data_rate = _mavlink->get_data_rate();
+		hrt_abstime refill = t + 1000000;
+
+		if (data_rate > 0.0f) {
+			refill = t + (hrt_abstime)(-_budget / data_rate * 1e6f) + 1;
+		}
+
+		next = (next_const_rate < refill) ? next_const_rate : refill;
+	}
+
+	if (t > _stats_time + 1000000) {
+		if (_stats_time != 0) {
+			float dt = (t - _stats_time) / 1e6f;
+			_updates_rate = _updates / dt;
+			_deferred_rate = _deferred / dt;
+		}
+
+		_updates = 0;
+		_deferred = 0;
+		_stats_time = t;
+	}
+
+	return next;
+}
+
+void
+MavlinkStreamScheduler::update_stream(unsigned i, const hrt_abstime t)
+{
+	MavlinkStream *stream = _heap[i].stream;
+	const unsigned bytes_before = _mavlink->get_tx_byte_count();
+
+	stream->update(t);
+	_updates++;
+
+	if (!_mavlink->get_flow_control_enabled()) {
+		_budget -= _mavlink->get_tx_byte_count() - bytes_before;
+	}
+
+	// the stream moves back in the heap according to its new deadline
+	hrt_abstime deadline = stream->get_deadline();
+	_heap[i].deadline = (deadline > t) ? deadline : t + 1;
+	sift_down(i);
+}
+
+hrt_abstime
+MavlinkStreamScheduler::update_const_rate(const hrt_abstime t)
+{
+	hrt_abstime next = t + 1000000;
+	unsigned i = 0;
+
+	while (i < _size) {
+		if (_heap[i].stream->const_rate()) {
+			if (_heap[i].deadline <= t) {
+				// sift_down() only moves entries below i, so i is checked again with its new entry
+				update_stream(i, t);
+				continue;
+			}
+
+			if (_heap[i].deadline < next) {
+				next = _heap[i].deadline;
+			}
+		}
+
+		i++;
+	}
+
+	return next;
+}
+
+void
+MavlinkStreamScheduler::print_status()
+{
+	printf("\tstream scheduler: %u streams, %.1f updates/s, %.1f deferred/s\n", _size, (double)_updates_rate,
+	       (double)_deferred_rate);
+}
@@ -0,0 +1,122 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2017 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file mavlink_stream_scheduler.h
+ * Deadline-ordered scheduling of the MAVLink streams of an instance.
+ */
+
+#ifndef MAVLINK_STREAM_SCHEDULER_H_
+#define MAVLINK_STREAM_SCHEDULER_H_
+
+#include <drivers/drv_hrt.h>
+
+class Mavlink;
+class MavlinkStream;
+
+/**
+ * Keeps the streams of a Mavlink instance in a min-heap ordered by their next deadline, so that
+ * each main loop iteration only touches the streams that are due, and the main loop knows how long
+ * it can sleep.
+ *
+ * If the link has no flow control, the streams get a byte budget that is refilled at the link data
+ * rate. Due streams that exceed the budget are deferred to a later iteration (const rate streams
+ * are always sent).
+ */
+class MavlinkStreamScheduler
+{
+public:
+	MavlinkStreamScheduler(Mavlink *mavlink);
+	~MavlinkStreamScheduler();
+
+	/**
+	 * Mark the schedule as outdated. Must be called when a stream is added, removed or changes its
+	 * interval. The heap is rebuilt in the next update().
+	 */
+	void invalidate() { _dirty = true; }
+
+	/**
+	 * Update all streams that are due
+	 *
+	 * @param t current time
+	 * @return time of the next deadline, or when the byte budget allows the next stream
+	 */
+	hrt_abstime update(const hrt_abstime t);
+
+	/**
+	 * Print scheduler statistics
+	 */
+	void print_status();
+
+private:
+	struct Entry {
+		hrt_abstime deadline;
+		MavlinkStream *stream;
+	};
+
+	Mavlink *_mavlink;
+
+	Entry *_heap;
+	unsigned _size;
+	unsigned _capacity;
+	bool _dirty;
+	float _rate_mult;		///< link rate multiplier at the time the deadlines were computed
+
+	float _budget;			///< bytes the streams may send
+	hrt_abstime _budget_time;	///< last budget refill
+
+	unsigned _updates;		///< stream updates since the last statistics output
+	unsigned _deferred;		///< deferred stream updates because of the byte budget
+	hrt_abstime _stats_time;
+	float _updates_rate;
+	float _deferred_rate;
+
+	void rebuild(const hrt_abstime t);
+	void sift_down(unsigned i);
+	void refill_budget(const hrt_abstime t);
+	void update_stream(unsigned i, const hrt_abstime t);
+
+	/**
+	 * Update the due const rate streams anywhere in the heap
+	 *
+	 * @return earliest deadline of the const rate streams
+	 */
+	hrt_abstime update_const_rate(const hrt_abstime t);
+
+	/* do not allow copying this class */
+	MavlinkStreamScheduler(const MavlinkStreamScheduler &);
+	MavlinkStreamScheduler &operator=(const MavlinkStreamScheduler &);
+};
+
+
+#endif /* MAVLINK_STREAM_SCHEDULER_H_ */
@@ -61,6 +61,17 @@ public:
 
 	static void receive_message_handler_burst(const mavlink_file_transfer_protocol_t *ftp_req, void *worker_data);
 
+	/// Worker data for windowed stream handler
+	struct WindowedInfo {
+		MavlinkFtpTest		*ftp_test_class;
+		unsigned		packet_count;		///< data packets received
+		uint32_t		offsets[8];		///< offsets of the first data packets, in order
+		bool			eof;			///< Nak EOF received
+		uint8_t			*file_bytes;		///< reassembled file
+	};
+
+	static void receive_message_handler_windowed(const mavlink_file_transfer_protocol_t *ftp_req, void *worker_data);
+
 	static const uint8_t serverSystemId = 50;	///< System ID for server
 	static const uint8_t serverComponentId = 1;	///< Component ID for server
 	static const uint8_t serverChannel = 0;		///< Channel to send to
@@ -87,6 +98,8 @@ private:
 	bool _read_test(void);
 	bool _read_badsession_test(void);
 	bool _burst_test(void);
+	bool _burst_windowed_test(void);
+	bool _open_sessions_test(void);
 	bool _removedirectory_test(void);
 	bool _createdirectory_test(void);
 	bool _removefile_test(void);
@@ -121,6 +134,8 @@ private:
 	};
 
 	bool _receive_message_handler_burst(const mavlink_file_transfer_protocol_t *ftp_req, BurstInfo *burst_info);
+	bool _receive_message_handler_windowed(const mavlink_file_transfer_protocol_t *ftp_req, WindowedInfo *windowed_info);
+	bool _create_microsd_file(unsigned length);
 
 	MavlinkFTP	*_ftp_server;
 	uint16_t	_expected_seq_number;
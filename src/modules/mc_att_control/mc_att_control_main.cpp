@@ -185,6 +185,9 @@ private:
 
 	perf_counter_t	_loop_perf;			/**< loop performance counter */
 	perf_counter_t	_controller_latency_perf;
+	perf_counter_t	_params_perf;			/**< parameter reload performance counter */
+
+	uint32_t	_params_generation;		/**< parameter generation of the last reload */
 
 	math::Vector<3>		_rates_prev;	/**< angular rates on previous step */
 	math::Vector<3>		_rates_sp_prev; /**< previous rates setpoint */
@@ -260,6 +263,8 @@ private:
 
 		param_t board_offset[3];
 
+		param_t cbrk_rate_ctrl;
+
 	}		_params_handles;		/**< handles for interesting parameters */
 
 	struct {
@@ -448,6 +453,8 @@ MulticopterAttitudeControl::MulticopterAttitudeControl() :
 	/* performance counters */
 	_loop_perf(perf_alloc(PC_ELAPSED, "mc_att_control")),
 	_controller_latency_perf(perf_alloc_once(PC_ELAPSED, "ctrl_latency")),
+	_params_perf(perf_alloc(PC_ELAPSED, "mc_att_control params")),
+	_params_generation(0),
 	_ts_opt_recovery(nullptr)
 
 {
@@ -539,6 +546,9 @@ MulticopterAttitudeControl::MulticopterAttitudeControl() :
 	_params_handles.board_offset[1] = param_find("SENS_BOARD_Y_OFF");
 	_params_handles.board_offset[2] = param_find("SENS_BOARD_Z_OFF");
 
+	/* only used to notice changes, circuit_breaker_enabled() reads it by name */
+	_params_handles.cbrk_rate_ctrl = param_find("CBRK_RATE_CTRL");
+
 
 
 	/* fetch initial parameter values */
@@ -612,6 +622,9 @@ MulticopterAttitudeControl::parameters_update()
 
 	float roll_tc, pitch_tc;
 
+	perf_begin(_params_perf);
+	_params_generation = param_generation();
+
 	param_get(_params_handles.roll_tc, &roll_tc);
 	param_get(_params_handles.pitch_tc, &pitch_tc);
 
@@ -713,6 +726,8 @@ MulticopterAttitudeControl::parameters_update()
 	param_get(_params_handles.board_offset[1], &(_params.board_offset[1]));
 	param_get(_params_handles.board_offset[2], &(_params.board_offset[2]));
 
+	perf_end(_params_perf);
+
 	return OK;
 }
 
@@ -727,7 +742,14 @@ MulticopterAttitudeControl::parameter_update_poll()
 	if (updated) {
 		struct parameter_update_s param_update;
 		orb_copy(ORB_ID(parameter_update), _params_sub, &param_update);
-		parameters_update();
+
+		/* skip the reload if none of our parameters changed */
+		static_assert(sizeof(_params_handles) % sizeof(param_t) == 0, "_params_handles must only hold param_t handles");
+
+		if (param_changed_since((const param_t *)&_params_handles, sizeof(_params_handles) / sizeof(param_t),
+					_params_generation, nullptr) > 0) {
+			parameters_update();
+		}
 	}
 }
 
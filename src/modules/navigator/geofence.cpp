@@ -41,10 +41,12 @@
 #include "navigator.h"
 
 #include <ctype.h>
+#include <float.h>
 
 #include <dataman/dataman.h>
 #include <drivers/drv_hrt.h>
 #include <geo/geo.h>
+#include <mathlib/mathlib.h>
 #include <systemlib/mavlink_log.h>
 
 #define GEOFENCE_RANGE_WARNING_LIMIT 5000000
@@ -59,9 +61,18 @@ Geofence::Geofence(Navigator *navigator) :
 	_param_max_hor_distance(this, "GF_MAX_HOR_DIST", false),
 	_param_max_ver_distance(this, "GF_MAX_VER_DIST", false)
 {
+	/* NULL fence is valid */
+	_cache.valid = true;
+	px4_sem_init(&_cache_lock, 0, 1);
+
 	updateParams();
 }
 
+Geofence::~Geofence()
+{
+	px4_sem_destroy(&_cache_lock);
+}
+
 bool Geofence::inside(const struct vehicle_global_position_s &global_position)
 {
 	return inside(global_position.lat, global_position.lon, global_position.alt);
@@ -161,69 +172,179 @@ bool Geofence::inside(double lat, double lon, float altitude)
 
 bool Geofence::inside_polygon(double lat, double lon, float altitude)
 {
-	if (valid()) {
-		if (!isEmpty()) {
-			/* Vertical check */
-			if (altitude > _altitude_max || altitude < _altitude_min) {
-				return false;
-			}
+	lock();
+	const bool inside_fence = insideCache(lat, lon, altitude);
+	unlock();
 
-			/*Horizontal check */
-			/* Adaptation of algorithm originally presented as
-			 * PNPOLY - Point Inclusion in Polygon Test
-			 * W. Randolph Franklin (WRF) */
+	return inside_fence;
+}
 
-			bool c = false;
+bool Geofence::insideCache(double lat, double lon, float altitude) const
+{
+	if (!_cache.valid || _cache.polygon_count == 0) {
+		/* Empty or invalid fence --> accept all points */
+		return true;
+	}
 
-			struct fence_vertex_s temp_vertex_i;
-			struct fence_vertex_s temp_vertex_j;
+	/* Vertical check */
+	if (altitude > _cache.altitude_max || altitude < _cache.altitude_min) {
+		return false;
+	}
 
-			/* Red until fence is finished */
-			for (unsigned i = 0, j = _vertices_count - 1; i < _vertices_count; j = i++) {
-				if (dm_read(DM_KEY_FENCE_POINTS, i, &temp_vertex_i, sizeof(struct fence_vertex_s)) != sizeof(struct fence_vertex_s)) {
-					break;
-				}
+	/* Horizontal check against the cached polygons: inside one of the
+	 * inclusion polygons, if there are any, and outside all exclusion ones */
+	float x, y;
+	map_projection_project(&_cache.projection_reference, lat, lon, &x, &y);
 
-				if (dm_read(DM_KEY_FENCE_POINTS, j, &temp_vertex_j, sizeof(struct fence_vertex_s)) != sizeof(struct fence_vertex_s)) {
-					break;
-				}
+	bool inside_inclusion = !_cache.has_inclusion;
 
-				// skip vertex 0 (return point)
-				if (((double)temp_vertex_i.lon >= lon) != ((double)temp_vertex_j.lon >= lon) &&
-				    (lat <= (double)(temp_vertex_j.lat - temp_vertex_i.lat) * (lon - (double)temp_vertex_i.lon) /
-				     (double)(temp_vertex_j.lon - temp_vertex_i.lon) + (double)temp_vertex_i.lat)) {
-					c = !c;
-				}
+	for (int i = 0; i < _cache.polygon_count; i++) {
+		const FencePolygon &polygon = _cache.polygons[i];
+		const bool exclusion = (polygon.type == fence_vertex_s::POLYGON_EXCLUSION);
 
-			}
+		if (!exclusion && inside_inclusion) {
+			continue;
+		}
 
-			return c;
+		if (insidePolygon(polygon, x, y)) {
+			if (exclusion) {
+				return false;
+			}
 
-		} else {
-			/* Empty fence --> accept all points */
-			return true;
+			inside_inclusion = true;
 		}
+	}
 
-	} else {
-		/* Invalid fence --> accept all points */
-		return true;
+	return inside_inclusion;
+}
+
+bool Geofence::insidePolygon(const FencePolygon &polygon, float x, float y) const
+{
+	/* bounding box rejection */
+	if (x < polygon.min_x || x > polygon.max_x || y < polygon.min_y || y > polygon.max_y) {
+		return false;
 	}
+
+	/* Adaptation of algorithm originally presented as
+	 * PNPOLY - Point Inclusion in Polygon Test
+	 * W. Randolph Franklin (WRF) */
+
+	bool c = false;
+
+	for (int i = polygon.first_edge; i < polygon.first_edge + polygon.edge_count; i++) {
+		const FenceEdge &edge = _cache.edges[i];
+
+		if ((edge.y1 >= y) != (edge.y0 >= y) &&
+		    (x <= (edge.x0 - edge.x1) * (y - edge.y1) / (edge.y0 - edge.y1) + edge.x1)) {
+			c = !c;
+		}
+	}
+
+	return c;
 }
 
 bool
 Geofence::valid()
 {
+	lock();
+	const bool fence_valid = _cache.valid;
+	unlock();
+
+	return fence_valid;
+}
+
+void
+Geofence::updateFence()
+{
+	/* the checks keep using the old cache until the new one is complete */
+	FenceCache cache {};
+	cache.valid = buildCache(cache);
+
+	lock();
+	_cache = cache;
+	unlock();
+}
+
+bool
+Geofence::buildCache(FenceCache &cache)
+{
+	cache.altitude_min = _altitude_min;
+	cache.altitude_max = _altitude_max;
+
 	// NULL fence is valid
 	if (isEmpty()) {
 		return true;
 	}
 
-	// Otherwise
 	if ((_vertices_count < 4) || (_vertices_count > fence_s::GEOFENCE_MAX_VERTICES)) {
 		warnx("Fence must have at least 3 sides and not more than %d", fence_s::GEOFENCE_MAX_VERTICES - 1);
 		return false;
 	}
 
+	struct fence_vertex_s vertices[fence_s::GEOFENCE_MAX_VERTICES];
+	double lat_sum = 0.0;
+	double lon_sum = 0.0;
+
+	ssize_t vertices_read = dm_read_range(DM_KEY_FENCE_POINTS, 0, _vertices_count, vertices, sizeof(struct fence_vertex_s));
+
+	if (vertices_read != (ssize_t)_vertices_count) {
+		warnx("Fence point %d could not be read", (int)vertices_read);
+		return false;
+	}
+
+	for (unsigned i = 0; i < _vertices_count; i++) {
+		lat_sum += (double)vertices[i].lat;
+		lon_sum += (double)vertices[i].lon;
+	}
+
+	/* project all vertices once into a local frame centered on the fence */
+	map_projection_init(&cache.projection_reference, lat_sum / _vertices_count, lon_sum / _vertices_count);
+
+	unsigned first = 0;
+
+	while (first < _vertices_count) {
+		unsigned end = first + 1;
+
+		while (end < _vertices_count && vertices[end].polygon == vertices[first].polygon) {
+			end++;
+		}
+
+		if (cache.polygon_count >= GEOFENCE_MAX_POLYGONS) {
+			warnx("Fence must not have more than %d polygons", GEOFENCE_MAX_POLYGONS);
+			return false;
+		}
+
+		if (end - first < 3) {
+			warnx("Fence polygon %d must have at least 3 sides", vertices[first].polygon);
+			return false;
+		}
+
+		FencePolygon &polygon = cache.polygons[cache.polygon_count++];
+		polygon.type = vertices[first].polygon_type;
+		polygon.first_edge = first;
+		polygon.edge_count = end - first;
+		polygon.min_x = polygon.min_y = FLT_MAX;
+		polygon.max_x = polygon.max_y = -FLT_MAX;
+
+		/* edge i runs from the previous vertex to vertex i, closing the polygon */
+		for (unsigned i = first, j = end - 1; i < end; j = i++) {
+			FenceEdge &edge = cache.edges[i];
+			map_projection_project(&cache.projection_reference, vertices[j].lat, vertices[j].lon, &edge.x0, &edge.y0);
+			map_projection_project(&cache.projection_reference, vertices[i].lat, vertices[i].lon, &edge.x1, &edge.y1);
+
+			polygon.min_x = math::min(polygon.min_x, edge.x1);
+			polygon.max_x = math::max(polygon.max_x, edge.x1);
+			polygon.min_y = math::min(polygon.min_y, edge.y1);
+			polygon.max_y = math::max(polygon.max_y, edge.y1);
+		}
+
+		if (polygon.type != fence_vertex_s::POLYGON_EXCLUSION) {
+			cache.has_inclusion = true;
+		}
+
+		first = end;
+	}
+
 	return true;
 }
 
@@ -236,7 +357,7 @@ Geofence::addPoint(int argc, char *argv[])
 	char *end;
 
 	if ((argc == 1) && (strcmp("-clear", argv[0]) == 0)) {
-		dm_clear(DM_KEY_FENCE_POINTS);
+		clearDm();
 		publishFence(0);
 		return;
 	}
@@ -262,9 +383,13 @@ Geofence::addPoint(int argc, char *argv[])
 
 	vertex.lat = (float)lat;
 	vertex.lon = (float)lon;
+	vertex.polygon = 0;
+	vertex.polygon_type = fence_vertex_s::POLYGON_INCLUSION;
 
 	if (dm_write(DM_KEY_FENCE_POINTS, ix, DM_PERSIST_POWER_ON_RESET, &vertex, sizeof(vertex)) == sizeof(vertex)) {
 		if (last) {
+			_vertices_count = (unsigned)ix + 1;
+			updateFence();
 			publishFence((unsigned)ix + 1);
 		}
 
@@ -291,6 +416,9 @@ Geofence::loadFromFile(const char *filename)
 	FILE		*fp;
 	char		line[120];
 	int			pointCounter = 0;
+	int			polygonStart = 0;
+	uint8_t		polygonIndex = 0;
+	uint8_t		polygonType = fence_vertex_s::POLYGON_INCLUSION;
 	bool		gotVertical = false;
 	const char commentChar = '#';
 	int rc = PX4_ERROR;
@@ -328,8 +456,23 @@ Geofence::loadFromFile(const char *filename)
 		}
 
 		if (gotVertical) {
+			/* INCLUSION or EXCLUSION starts a new polygon of that type */
+			bool inclusion = (strncmp(&line[textStart], "INCLUSION", 9) == 0);
+
+			if (inclusion || strncmp(&line[textStart], "EXCLUSION", 9) == 0) {
+				if (pointCounter > polygonStart) {
+					polygonIndex++;
+					polygonStart = pointCounter;
+				}
+
+				polygonType = inclusion ? fence_vertex_s::POLYGON_INCLUSION : fence_vertex_s::POLYGON_EXCLUSION;
+				continue;
+			}
+
 			/* Parse the line as a geofence point */
 			struct fence_vertex_s vertex;
+			vertex.polygon = polygonIndex;
+			vertex.polygon_type = polygonType;
 
 			/* if the line starts with DMS, this means that the coordinate is given as degree minute second instead of decimal degrees */
 			if (line[textStart] == 'D' && line[textStart + 1] == 'M' && line[textStart + 2] == 'S') {
@@ -376,6 +519,7 @@ Geofence::loadFromFile(const char *filename)
 	/* Check if import was successful */
 	if (gotVertical && pointCounter > 0) {
 		_vertices_count = pointCounter;
+		updateFence();
 		warnx("Geofence: imported successfully");
 		mavlink_log_info(_navigator->get_mavlink_log_pub(), "Geofence imported");
 		rc = PX4_OK;
@@ -393,6 +537,8 @@ error:
 int Geofence::clearDm()
 {
 	dm_clear(DM_KEY_FENCE_POINTS);
+	_vertices_count = 0;
+	updateFence();
 	return PX4_OK;
 }
 
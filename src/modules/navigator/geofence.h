@@ -46,7 +46,9 @@
 #include <controllib/block/BlockParam.hpp>
 #include <controllib/blocks.hpp>
 #include <drivers/drv_hrt.h>
+#include <geo/geo.h>
 #include <px4_defines.h>
+#include <px4_posix.h>
 #include <uORB/topics/fence.h>
 #include <uORB/topics/sensor_combined.h>
 #include <uORB/topics/vehicle_global_position.h>
@@ -62,7 +64,7 @@ public:
 	Geofence(Navigator *navigator);
 	Geofence(const Geofence &) = delete;
 	Geofence &operator=(const Geofence &) = delete;
-	~Geofence() = default;
+	~Geofence();
 
 	/* Altitude mode, corresponding to the param GF_ALTMODE */
 	enum {
@@ -94,6 +96,14 @@ public:
 
 	bool valid();
 
+	/**
+	 * Reload the fence polygons from the dataman into the local cache.
+	 * Has to be called whenever the fence points in the dataman change.
+	 * The cache is built aside and swapped in, so this can be called from
+	 * another thread than the checks.
+	 */
+	void updateFence();
+
 	/**
 	 * Specify fence vertex position.
 	 */
@@ -119,11 +129,43 @@ private:
 	hrt_abstime _last_horizontal_range_warning{0};
 	hrt_abstime _last_vertical_range_warning{0};
 
+	/* fence as stored by addPoint() and loadFromFile(), updateFence() builds the cache from it */
 	float _altitude_min{0.0f};
 	float _altitude_max{0.0f};
 
 	unsigned _vertices_count{0};
 
+	static constexpr int GEOFENCE_MAX_POLYGONS = fence_s::GEOFENCE_MAX_VERTICES / 3;
+
+	/* fence edge in the local frame of the cache [m] */
+	struct FenceEdge {
+		float x0, y0;
+		float x1, y1;
+	};
+
+	/* cached fence polygon, its edges are consecutive in FenceCache::edges */
+	struct FencePolygon {
+		uint8_t type;		/**< fence_vertex_s::POLYGON_INCLUSION or POLYGON_EXCLUSION */
+		uint8_t first_edge;
+		uint8_t edge_count;
+		float min_x, max_x;	/**< bounding box in the local frame [m] */
+		float min_y, max_y;
+	};
+
+	struct FenceCache {
+		struct map_projection_reference_s projection_reference;	/**< local frame of the cached polygons */
+		FenceEdge edges[fence_s::GEOFENCE_MAX_VERTICES];
+		FencePolygon polygons[GEOFENCE_MAX_POLYGONS];
+		int polygon_count;
+		bool has_inclusion;	/**< false if there are only exclusion polygons */
+		bool valid;
+		float altitude_min;
+		float altitude_max;
+	};
+
+	FenceCache _cache {};		/**< only accessed with _cache_lock held */
+	px4_sem_t _cache_lock;
+
 	/* Params */
 	control::BlockParamInt _param_action;
 	control::BlockParamInt _param_altitude_mode;
@@ -137,6 +179,25 @@ private:
 	bool inside(double lat, double lon, float altitude);
 	bool inside(const struct vehicle_global_position_s &global_position);
 	bool inside(const struct vehicle_global_position_s &global_position, float baro_altitude_amsl);
+
+	bool insideCache(double lat, double lon, float altitude) const;
+	bool insidePolygon(const FencePolygon &polygon, float x, float y) const;
+
+	/**
+	 * Build the polygon cache from the fence points in the dataman.
+	 * @return false if the fence is invalid
+	 */
+	bool buildCache(FenceCache &cache);
+
+	void lock()
+	{
+		do {} while (px4_sem_wait(&_cache_lock) != 0);
+	}
+
+	void unlock()
+	{
+		px4_sem_post(&_cache_lock);
+	}
 };
 
 #endif /* GEOFENCE_H_ */
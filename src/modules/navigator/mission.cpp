@@ -263,9 +263,8 @@ Mission::find_offboard_land_start()
 
 	for (size_t i = 0; i < _offboard_mission.count; i++) {
 		struct mission_item_s missionitem;
-		const ssize_t len = sizeof(missionitem);
 
-		if (dm_read(dm_current, i, &missionitem, len) != len) {
+		if (!_item_reader.read(dm_current, i, _offboard_mission.count, &missionitem)) {
 			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 			return -1;
 		}
@@ -282,6 +281,9 @@ void
 Mission::update_onboard_mission()
 {
 	if (orb_copy(ORB_ID(onboard_mission), _navigator->get_onboard_mission_sub(), &_onboard_mission) == OK) {
+		/* the items may have been rewritten */
+		_item_reader.reset();
+
 		/* accept the current index set by the onboard mission if it is within bounds */
 		if (_onboard_mission.current_seq >= 0
 		    && _onboard_mission.current_seq < (int)_onboard_mission.count) {
@@ -329,6 +331,8 @@ Mission::update_offboard_mission()
 	bool failed = true;
 
 	if (orb_copy(ORB_ID(offboard_mission), _navigator->get_offboard_mission_sub(), &_offboard_mission) == OK) {
+		/* the items may have been rewritten */
+		_item_reader.reset();
 
 		/* determine current index */
 		if (_offboard_mission.current_seq >= 0 && _offboard_mission.current_seq < (int)_offboard_mission.count) {
@@ -1237,8 +1241,8 @@ Mission::read_mission_item(bool onboard, int offset, struct mission_item_s *miss
 		/* read mission item to temp storage first to not overwrite current mission item if data damaged */
 		struct mission_item_s mission_item_tmp;
 
-		/* read mission item from datamanager */
-		if (dm_read(dm_item, *mission_index_ptr, &mission_item_tmp, len) != len) {
+		/* read mission item from datamanager, the following items come with the same request */
+		if (!_item_reader.read(dm_item, *mission_index_ptr, mission->count, &mission_item_tmp)) {
 			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 			mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Waypoint could not be read.");
 			return false;
@@ -1264,6 +1268,8 @@ Mission::read_mission_item(bool onboard, int offset, struct mission_item_s *miss
 						return false;
 					}
 
+					_item_reader.update(dm_item, *mission_index_ptr, mission_item_tmp);
+
 					report_do_jump_mission_changed(*mission_index_ptr, mission_item_tmp.do_jump_repeat_count);
 				}
 
@@ -1404,12 +1410,13 @@ Mission::reset_offboard_mission(struct mission_s &mission)
 			/* reset jump counters */
 			if (mission.count > 0) {
 				dm_item_t dm_current = DM_KEY_WAYPOINTS_OFFBOARD(mission.dataman_id);
+				_item_reader.reset();
 
 				for (unsigned index = 0; index < mission.count; index++) {
 					struct mission_item_s item;
 					const ssize_t len = sizeof(struct mission_item_s);
 
-					if (dm_read(dm_current, index, &item, len) != len) {
+					if (!_item_reader.read(dm_current, index, mission.count, &item)) {
 						PX4_WARN("could not read mission item during reset");
 						break;
 					}
@@ -1421,6 +1428,8 @@ Mission::reset_offboard_mission(struct mission_s &mission)
 							PX4_WARN("could not save mission item during reset");
 							break;
 						}
+
+						_item_reader.update(dm_current, index, item);
 					}
 				}
 			}
@@ -260,6 +260,8 @@ private:
 
 	MissionFeasibilityChecker _missionFeasibilityChecker; /**< class that checks if a mission is feasible */
 
+	DatamanChunkReader<mission_item_s> _item_reader; /**< mission items read ahead from the dataman */
+
 	float _min_current_sp_distance_xy{FLT_MAX}; /**< minimum distance which was achieved to the current waypoint  */
 
 	float _distance_current_previous{0.0f}; /**< distance from previous to current sp in pos_sp_triplet,
@@ -74,6 +74,9 @@ MissionFeasibilityChecker::checkMissionFeasible(const mission_s &mission, float
 	const float default_acceptance_rad  = _navigator->get_default_acceptance_radius();
 	const bool landed = _navigator->get_land_detected()->landed;
 
+	/* the mission may have changed since the last check */
+	_item_reader.reset();
+
 	bool failed = false;
 	bool warned = false;
 
@@ -115,9 +118,8 @@ MissionFeasibilityChecker::checkRotarywing(dm_item_t dm_current, size_t nMission
 {
 	for (size_t i = 0; i < nMissionItems; i++) {
 		struct mission_item_s missionitem = {};
-		const ssize_t len = sizeof(struct mission_item_s);
 
-		if (dm_read(dm_current, i, &missionitem, len) != len) {
+		if (!_item_reader.read(dm_current, i, nMissionItems, &missionitem)) {
 			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 			return false;
 		}
@@ -173,9 +175,8 @@ MissionFeasibilityChecker::checkGeofence(dm_item_t dm_current, size_t nMissionIt
 	if (geofence.valid()) {
 		for (size_t i = 0; i < nMissionItems; i++) {
 			struct mission_item_s missionitem = {};
-			const ssize_t len = sizeof(missionitem);
 
-			if (dm_read(dm_current, i, &missionitem, len) != len) {
+			if (!_item_reader.read(dm_current, i, nMissionItems, &missionitem)) {
 				/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 				return false;
 			}
@@ -206,9 +207,8 @@ MissionFeasibilityChecker::checkHomePositionAltitude(dm_item_t dm_current, size_
 	/* Check if all waypoints are above the home altitude */
 	for (size_t i = 0; i < nMissionItems; i++) {
 		struct mission_item_s missionitem = {};
-		const ssize_t len = sizeof(struct mission_item_s);
 
-		if (dm_read(dm_current, i, &missionitem, len) != len) {
+		if (!_item_reader.read(dm_current, i, nMissionItems, &missionitem)) {
 			warning_issued = true;
 			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 			return false;
@@ -256,9 +256,8 @@ MissionFeasibilityChecker::checkMissionItemValidity(dm_item_t dm_current, size_t
 	// do not allow mission if we find unsupported item
 	for (size_t i = 0; i < nMissionItems; i++) {
 		struct mission_item_s missionitem;
-		const ssize_t len = sizeof(struct mission_item_s);
 
-		if (dm_read(dm_current, i, &missionitem, len) != len) {
+		if (!_item_reader.read(dm_current, i, nMissionItems, &missionitem)) {
 			// not supposed to happen unless the datamanager can't access the SD card, etc.
 			mavlink_log_critical(_navigator->get_mavlink_log_pub(), "Mission rejected: Cannot access SD card");
 			return false;
@@ -335,9 +334,8 @@ MissionFeasibilityChecker::checkFixedWingTakeoff(dm_item_t dm_current, size_t nM
 {
 	for (size_t i = 0; i < nMissionItems; i++) {
 		struct mission_item_s missionitem = {};
-		const ssize_t len = sizeof(struct mission_item_s);
 
-		if (dm_read(dm_current, i, &missionitem, len) != len) {
+		if (!_item_reader.read(dm_current, i, nMissionItems, &missionitem)) {
 			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 			return false;
 		}
@@ -384,9 +382,8 @@ MissionFeasibilityChecker::checkFixedWingLanding(dm_item_t dm_current, size_t nM
 
 	for (size_t i = 0; i < nMissionItems; i++) {
 		struct mission_item_s missionitem;
-		const ssize_t len = sizeof(missionitem);
 
-		if (dm_read(dm_current, i, &missionitem, len) != len) {
+		if (!_item_reader.read(dm_current, i, nMissionItems, &missionitem)) {
 			/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 			return false;
 		}
@@ -409,7 +406,7 @@ MissionFeasibilityChecker::checkFixedWingLanding(dm_item_t dm_current, size_t nM
 			if (i > 0) {
 				landing_approach_index = i - 1;
 
-				if (dm_read(dm_current, landing_approach_index, &missionitem_previous, len) != len) {
+				if (!_item_reader.read(dm_current, landing_approach_index, nMissionItems, &missionitem_previous)) {
 					/* not supposed to happen unless the datamanager can't access the SD card, etc. */
 					return false;
 				}
@@ -491,7 +488,7 @@ MissionFeasibilityChecker::check_dist_1wp(dm_item_t dm_current, size_t nMissionI
 
 		/* find first waypoint (with lat/lon) item in datamanager */
 		for (size_t i = 0; i < nMissionItems; i++) {
-			if (dm_read(dm_current, i, &mission_item, sizeof(mission_item_s)) == sizeof(mission_item_s)) {
+			if (_item_reader.read(dm_current, i, nMissionItems, &mission_item)) {
 				if (MissionBlock::item_contains_position(&mission_item)) {
 					/* check only items with valid lat/lon */
 
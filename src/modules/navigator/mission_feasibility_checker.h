@@ -54,6 +54,8 @@ class MissionFeasibilityChecker
 private:
 	Navigator *_navigator{nullptr};
 
+	DatamanChunkReader<mission_item_s> _item_reader;
+
 	/* Checks for all airframes */
 	bool checkGeofence(dm_item_t dm_current, size_t nMissionItems, Geofence &geofence, float home_alt, bool home_valid);
 
@@ -40,6 +40,8 @@ namespace replay
 
 static const char __attribute__((unused)) *ENV_FILENAME = "replay"; ///< name for getenv()
 static const char __attribute__((unused)) *ENV_MODE = "replay_mode";  ///< name for getenv()
+static const char __attribute__((unused)) *ENV_START = "replay_start";  ///< name for getenv()
+static const char __attribute__((unused)) *ENV_END = "replay_end";  ///< name for getenv()
 
 
 } //namespace replay
@@ -136,6 +136,7 @@ protected:
 
 		std::streampos next_read_pos;
 		uint64_t next_timestamp; ///< timestamp of the file
+		std::vector<uint8_t> decoded; ///< sample at next_read_pos, if the log data is compressed
 
 		CompatBase *compat = nullptr;
 
@@ -195,6 +196,14 @@ protected:
 	 */
 	void readTopicDataToBuffer(const Subscription &sub, std::ifstream &replay_file);
 
+	/**
+	 * Read & decode the payload of a compressed data message (after the msg id) into subscription.decoded.
+	 * Deltas are applied to the previously decoded sample.
+	 * @param data_size payload size, including the encoding byte
+	 * @return true on success, false if the message is invalid (file position is after the message)
+	 */
+	bool readCompressedData(std::ifstream &file, Subscription &subscription, uint16_t data_size);
+
 	/**
 	 * Find next data message for this subscription, starting with the stored file offset.
 	 * Skip the first message, and if found, read the timestamp and store the new file offset.
@@ -205,6 +214,21 @@ protected:
 	 */
 	bool nextDataMessage(std::ifstream &file, Subscription &subscription, int msg_id);
 
+	/**
+	 * Read the data message at a file offset into a subscription (like nextDataMessage(), but without
+	 * searching). For compressed logs, the message must not be a delta.
+	 * @return false if there is no valid data message for msg_id at that offset
+	 */
+	bool readDataMessageAt(std::ifstream &file, Subscription &subscription, int msg_id, std::streampos pos);
+
+	/**
+	 * Use the time index to move a subscription forward to the last indexed data message with a
+	 * timestamp <= timestamp. Does nothing if the log has no index or if there is no such message after
+	 * the current position of the subscription.
+	 * File seek position is arbitrary after this call.
+	 */
+	void seekSubscription(std::ifstream &file, Subscription &subscription, int msg_id, uint64_t timestamp);
+
 	std::vector<Subscription> _subscriptions;
 	std::vector<uint8_t> _read_buffer;
 
@@ -220,6 +244,35 @@ private:
 	std::streampos _subscription_file_pos = 0;
 
 	uint64_t _read_until_file_position = 1ULL << 60; ///< read limit if log contains appended data
+	bool _compressed = false; ///< data messages are encoded (@see logger/ulog_compression.h)
+
+	struct IndexEntry {
+		uint64_t timestamp;
+		uint64_t offset;
+	};
+
+	/** time index of a msg_id, read from the end of the file (@see ulog_message_index_header_s) */
+	struct IndexTopic {
+		uint64_t add_logged_offset = 0; ///< 0 if not in the index
+		std::vector<IndexEntry> entries; ///< sorted by timestamp
+	};
+
+	std::vector<IndexTopic> _index; ///< indexed by msg_id, empty if the log has no index
+
+	uint64_t _window_start = 0; ///< skip data before this file timestamp (0 = from the start)
+	uint64_t _window_end = 0; ///< stop at this file timestamp (0 = until the end)
+
+	/**
+	 * Read the time index at the end of the file, if there is one.
+	 * @return true if the log contains an index
+	 */
+	bool readIndex(std::ifstream &file);
+
+	/**
+	 * Add the subscriptions of all topics in the index and seek each to the start of the time window.
+	 * @return file position where handling of additional messages (e.g. parameter changes) should continue
+	 */
+	std::streampos seekToWindowStart(std::ifstream &file);
 
 	bool readFileHeader(std::ifstream &file);
 
@@ -46,6 +46,7 @@
 #include <px4_tasks.h>
 #include <px4_time.h>
 
+#include <algorithm>
 #include <cstring>
 #include <float.h>
 #include <fstream>
@@ -58,6 +59,7 @@
 #include <string>
 
 #include <logger/messages.h>
+#include <logger/ulog_compression.h>
 
 // for ekf2 replay
 #include <uORB/topics/airspeed.h>
@@ -259,7 +261,9 @@ bool Replay::readFlagBits(std::ifstream &file, uint16_t msg_size)
 	bool contains_appended_data = incompat_flags[0] & ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK;
 	bool has_unknown_incompat_bits = false;
 
-	if (incompat_flags[0] & ~0x1) {
+	_compressed = incompat_flags[0] & ULOG_INCOMPAT_FLAG0_DATA_COMPRESSED_MASK;
+
+	if (incompat_flags[0] & ~(ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK | ULOG_INCOMPAT_FLAG0_DATA_COMPRESSED_MASK)) {
 		has_unknown_incompat_bits = true;
 	}
 
@@ -545,6 +549,61 @@ bool Replay::readDropout(std::ifstream &file, uint16_t msg_size)
 	return file.good();
 }
 
+bool Replay::readCompressedData(std::ifstream &file, Subscription &subscription, uint16_t data_size)
+{
+	const size_t size = subscription.orb_meta->o_size_no_padding;
+
+	if (data_size < 1 || data_size > size + 1) {
+		PX4_ERR("data message %s has wrong size %i (expected at most %i). Skipping",
+			subscription.orb_meta->o_name, data_size + 2, (int)size + 3);
+		file.seekg(data_size, ios::cur);
+		return false;
+	}
+
+	_read_buffer.reserve(data_size);
+	uint8_t *message = (uint8_t *)_read_buffer.data();
+	file.read((char *)message, data_size);
+
+	if (!file) {
+		return false;
+	}
+
+	const uint8_t *payload = message + 1;
+	const size_t payload_size = data_size - 1;
+	bool ok = false;
+
+	switch ((px4::logger::ULogDataEncoding)message[0]) {
+	case px4::logger::ULogDataEncoding::RAW:
+		ok = payload_size == size;
+
+		if (ok) {
+			subscription.decoded.resize(size);
+			memcpy(subscription.decoded.data(), payload, size);
+		}
+
+		break;
+
+	case px4::logger::ULogDataEncoding::KEYFRAME:
+		subscription.decoded.resize(size);
+		ok = px4::logger::ulog_decode(payload, payload_size, subscription.decoded.data(), size, false);
+		break;
+
+	case px4::logger::ULogDataEncoding::DELTA:
+		// a delta needs the previous sample (there is always a keyframe at the start of a log)
+		ok = subscription.decoded.size() == size &&
+		     px4::logger::ulog_decode(payload, payload_size, subscription.decoded.data(), size, true);
+		break;
+	}
+
+	if (!ok) {
+		PX4_ERR("failed to decode data message %s (encoding %i). Skipping", subscription.orb_meta->o_name, message[0]);
+		// the next delta cannot be applied either, so wait for a keyframe
+		subscription.decoded.clear();
+	}
+
+	return ok;
+}
+
 bool Replay::nextDataMessage(std::ifstream &file, Subscription &subscription, int msg_id)
 {
 	ulog_message_header_s message_header;
@@ -581,7 +640,15 @@ bool Replay::nextDataMessage(std::ifstream &file, Subscription &subscription, in
 			file.read((char *)&file_msg_id, sizeof(file_msg_id));
 
 			if (file) {
-				if (msg_id == file_msg_id) {
+				if (msg_id == file_msg_id && _compressed) {
+					if (readCompressedData(file, subscription, message_header.msg_size - sizeof(file_msg_id))) {
+						subscription.next_read_pos = cur_pos;
+						memcpy(&subscription.next_timestamp, subscription.decoded.data() + subscription.timestamp_offset,
+						       sizeof(subscription.next_timestamp));
+						done = true;
+					}
+
+				} else if (msg_id == file_msg_id) {
 					if (message_header.msg_size == subscription.orb_meta->o_size_no_padding + 2) {
 						subscription.next_read_pos = cur_pos;
 						file.seekg(subscription.timestamp_offset, ios::cur);
@@ -609,6 +676,8 @@ bool Replay::nextDataMessage(std::ifstream &file, Subscription &subscription, in
 		case (int)ULogMessageType::INFO_MULTIPLE:
 		case (int)ULogMessageType::SYNC:
 		case (int)ULogMessageType::LOGGING:
+		case (int)ULogMessageType::INDEX:
+		case (int)ULogMessageType::INDEX_FOOTER:
 			file.seekg(message_header.msg_size, ios::cur);
 			break;
 
@@ -629,6 +698,197 @@ bool Replay::nextDataMessage(std::ifstream &file, Subscription &subscription, in
 	return file.good();
 }
 
+bool Replay::readDataMessageAt(std::ifstream &file, Subscription &subscription, int msg_id, std::streampos pos)
+{
+	ulog_message_header_s message_header;
+	uint16_t file_msg_id;
+	file.seekg(pos);
+	file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+	file.read((char *)&file_msg_id, sizeof(file_msg_id));
+
+	if (!file || message_header.msg_type != (int)ULogMessageType::DATA || file_msg_id != msg_id) {
+		return false;
+	}
+
+	if (_compressed) {
+		if (file.peek() == (int)px4::logger::ULogDataEncoding::DELTA ||
+		    !readCompressedData(file, subscription, message_header.msg_size - sizeof(file_msg_id))) {
+			return false;
+		}
+
+		memcpy(&subscription.next_timestamp, subscription.decoded.data() + subscription.timestamp_offset,
+		       sizeof(subscription.next_timestamp));
+
+	} else {
+		if (message_header.msg_size != subscription.orb_meta->o_size_no_padding + 2) {
+			return false;
+		}
+
+		file.seekg(subscription.timestamp_offset, ios::cur);
+		file.read((char *)&subscription.next_timestamp, sizeof(subscription.next_timestamp));
+	}
+
+	subscription.next_read_pos = pos;
+	return true;
+}
+
+void Replay::seekSubscription(std::ifstream &file, Subscription &subscription, int msg_id, uint64_t timestamp)
+{
+	if (!subscription.orb_meta || msg_id >= (int)_index.size()) {
+		return;
+	}
+
+	const std::vector<IndexEntry> &entries = _index[msg_id].entries;
+
+	// last entry with a timestamp <= timestamp
+	auto entry = std::upper_bound(entries.begin(), entries.end(), timestamp,
+	[](uint64_t t, const IndexEntry & e) { return t < e.timestamp; });
+
+	if (entry == entries.begin()) {
+		return;
+	}
+
+	--entry;
+
+	if ((streamoff)entry->offset <= (streamoff)subscription.next_read_pos) {
+		return;
+	}
+
+	if (!readDataMessageAt(file, subscription, msg_id, (streamoff)entry->offset)) {
+		PX4_ERR("invalid index entry for %s (offset %" PRIu64 ")", subscription.orb_meta->o_name, entry->offset);
+	}
+}
+
+bool Replay::readIndex(std::ifstream &file)
+{
+	file.clear();
+	file.seekg(0, ios::end);
+	uint64_t end = (uint64_t)(streamoff)file.tellg();
+
+	// the index is at the end of the logged data
+	if (end > _read_until_file_position) {
+		end = _read_until_file_position;
+	}
+
+	ulog_message_index_footer_s footer;
+
+	if (end < sizeof(footer)) {
+		return false;
+	}
+
+	const uint64_t footer_offset = end - sizeof(footer);
+	file.seekg(footer_offset);
+	file.read((char *)&footer, sizeof(footer));
+
+	if (!file || footer.msg_type != (int)ULogMessageType::INDEX_FOOTER ||
+	    memcmp(footer.magic, ULOG_INDEX_FOOTER_MAGIC, sizeof(footer.magic)) != 0 ||
+	    footer.index_offset >= footer_offset) {
+		file.clear();
+		return false;
+	}
+
+	file.seekg(footer.index_offset);
+	const uint16_t index_header_size = sizeof(ulog_message_index_header_s) - ULOG_MSG_HEADER_LEN;
+	size_t num_entries = 0;
+
+	while (file && (uint64_t)(streamoff)file.tellg() < footer_offset) {
+		ulog_message_header_s message_header;
+		file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+
+		if (!file) {
+			break;
+		}
+
+		if (message_header.msg_type != (int)ULogMessageType::INDEX || message_header.msg_size < index_header_size) {
+			// e.g. a dropout
+			file.seekg(message_header.msg_size, ios::cur);
+			continue;
+		}
+
+		uint16_t msg_id;
+		uint64_t add_logged_offset;
+		file.read((char *)&msg_id, sizeof(msg_id));
+		file.read((char *)&add_logged_offset, sizeof(add_logged_offset));
+
+		if (_index.size() <= msg_id) {
+			_index.resize(msg_id + 1);
+		}
+
+		IndexTopic &topic = _index[msg_id];
+		topic.add_logged_offset = add_logged_offset;
+
+		const size_t n = (message_header.msg_size - index_header_size) / sizeof(ulog_index_entry_s);
+		const size_t prev_size = topic.entries.size();
+		topic.entries.resize(prev_size + n);
+
+		for (size_t i = 0; i < n; ++i) {
+			ulog_index_entry_s entry;
+			file.read((char *)&entry, sizeof(entry));
+			topic.entries[prev_size + i].timestamp = entry.timestamp;
+			topic.entries[prev_size + i].offset = entry.offset;
+		}
+
+		num_entries += n;
+		file.seekg((message_header.msg_size - index_header_size) % sizeof(ulog_index_entry_s), ios::cur);
+	}
+
+	if (!file) {
+		PX4_ERR("failed to read the time index, ignoring it");
+		_index.clear();
+		file.clear();
+		return false;
+	}
+
+	PX4_INFO("Log contains a time index (%zu entries)", num_entries);
+
+	// the data section ends where the index starts
+	_read_until_file_position = footer.index_offset;
+	return true;
+}
+
+std::streampos Replay::seekToWindowStart(std::ifstream &file)
+{
+	// add the subscriptions in file order
+	std::vector<std::pair<uint64_t, uint16_t>> add_logged_msgs;
+
+	for (size_t msg_id = 0; msg_id < _index.size(); ++msg_id) {
+		if (_index[msg_id].add_logged_offset > 0) {
+			add_logged_msgs.push_back(std::make_pair(_index[msg_id].add_logged_offset, (uint16_t)msg_id));
+		}
+	}
+
+	std::sort(add_logged_msgs.begin(), add_logged_msgs.end());
+
+	for (const auto &add_logged_msg : add_logged_msgs) {
+		ulog_message_header_s message_header;
+		file.clear();
+		file.seekg((streamoff)add_logged_msg.first);
+		file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+
+		if (!file || message_header.msg_type != (int)ULogMessageType::ADD_LOGGED_MSG) {
+			PX4_ERR("invalid index entry for msg_id %i", add_logged_msg.second);
+			continue;
+		}
+
+		readAndAddSubscription(file, message_header.msg_size);
+	}
+
+	streampos min_read_pos = -1;
+
+	for (size_t msg_id = 0; msg_id < _subscriptions.size(); ++msg_id) {
+		Subscription &sub = _subscriptions[msg_id];
+		file.clear();
+		seekSubscription(file, sub, msg_id, _window_start);
+
+		if (sub.orb_meta && (min_read_pos == (streampos) - 1 || sub.next_read_pos < min_read_pos)) {
+			min_read_pos = sub.next_read_pos;
+		}
+	}
+
+	file.clear();
+	return min_read_pos == (streampos) - 1 ? _data_section_start : min_read_pos;
+}
+
 const orb_metadata *Replay::findTopic(const std::string &name)
 {
 	const orb_metadata **topics = orb_get_topics();
@@ -734,6 +994,19 @@ void Replay::run()
 		return;
 	}
 
+	const char *window_start = getenv(replay::ENV_START);
+	const char *window_end = getenv(replay::ENV_END);
+
+	if (window_start) {
+		_window_start = _file_start_time + (uint64_t)(strtod(window_start, nullptr) * 1e6);
+	}
+
+	if (window_end) {
+		_window_end = _file_start_time + (uint64_t)(strtod(window_end, nullptr) * 1e6);
+	}
+
+	const bool has_index = readIndex(replay_file);
+
 	onEnterMainLoop();
 
 	_replay_start_time = hrt_absolute_time();
@@ -752,11 +1025,24 @@ void Replay::run()
 	}
 
 
+	streampos last_additional_message_pos = _data_section_start;
+
+	if (_window_start > _file_start_time) {
+		if (has_index) {
+			// parameter changes before the start of the window are not applied
+			last_additional_message_pos = seekToWindowStart(replay_file);
+			PX4_INFO("Seeked to %.3lf s", (double)(_window_start - _file_start_time) / 1.e6);
+
+		} else {
+			PX4_INFO("No time index in the log, reading up to %.3lf s", (double)(_window_start - _file_start_time) / 1.e6);
+		}
+	}
+
 	//we update the timestamps from the file by a constant offset to match
-	//the current replay time
-	const uint64_t timestamp_offset = _replay_start_time - _file_start_time;
+	//the current replay time (the start of the time window is published immediately)
+	const uint64_t timestamp_offset = _replay_start_time -
+					  (_window_start > _file_start_time ? _window_start : _file_start_time);
 	uint32_t nr_published_messages = 0;
-	streampos last_additional_message_pos = _data_section_start;
 
 	while (!should_exit() && replay_file) {
 
@@ -782,12 +1068,16 @@ void Replay::run()
 
 		Subscription &sub = _subscriptions[next_msg_id];
 
-		if (next_file_time == 0) {
-			//someone didn't set the timestamp properly. Consider the message invalid
+		if (next_file_time == 0 || next_file_time < _window_start) {
+			//someone didn't set the timestamp properly (consider the message invalid), or before the time window
 			nextDataMessage(replay_file, sub, next_msg_id);
 			continue;
 		}
 
+		if (_window_end > 0 && next_file_time > _window_end) {
+			break;
+		}
+
 
 		//handle additional messages between last and next published data
 		replay_file.seekg(last_additional_message_pos);
@@ -839,6 +1129,12 @@ void Replay::readTopicDataToBuffer(const Subscription &sub, std::ifstream &repla
 	const size_t msg_read_size = sub.orb_meta->o_size_no_padding;
 	const size_t msg_write_size = sub.orb_meta->o_size;
 	_read_buffer.reserve(msg_write_size);
+
+	if (_compressed) {
+		memcpy(_read_buffer.data(), sub.decoded.data(), msg_read_size);
+		return;
+	}
+
 	replay_file.seekg(sub.next_read_pos + (streamoff)(ULOG_MSG_HEADER_LEN + 2)); //skip header & msg id
 	replay_file.read((char *)_read_buffer.data(), msg_read_size);
 }
@@ -1031,6 +1327,8 @@ bool ReplayEkf2::findTimestampAndPublish(uint64_t timestamp, uint16_t msg_id, st
 
 	Subscription &sub = _subscriptions[msg_id];
 
+	seekSubscription(replay_file, sub, msg_id, timestamp * 100);
+
 	while (sub.next_timestamp / 100 < timestamp && sub.orb_meta) {
 		nextDataMessage(replay_file, sub, msg_id);
 	}
@@ -1122,6 +1420,10 @@ the log file to be replayed. The second is the mode, specified via `replay_mode`
 - Generic otherwise: this can be used to replay any module(s), but the replay will be done with the same speed as the
   log was recorded.
 
+Optionally, `replay_start` and `replay_end` select a time window in seconds since the start of the log. If the
+log contains a time index (logger -i), replay seeks directly to the start of the window (parameter changes
+before the window are not applied then). Otherwise the data before the window is read but not published.
+
 The module is typically used together with uORB publisher rules, to specify which messages should be replayed.
 The replay module will just publish all messages that are found in the log. It also applies the parameters from
 the log.
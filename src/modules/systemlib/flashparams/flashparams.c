@@ -49,7 +49,6 @@
 #include <stdint.h>
 
 #include "systemlib/param/param.h"
-#include "systemlib/uthash/utarray.h"
 #include "systemlib/bson/tinybson.h"
 #include "flashparams.h"
 #include "flashfs.h"
@@ -60,20 +59,11 @@
 # define debug(fmt, args...)            do { } while(0)
 #endif
 
-
-/**
- * Storage for modified parameters.
- */
-struct param_wbuf_s {
-	union param_value_u     val;
-	param_t                 param;
-	bool                    unsaved;
-};
+#define PARAM_BIT_TEST(bits, param)	(((bits)[(param) / 32] & (1u << ((param) % 32))) != 0)
 
 static int
 param_export_internal(bool only_unsaved)
 {
-	struct param_wbuf_s *s = NULL;
 	struct bson_encoder_s encoder;
 	int     result = -1;
 
@@ -81,13 +71,13 @@ param_export_internal(bool only_unsaved)
 
 	bson_encoder_init_buf(&encoder, NULL, 0);
 
-	/* no modified parameters -> we are done */
-	if (param_values == NULL) {
+	/* no parameter storage -> we are done */
+	if (param_count() == 0) {
 		result = 0;
 		goto out;
 	}
 
-	while ((s = (struct param_wbuf_s *)utarray_next(param_values, s)) != NULL) {
+	for (param_t param = 0; param < param_count(); param++) {
 
 		int32_t i;
 		float   f;
@@ -96,31 +86,32 @@ param_export_internal(bool only_unsaved)
 		 * If we are only saving values changed since last save, and this
 		 * one hasn't, then skip it
 		 */
-		if (only_unsaved && !s->unsaved) {
+		if (!PARAM_BIT_TEST(param_changed_bits, param) ||
+		    (only_unsaved && !PARAM_BIT_TEST(param_unsaved_bits, param))) {
 			continue;
 		}
 
-		s->unsaved = false;
+		param_unsaved_bits[param / 32] &= ~(1u << (param % 32));
 
 		/* append the appropriate BSON type object */
 
-		switch (param_type(s->param)) {
+		switch (param_type(param)) {
 
 		case PARAM_TYPE_INT32:
-			i = s->val.i;
+			i = param_values[param].i;
 
-			if (bson_encoder_append_int(&encoder, param_name(s->param), i)) {
-				debug("BSON append failed for '%s'", param_name(s->param));
+			if (bson_encoder_append_int(&encoder, param_name(param), i)) {
+				debug("BSON append failed for '%s'", param_name(param));
 				goto out;
 			}
 
 			break;
 
 		case PARAM_TYPE_FLOAT:
-			f = s->val.f;
+			f = param_values[param].f;
 
-			if (bson_encoder_append_double(&encoder, param_name(s->param), f)) {
-				debug("BSON append failed for '%s'", param_name(s->param));
+			if (bson_encoder_append_double(&encoder, param_name(param), f)) {
+				debug("BSON append failed for '%s'", param_name(param));
 				goto out;
 			}
 
@@ -128,11 +119,11 @@ param_export_internal(bool only_unsaved)
 
 		case PARAM_TYPE_STRUCT ... PARAM_TYPE_STRUCT_MAX:
 			if (bson_encoder_append_binary(&encoder,
-						       param_name(s->param),
+						       param_name(param),
 						       BSON_BIN_BINARY,
-						       param_size(s->param),
-						       param_get_value_ptr_external(s->param))) {
-				debug("BSON append failed for '%s'", param_name(s->param));
+						       param_size(param),
+						       param_get_value_ptr_external(param))) {
+				debug("BSON append failed for '%s'", param_name(param));
 				goto out;
 			}
 
@@ -48,8 +48,6 @@
 #include <uORB/topics/mavlink_log.h>
 #include "mavlink_log.h"
 
-#define MAVLINK_LOG_QUEUE_SIZE 5
-
 
 __EXPORT void mavlink_vasprintf(int severity, orb_advert_t *mavlink_log_pub, const char *fmt, ...)
 {
@@ -48,6 +48,11 @@
  */
 #define MAVLINK_LOG_MAXLEN			50
 
+/**
+ * The uORB queue length of the mavlink_log topic.
+ */
+#define MAVLINK_LOG_QUEUE_SIZE			5
+
 #ifdef __cplusplus
 extern "C" {
 #endif
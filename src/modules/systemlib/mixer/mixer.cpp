@@ -206,6 +206,15 @@ NullMixer::groups_required(uint32_t &groups)
 
 }
 
+const mixer_simple_s *
+NullMixer::get_simple_info(ControlCallback control_cb, uintptr_t cb_handle)
+{
+	/* no controls and an output scaler clamping to zero */
+	static const mixer_simple_s null_info = {};
+
+	return &null_info;
+}
+
 NullMixer *
 NullMixer::from_text(const char *buf, unsigned &buflen)
 {
@@ -135,6 +135,16 @@
 
 #include "mixer_load.h"
 
+/*
+ * MixerGroup evaluates runs of simple mixers with a compiled kernel, except on
+ * the IO co-processor which has no RAM to spare for it.
+ */
+#if defined(CONFIG_ARCH_BOARD_PX4IO_V1) || defined(CONFIG_ARCH_BOARD_PX4IO_V2)
+#define MIXER_GROUP_COMPILED 0
+#else
+#define MIXER_GROUP_COMPILED 1
+#endif
+
 /**
  * Abstract class defining a mixer mixing zero or more inputs to
  * one or more outputs.
@@ -213,6 +223,16 @@ public:
 	 */
 	virtual void 			set_thrust_factor(float val) {};
 
+	/**
+	 * Describe the mixer as a sum of scaled controls, for the compiled kernel of MixerGroup.
+	 *
+	 * @param control_cb		The callback the controls have to be read through.
+	 * @param cb_handle		Handle passed to the control callback.
+	 * @return			The simple mixer configuration, or nullptr if the mixer
+	 *				can only be evaluated by mix().
+	 */
+	virtual const mixer_simple_s	*get_simple_info(ControlCallback control_cb, uintptr_t cb_handle) { return nullptr; }
+
 protected:
 	/** client-supplied callback used when fetching control values */
 	ControlCallback			_control_cb;
@@ -288,6 +308,16 @@ public:
 	virtual uint16_t		get_saturation_status(void);
 	virtual void			groups_required(uint32_t &groups);
 
+	/**
+	 * Perform the mixing function by running each mixer of the group in turn,
+	 * bypassing the compiled kernel. Used to verify the kernel.
+	 *
+	 * @param outputs		Array into which mixed output(s) should be placed.
+	 * @param space			The number of available entries in the output array;
+	 * @return			The number of entries in the output array that were populated.
+	 */
+	unsigned			mix_reference(float *outputs, unsigned space, uint16_t *status_reg);
+
 	/**
 	 * Add a mixer to the group.
 	 *
@@ -394,6 +424,50 @@ public:
 private:
 	Mixer				*_first;	/**< linked list of mixers */
 
+#if MIXER_GROUP_COMPILED
+	/**
+	 * Compiled form of the group, rebuilt by the first mix() after the mixers changed.
+	 *
+	 * Runs of consecutive simple mixers become linear blocks. Their scalers are kept
+	 * as structure-of-arrays, term-major: all outputs of a block are scaled for one
+	 * term before moving on to the next, and outputs with fewer controls are padded
+	 * with terms that always yield zero. Each control is fetched once per mix.
+	 * Any other mixer is a stage evaluated by its own mix(), in the original order.
+	 */
+	struct mixer_stage_s {
+		Mixer		*mixer;		/**< mixer evaluated by its mix(), nullptr for a linear block */
+		unsigned	output_count;	/**< outputs of a linear block */
+		unsigned	term_count;	/**< term slots per output of a linear block */
+		unsigned	first_output;	/**< offset of a linear block in the output arrays */
+		unsigned	first_term;	/**< offset of a linear block in the term arrays */
+	};
+
+	struct scaler_array_s {
+		float		*negative_scale;
+		float		*positive_scale;
+		float		*offset;
+		float		*min_output;
+		float		*max_output;
+	};
+
+	bool				_compiled;	/**< compiled form is up to date */
+	mixer_stage_s			*_stages;	/**< nullptr if the group could not be compiled */
+	unsigned			_stage_count;
+	unsigned			_input_count;
+	uint8_t				*_input_group;	/**< control group of each distinct control, backing store of all byte arrays */
+	uint8_t				*_input_index;	/**< control index of each distinct control */
+	uint8_t				*_term_input;	/**< control of each term, _input_count for padding */
+	float				*_values;	/**< backing store of all float arrays */
+	float				*_input_value;	/**< controls of this mix, plus a trailing zero */
+	float				*_sum_value;	/**< scratch for the summed outputs of a block */
+	scaler_array_s			_term_scaler;
+	scaler_array_s			_output_scaler;
+
+	void				compile();
+	void				release_compiled();
+	unsigned			mix_compiled(float *outputs, unsigned space, uint16_t *status_reg);
+#endif
+
 	/* do not allow to copy due to pointer data members */
 	MixerGroup(const MixerGroup &);
 	MixerGroup operator=(const MixerGroup &);
@@ -434,6 +508,8 @@ public:
 		return 0;
 	}
 
+	virtual const mixer_simple_s	*get_simple_info(ControlCallback control_cb, uintptr_t cb_handle);
+
 };
 
 /**
@@ -513,6 +589,8 @@ public:
 
 	unsigned set_trim(float trim);
 
+	virtual const mixer_simple_s	*get_simple_info(ControlCallback control_cb, uintptr_t cb_handle);
+
 protected:
 
 private:
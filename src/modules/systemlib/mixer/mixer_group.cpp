@@ -61,12 +61,31 @@
 MixerGroup::MixerGroup(ControlCallback control_cb, uintptr_t cb_handle) :
 	Mixer(control_cb, cb_handle),
 	_first(nullptr)
+#if MIXER_GROUP_COMPILED
+	,
+	_compiled(false),
+	_stages(nullptr),
+	_stage_count(0),
+	_input_count(0),
+	_input_group(nullptr),
+	_input_index(nullptr),
+	_term_input(nullptr),
+	_values(nullptr),
+	_input_value(nullptr),
+	_sum_value(nullptr),
+	_term_scaler{},
+	_output_scaler{}
+#endif
 {
 }
 
 MixerGroup::~MixerGroup()
 {
 	reset();
+
+#if MIXER_GROUP_COMPILED
+	release_compiled();
+#endif
 }
 
 void
@@ -82,6 +101,10 @@ MixerGroup::add_mixer(Mixer *mixer)
 
 	*mpp = mixer;
 	mixer->_next = nullptr;
+
+#if MIXER_GROUP_COMPILED
+	_compiled = false;
+#endif
 }
 
 void
@@ -93,6 +116,12 @@ MixerGroup::reset()
 	/* flag mixer as invalid */
 	_first = nullptr;
 
+#if MIXER_GROUP_COMPILED
+	/* the stages point at the mixers about to be deleted */
+	release_compiled();
+	_compiled = false;
+#endif
+
 	/* discard sub-mixers */
 	while (next != nullptr) {
 		mixer = next;
@@ -104,6 +133,24 @@ MixerGroup::reset()
 
 unsigned
 MixerGroup::mix(float *outputs, unsigned space, uint16_t *status_reg)
+{
+#if MIXER_GROUP_COMPILED
+
+	if (!_compiled) {
+		compile();
+	}
+
+	if (_stages != nullptr) {
+		return mix_compiled(outputs, space, status_reg);
+	}
+
+#endif
+
+	return mix_reference(outputs, space, status_reg);
+}
+
+unsigned
+MixerGroup::mix_reference(float *outputs, unsigned space, uint16_t *status_reg)
 {
 	Mixer	*mixer = _first;
 	unsigned index = 0;
@@ -142,6 +189,11 @@ MixerGroup::set_trims(int16_t *values, unsigned n)
 		mixer = mixer->_next;
 	}
 
+#if MIXER_GROUP_COMPILED
+	/* the output scaler offsets changed, the next mix() picks them up */
+	_compiled = false;
+#endif
+
 	return index;
 }
 
@@ -273,3 +325,302 @@ void MixerGroup::set_max_delta_out_once(float delta_out_max)
 		mixer = mixer->_next;
 	}
 }
+
+#if MIXER_GROUP_COMPILED
+
+/*
+ * Same as Mixer::scale(), applied element-wise over structure-of-arrays scalers.
+ * Written with selects only so that the compiler can vectorize it.
+ */
+static inline void
+scale_array(const float *negative_scale, const float *positive_scale, const float *offset,
+	    const float *min_output, const float *max_output, const float *input, float *output, unsigned n)
+{
+	for (unsigned i = 0; i < n; i++) {
+		const float in = input[i];
+		float out = (in * ((in < 0.0f) ? negative_scale[i] : positive_scale[i])) + offset[i];
+
+		out = (out > max_output[i]) ? max_output[i] : ((out < min_output[i]) ? min_output[i] : out);
+		output[i] = out;
+	}
+}
+
+/*
+ * Scale one term of each output, reading the controls through the term indices, and
+ * add it to the output sums.
+ */
+static inline void
+accumulate_array(const float *negative_scale, const float *positive_scale, const float *offset,
+		 const float *min_output, const float *max_output, const float *input, const uint8_t *input_index,
+		 float *sum, unsigned n)
+{
+	for (unsigned i = 0; i < n; i++) {
+		const float in = input[input_index[i]];
+		float out = (in * ((in < 0.0f) ? negative_scale[i] : positive_scale[i])) + offset[i];
+
+		out = (out > max_output[i]) ? max_output[i] : ((out < min_output[i]) ? min_output[i] : out);
+		sum[i] += out;
+	}
+}
+
+static inline void
+set_scaler(float *negative_scale, float *positive_scale, float *offset, float *min_output, float *max_output,
+	   unsigned i, const mixer_scaler_s &scaler)
+{
+	negative_scale[i] = scaler.negative_scale;
+	positive_scale[i] = scaler.positive_scale;
+	offset[i] = scaler.offset;
+	min_output[i] = scaler.min_output;
+	max_output[i] = scaler.max_output;
+}
+
+void
+MixerGroup::release_compiled()
+{
+	delete[] _stages;
+	delete[] _input_group;
+	delete[] _values;
+
+	_stages = nullptr;
+	_stage_count = 0;
+	_input_count = 0;
+	_input_group = nullptr;
+	_input_index = nullptr;
+	_term_input = nullptr;
+	_values = nullptr;
+	_input_value = nullptr;
+	_sum_value = nullptr;
+}
+
+void
+MixerGroup::compile()
+{
+	/* set first, a change while compiling has to trigger another pass */
+	_compiled = true;
+
+	release_compiled();
+
+	/* size everything: stages, outputs and term slots of the linear blocks, controls */
+	unsigned stage_count = 0;
+	unsigned output_count = 0;
+	unsigned term_count = 0;
+	unsigned control_count = 0;
+	unsigned max_block_outputs = 0;
+
+	Mixer *mixer = _first;
+
+	while (mixer != nullptr) {
+		if (mixer->get_simple_info(_control_cb, _cb_handle) == nullptr) {
+			stage_count++;
+			mixer = mixer->_next;
+			continue;
+		}
+
+		unsigned block_outputs = 0;
+		unsigned block_terms = 0;
+		const mixer_simple_s *info;
+
+		while (mixer != nullptr && (info = mixer->get_simple_info(_control_cb, _cb_handle)) != nullptr) {
+			block_outputs++;
+			control_count += info->control_count;
+
+			if (info->control_count > block_terms) {
+				block_terms = info->control_count;
+			}
+
+			mixer = mixer->_next;
+		}
+
+		stage_count++;
+		output_count += block_outputs;
+		term_count += block_outputs * block_terms;
+
+		if (block_outputs > max_block_outputs) {
+			max_block_outputs = block_outputs;
+		}
+	}
+
+	/* nothing to gain for a group without simple mixers, or one that does not fit the term indices */
+	if (output_count == 0 || control_count >= UINT8_MAX) {
+		return;
+	}
+
+	const unsigned value_count = (control_count + 1) + 5 * term_count + 5 * output_count + max_block_outputs;
+
+	_stages = new mixer_stage_s[stage_count];
+	_input_group = new uint8_t[2 * control_count + term_count];
+	_values = new float[value_count];
+
+	if (_stages == nullptr || _input_group == nullptr || _values == nullptr) {
+		release_compiled();
+		return;
+	}
+
+	_input_index = _input_group + control_count;
+	_term_input = _input_index + control_count;
+
+	float *v = _values;
+	_input_value = v;
+	v += control_count + 1;
+	_term_scaler.negative_scale = v;
+	v += term_count;
+	_term_scaler.positive_scale = v;
+	v += term_count;
+	_term_scaler.offset = v;
+	v += term_count;
+	_term_scaler.min_output = v;
+	v += term_count;
+	_term_scaler.max_output = v;
+	v += term_count;
+	_output_scaler.negative_scale = v;
+	v += output_count;
+	_output_scaler.positive_scale = v;
+	v += output_count;
+	_output_scaler.offset = v;
+	v += output_count;
+	_output_scaler.min_output = v;
+	v += output_count;
+	_output_scaler.max_output = v;
+	v += output_count;
+	_sum_value = v;
+
+	/* a padding term scales the constant zero input to zero */
+	const mixer_scaler_s zero_scaler = {};
+
+	mixer = _first;
+	output_count = 0;
+	term_count = 0;
+
+	while (mixer != nullptr) {
+		mixer_stage_s &stage = _stages[_stage_count++];
+
+		if (mixer->get_simple_info(_control_cb, _cb_handle) == nullptr) {
+			stage.mixer = mixer;
+			stage.output_count = 0;
+			stage.term_count = 0;
+			stage.first_output = 0;
+			stage.first_term = 0;
+			mixer = mixer->_next;
+			continue;
+		}
+
+		stage.mixer = nullptr;
+		stage.output_count = 0;
+		stage.term_count = 0;
+		stage.first_output = output_count;
+		stage.first_term = term_count;
+
+		/* first pass over the run for its size, the second one fills it in */
+		Mixer *first = mixer;
+		const mixer_simple_s *info;
+
+		while (mixer != nullptr && (info = mixer->get_simple_info(_control_cb, _cb_handle)) != nullptr) {
+			if (info->control_count > stage.term_count) {
+				stage.term_count = info->control_count;
+			}
+
+			stage.output_count++;
+			mixer = mixer->_next;
+		}
+
+		unsigned o = 0;
+
+		for (Mixer *m = first; m != mixer; m = m->_next, o++) {
+			info = m->get_simple_info(_control_cb, _cb_handle);
+
+			set_scaler(_output_scaler.negative_scale, _output_scaler.positive_scale, _output_scaler.offset,
+				   _output_scaler.min_output, _output_scaler.max_output, stage.first_output + o, info->output_scaler);
+
+			for (unsigned t = 0; t < stage.term_count; t++) {
+				const unsigned slot = stage.first_term + t * stage.output_count + o;
+
+				if (t >= info->control_count) {
+					_term_input[slot] = UINT8_MAX;
+					set_scaler(_term_scaler.negative_scale, _term_scaler.positive_scale, _term_scaler.offset,
+						   _term_scaler.min_output, _term_scaler.max_output, slot, zero_scaler);
+					continue;
+				}
+
+				const mixer_control_s &control = info->controls[t];
+				unsigned input = 0;
+
+				while (input < _input_count &&
+				       (_input_group[input] != control.control_group || _input_index[input] != control.control_index)) {
+					input++;
+				}
+
+				if (input == _input_count) {
+					_input_group[input] = control.control_group;
+					_input_index[input] = control.control_index;
+					_input_count++;
+				}
+
+				_term_input[slot] = input;
+				set_scaler(_term_scaler.negative_scale, _term_scaler.positive_scale, _term_scaler.offset,
+					   _term_scaler.min_output, _term_scaler.max_output, slot, control.scaler);
+			}
+		}
+
+		output_count += stage.output_count;
+		term_count += stage.output_count * stage.term_count;
+	}
+
+	/* padding terms read the zero behind the last control */
+	for (unsigned i = 0; i < term_count; i++) {
+		if (_term_input[i] == UINT8_MAX) {
+			_term_input[i] = _input_count;
+		}
+	}
+
+	_input_value[_input_count] = 0.0f;
+}
+
+unsigned
+MixerGroup::mix_compiled(float *outputs, unsigned space, uint16_t *status_reg)
+{
+	/* fetch every control of the linear blocks once */
+	for (unsigned i = 0; i < _input_count; i++) {
+		_input_value[i] = 0.0f;
+		_control_cb(_cb_handle, _input_group[i], _input_index[i], _input_value[i]);
+	}
+
+	unsigned index = 0;
+
+	for (unsigned s = 0; (s < _stage_count) && (index < space); s++) {
+		const mixer_stage_s &stage = _stages[s];
+
+		if (stage.mixer != nullptr) {
+			index += stage.mixer->mix(outputs + index, space - index, status_reg);
+			continue;
+		}
+
+		const unsigned n = stage.output_count;
+
+		for (unsigned i = 0; i < n; i++) {
+			_sum_value[i] = 0.0f;
+		}
+
+		/* same summation order as SimpleMixer::mix(), padding terms add zero */
+		for (unsigned t = 0; t < stage.term_count; t++) {
+			const unsigned base = stage.first_term + t * n;
+
+			accumulate_array(&_term_scaler.negative_scale[base], &_term_scaler.positive_scale[base],
+					 &_term_scaler.offset[base], &_term_scaler.min_output[base], &_term_scaler.max_output[base],
+					 _input_value, &_term_input[base], _sum_value, n);
+		}
+
+		const unsigned first = stage.first_output;
+
+		scale_array(&_output_scaler.negative_scale[first], &_output_scaler.positive_scale[first], &_output_scaler.offset[first],
+			    &_output_scaler.min_output[first], &_output_scaler.max_output[first], _sum_value, _sum_value, n);
+
+		const unsigned count = (n < space - index) ? n : space - index;
+
+		memcpy(outputs + index, _sum_value, count * sizeof(float));
+		index += count;
+	}
+
+	return index;
+}
+
+#endif
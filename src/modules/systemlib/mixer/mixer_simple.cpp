@@ -327,6 +327,16 @@ SimpleMixer::groups_required(uint32_t &groups)
 	}
 }
 
+const mixer_simple_s *
+SimpleMixer::get_simple_info(ControlCallback control_cb, uintptr_t cb_handle)
+{
+	if (control_cb != _control_cb || cb_handle != _cb_handle) {
+		return nullptr;
+	}
+
+	return _pinfo;
+}
+
 int
 SimpleMixer::check()
 {
@@ -212,6 +212,28 @@ __EXPORT bool		param_value_is_default(param_t param);
  */
 __EXPORT bool		param_value_unsaved(param_t param);
 
+/**
+ * Return the current parameter generation.
+ *
+ * The generation increases with every change of a parameter value. A module
+ * remembers it when loading its parameters and later passes it to
+ * param_changed_since() to find out which of its parameters changed.
+ *
+ * @return		The generation of the most recent parameter change.
+ */
+__EXPORT uint32_t	param_generation(void);
+
+/**
+ * Test which of a set of parameters changed after a generation.
+ *
+ * @param params	Array of parameter handles. Invalid handles never count as changed.
+ * @param count		Number of handles in params.
+ * @param generation	Generation returned by an earlier param_generation() call.
+ * @param changed	If not NULL, receives one flag per handle telling whether it changed.
+ * @return		The number of handles whose value changed after generation.
+ */
+__EXPORT unsigned	param_changed_since(const param_t *params, unsigned count, uint32_t generation, bool *changed);
+
 /**
  * Obtain the type of a parameter.
  *
@@ -383,6 +405,28 @@ __EXPORT int 		param_load_default(void);
  */
 __EXPORT uint32_t	param_hash_check(void);
 
+/**
+ * Generate the hash of all parameters and their values, along with a hash of
+ * each individual value.
+ *
+ * Both are computed under one lock, so the per-value hashes describe exactly
+ * the state the returned hash was computed from.
+ *
+ * @param value_hashes	Array receiving param_value_hash() of each used parameter,
+ *			indexed by param_get_used_index(). May be NULL.
+ * @param count		Number of entries in value_hashes.
+ * @return		CRC32 hash of all param_ids and values, as param_hash_check()
+ */
+__EXPORT uint32_t	param_hash_check_values(uint32_t *value_hashes, unsigned count);
+
+/**
+ * Generate the hash of a single parameter value.
+ *
+ * @param param		A handle returned by param_find or passed by param_foreach.
+ * @return		CRC32 hash of the current value, or 0 for an invalid handle
+ */
+__EXPORT uint32_t	param_value_hash(param_t param);
+
 
 /**
  * Enable/disable the param autosaving.
@@ -47,6 +47,8 @@
 #include <string.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <float.h>
+#include <math.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <systemlib/err.h>
@@ -58,7 +60,6 @@
 #include <drivers/drv_hrt.h>
 
 #include "systemlib/param/param.h"
-#include "systemlib/uthash/utarray.h"
 #include "systemlib/bson/tinybson.h"
 
 #include "uORB/uORB.h"
@@ -100,25 +101,49 @@ static struct param_info_s *param_info_base = (struct param_info_s *) &px4_param
 #define	param_info_count		px4_parameters.param_count
 
 /**
- * Storage for modified parameters.
+ * Bitmap of the parameters in use, one bit per parameter handle.
+ *
+ * param_used_rank[i] holds the number of used parameters in the words before
+ * word i, so the used index of a parameter is one lookup plus a popcount and
+ * the parameter at a used index is a binary search over the rank table.
  */
-struct param_wbuf_s {
-	union param_value_u	val;
-	param_t			param;
-	bool			unsaved;
-};
+static uint32_t *param_used_storage = NULL;
+static uint16_t *param_used_rank = NULL;
+static unsigned param_used_words = 0;
+static unsigned param_used_count = 0;
+#define PARAM_USED_WORD_BITS	32
+
+/**
+ * Storage for modified parameters, indexed by param_t.
+ *
+ * param_changed_bits marks the parameters holding a value in param_values,
+ * param_unsaved_bits the ones modified since the last save. Everything is
+ * allocated once together with the used bitmap, so setting a parameter never
+ * allocates or sorts.
+ */
+static union param_value_u *param_values = NULL;
+static uint32_t *param_changed_bits = NULL;
+static uint32_t *param_unsaved_bits = NULL;
 
+/**
+ * Generation of the last value change of each parameter. The counter is
+ * bumped on every change, so a change after generation G has a larger one.
+ */
+static uint32_t *param_generations = NULL;
+static uint32_t param_generation_counter = 0;
 
-uint8_t  *param_changed_storage = 0;
-int size_param_changed_storage_bytes = 0;
-const int bits_per_allocation_unit  = (sizeof(*param_changed_storage) * 8);
+#define PARAM_BIT_WORD(param)	((param) / PARAM_USED_WORD_BITS)
+#define PARAM_BIT_MASK(param)	(1u << ((param) % PARAM_USED_WORD_BITS))
+#define PARAM_BIT_TEST(bits, param)	(((bits)[PARAM_BIT_WORD(param)] & PARAM_BIT_MASK(param)) != 0)
+#define PARAM_BIT_SET(bits, param)	((bits)[PARAM_BIT_WORD(param)] |= PARAM_BIT_MASK(param))
+#define PARAM_BIT_CLEAR(bits, param)	((bits)[PARAM_BIT_WORD(param)] &= ~PARAM_BIT_MASK(param))
 
 //#define ENABLE_SHMEM_DEBUG
 
 extern int get_shmem_lock(const char *caller_file_name, int caller_line_number);
 extern void release_shmem_lock(const char *caller_file_name, int caller_line_number);
 
-struct param_wbuf_s *param_find_changed(param_t param);
+union param_value_u *param_find_changed(param_t param);
 
 void init_params(void);
 extern void init_shared_memory(void);
@@ -143,28 +168,42 @@ static int param_load_default_no_notify(void);
 static unsigned
 get_param_info_count(void)
 {
-	/* Singleton creation of and array of bits to track changed values */
-	if (!param_changed_storage) {
-		size_param_changed_storage_bytes  = (param_info_count / bits_per_allocation_unit) + 1;
-		param_changed_storage = calloc(size_param_changed_storage_bytes, 1);
+	/* Singleton creation of the used bitmap and the modified value store */
+	if (!param_used_storage) {
+		unsigned words = (param_info_count / PARAM_USED_WORD_BITS) + 1;
+		uint16_t *rank = calloc(words, sizeof(uint16_t));
+		uint32_t *storage = calloc(words, sizeof(uint32_t));
+		union param_value_u *values = calloc(param_info_count, sizeof(union param_value_u));
+		uint32_t *changed = calloc(words, sizeof(uint32_t));
+		uint32_t *unsaved = calloc(words, sizeof(uint32_t));
+		uint32_t *generations = calloc(param_info_count, sizeof(uint32_t));
 
 		/* If the allocation fails we need to indicate failure in the
 		 * API by returning PARAM_INVALID
 		 */
-		if (param_changed_storage == NULL) {
+		if (rank == NULL || storage == NULL || values == NULL || changed == NULL || unsaved == NULL ||
+		    generations == NULL) {
+			free(rank);
+			free(storage);
+			free(values);
+			free(changed);
+			free(unsaved);
+			free(generations);
 			return 0;
 		}
+
+		param_used_words = words;
+		param_used_rank = rank;
+		param_values = values;
+		param_changed_bits = changed;
+		param_unsaved_bits = unsaved;
+		param_generations = generations;
+		param_used_storage = storage;
 	}
 
 	return param_info_count;
 }
 
-/** flexible array holding modified parameter values */
-UT_array	*param_values;
-
-/** array info for the modified parameters array */
-const UT_icd	param_icd = {sizeof(struct param_wbuf_s), NULL, NULL, NULL};
-
 /** parameter update topic handle */
 static orb_advert_t param_topic = NULL;
 
@@ -219,50 +258,45 @@ handle_in_range(param_t param)
 }
 
 /**
- * Compare two modifid parameter structures to determine ordering.
+ * Locate the modified value of a parameter, if it exists.
  *
- * This function is suitable for passing to qsort or bsearch.
+ * @param param			The parameter being searched.
+ * @return			The modified value, or NULL if the parameter
+ *				has not been modified.
  */
-static int
-param_compare_values(const void *a, const void *b)
+union param_value_u *
+param_find_changed(param_t param)
 {
-	struct param_wbuf_s *pa = (struct param_wbuf_s *)a;
-	struct param_wbuf_s *pb = (struct param_wbuf_s *)b;
-
-	if (pa->param < pb->param) {
-		return -1;
-	}
+	param_assert_locked();
 
-	if (pa->param > pb->param) {
-		return 1;
+	if (handle_in_range(param) && PARAM_BIT_TEST(param_changed_bits, param)) {
+		return &param_values[param];
 	}
 
-	return 0;
+	return NULL;
 }
 
 /**
- * Locate the modified parameter structure for a parameter, if it exists.
+ * Drop the modified value of a parameter, releasing struct storage.
  *
- * @param param			The parameter being searched.
- * @return			The structure holding the modified value, or
- *				NULL if the parameter has not been modified.
+ * @param param			A valid parameter handle.
  */
-struct param_wbuf_s *
-param_find_changed(param_t param)
+static void
+param_clear_changed(param_t param)
 {
-	struct param_wbuf_s	*s = NULL;
+	if (PARAM_BIT_TEST(param_changed_bits, param)) {
+		if (param_type(param) >= PARAM_TYPE_STRUCT &&
+		    param_type(param) <= PARAM_TYPE_STRUCT_MAX) {
+			free(param_values[param].p);
+		}
 
-	param_assert_locked();
+		param_values[param].p = NULL;
+		PARAM_BIT_CLEAR(param_changed_bits, param);
+		PARAM_BIT_CLEAR(param_unsaved_bits, param);
 
-	if (param_values != NULL) {
-		while ((s = (struct param_wbuf_s *)utarray_next(param_values, s)) != NULL) {
-			if (s->param == param) {
-				break;
-			}
-		}
+		/* back to the default is a change as well */
+		param_generations[param] = ++param_generation_counter;
 	}
-
-	return s;
 }
 
 static void
@@ -332,21 +366,12 @@ param_count_used(void)
 {
 	//TODO FIXME: all params used right now
 #if 0
-	unsigned count = 0;
-
 	// ensure the allocation has been done
 	if (get_param_info_count()) {
-
-		for (unsigned i = 0; i < size_param_changed_storage_bytes; i++) {
-			for (unsigned j = 0; j < bits_per_allocation_unit; j++) {
-				if (param_changed_storage[i] & (1 << j)) {
-					count++;
-				}
-			}
-		}
+		return param_used_count;
 	}
 
-	return count;
+	return 0;
 #else
 	return get_param_info_count();
 #endif
@@ -368,27 +393,30 @@ param_t
 param_for_used_index(unsigned index)
 {
 #if 0
-	int count = get_param_info_count();
+	if (get_param_info_count() && index < param_used_count) {
+		/* find the last word with at most index used params in front of it */
+		unsigned front = 0;
+		unsigned last = param_used_words - 1;
 
-	if (count && index < count) {
-		/* walk all params and count used params */
-		unsigned used_count = 0;
+		while (front < last) {
+			unsigned middle = front + (last - front + 1) / 2;
 
-		for (unsigned i = 0; i < (unsigned)size_param_changed_storage_bytes; i++) {
-			for (unsigned j = 0; j < bits_per_allocation_unit; j++) {
-				if (param_changed_storage[i] & (1 << j)) {
+			if (param_used_rank[middle] <= index) {
+				front = middle;
 
-					/* we found the right used count,
-					 * return the param value
-					 */
-					if (index == used_count) {
-						return (param_t)(i * bits_per_allocation_unit + j);
-					}
-
-					used_count++;
-				}
+			} else {
+				last = middle - 1;
 			}
 		}
+
+		/* drop the lower set bits until the requested one is the lowest */
+		uint32_t word = param_used_storage[front];
+
+		for (unsigned n = index - param_used_rank[front]; n > 0; n--) {
+			word &= word - 1;
+		}
+
+		return (param_t)(front * PARAM_USED_WORD_BITS + __builtin_ctz(word));
 	}
 
 	return PARAM_INVALID;
@@ -417,24 +445,11 @@ param_get_used_index(param_t param)
 		return -1;
 	}
 
-	/* walk all params and count, now knowing that it has a valid index */
-	int used_count = 0;
-
-	for (unsigned i = 0; i < (unsigned)size_param_changed_storage_bytes; i++) {
-		for (unsigned j = 0; j < bits_per_allocation_unit; j++) {
+	/* used params in the words before, plus the lower bits of its own word */
+	unsigned word = (unsigned)param / PARAM_USED_WORD_BITS;
+	uint32_t below = param_used_storage[word] & ((1u << ((unsigned)param % PARAM_USED_WORD_BITS)) - 1);
 
-			if (param_changed_storage[i] & (1 << j)) {
-
-				if ((unsigned)param == i * bits_per_allocation_unit + j) {
-					return used_count;
-				}
-
-				used_count++;
-			}
-		}
-	}
-
-	return -1;
+	return param_used_rank[word] + __builtin_popcount(below);
 #else
 	return param;
 #endif
@@ -450,7 +465,7 @@ param_name(param_t param)
 bool
 param_value_is_default(param_t param)
 {
-	struct param_wbuf_s *s;
+	union param_value_u *s;
 	param_lock();
 	s = param_find_changed(param);
 	param_unlock();
@@ -460,14 +475,44 @@ param_value_is_default(param_t param)
 bool
 param_value_unsaved(param_t param)
 {
-	struct param_wbuf_s *s;
+	union param_value_u *s;
 	param_lock();
 	s = param_find_changed(param);
-	bool ret = s && s->unsaved;
+	bool ret = s && PARAM_BIT_TEST(param_unsaved_bits, param);
 	param_unlock();
 	return ret;
 }
 
+uint32_t
+param_generation(void)
+{
+	return __atomic_load_n(&param_generation_counter, __ATOMIC_RELAXED);
+}
+
+unsigned
+param_changed_since(const param_t *params, unsigned count, uint32_t generation, bool *changed)
+{
+	unsigned changed_count = 0;
+
+	param_lock();
+
+	for (unsigned i = 0; i < count; i++) {
+		bool c = handle_in_range(params[i]) && param_generations[params[i]] > generation;
+
+		if (changed != NULL) {
+			changed[i] = c;
+		}
+
+		if (c) {
+			changed_count++;
+		}
+	}
+
+	param_unlock();
+
+	return changed_count;
+}
+
 enum param_type_e
 param_type(param_t param) {
 	return handle_in_range(param) ? param_info_base[param].type : PARAM_TYPE_UNKNOWN;
@@ -515,10 +560,10 @@ param_get_value_ptr(param_t param)
 		const union param_value_u *v;
 
 		/* work out whether we're fetching the default or a written value */
-		struct param_wbuf_s *s = param_find_changed(param);
+		const union param_value_u *s = param_find_changed(param);
 
 		if (s != NULL) {
-			v = &s->val;
+			v = s;
 
 		} else {
 			v = &param_info_base[param].val;
@@ -660,6 +705,7 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 {
 	int result = -1;
 	bool params_changed = false;
+	bool value_changed = false;
 
 	PX4_DEBUG("param_set_internal params: param = %d, val = 0x%X, mark_saved: %d, notify_changes: %d",
 		  param, val, (int)mark_saved, (int)notify_changes);
@@ -670,65 +716,62 @@ param_set_internal(param_t param, const void *val, bool mark_saved, bool notify_
 		return result;
 	}
 
-	if (param_values == NULL) {
-		utarray_new(param_values, &param_icd);
-	}
-
-	if (param_values == NULL) {
-		debug("failed to allocate modified values array");
-		goto out;
-	}
-
 	if (handle_in_range(param)) {
 
-		struct param_wbuf_s *s = param_find_changed(param);
+		union param_value_u *s = param_find_changed(param);
 
 		if (s == NULL) {
-
-			/* construct a new parameter */
-			struct param_wbuf_s buf = {
-				.param = param,
-				.val.p = NULL,
-				.unsaved = false
-			};
-
-			/* add it to the array and sort */
-			utarray_push_back(param_values, &buf);
-			utarray_sort(param_values, param_compare_values);
-
-			/* find it after sorting */
-			s = param_find_changed(param);
+			/* first modification, start from an empty slot */
+			s = &param_values[param];
+			s->p = NULL;
+			value_changed = true;
 		}
 
 		/* update the changed value */
 		switch (param_type(param)) {
 
 		case PARAM_TYPE_INT32:
-			s->val.i = *(int32_t *)val;
+			value_changed = value_changed || s->i != *(int32_t *)val;
+			s->i = *(int32_t *)val;
 			break;
 
 		case PARAM_TYPE_FLOAT:
-			s->val.f = *(float *)val;
+			value_changed = value_changed || fabsf(s->f - * (float *)val) > FLT_EPSILON;
+			s->f = *(float *)val;
 			break;
 
 		case PARAM_TYPE_STRUCT ... PARAM_TYPE_STRUCT_MAX:
-			if (s->val.p == NULL) {
-				s->val.p = malloc(param_size(param));
+			if (s->p == NULL) {
+				s->p = malloc(param_size(param));
 
-				if (s->val.p == NULL) {
+				if (s->p == NULL) {
 					debug("failed to allocate parameter storage");
 					goto out;
 				}
 			}
 
-			memcpy(s->val.p, val, param_size(param));
+			memcpy(s->p, val, param_size(param));
+			value_changed = true;
 			break;
 
 		default:
 			goto out;
 		}
 
-		s->unsaved = !mark_saved;
+		PARAM_BIT_SET(param_changed_bits, param);
+
+		/* like param.c, only a different value is a change for param_changed_since() */
+		if (value_changed) {
+			param_generations[param] = ++param_generation_counter;
+		}
+
+		if (mark_saved) {
+			PARAM_BIT_CLEAR(param_unsaved_bits, param);
+
+		} else {
+			PARAM_BIT_SET(param_unsaved_bits, param);
+		}
+
 		params_changed = true;
 		result = 0;
 
@@ -798,8 +841,8 @@ param_used(param_t param)
 		return false;
 	}
 
-	return param_changed_storage[param_index / bits_per_allocation_unit] &
-	       (1 << param_index % bits_per_allocation_unit);
+	return param_used_storage[param_index / PARAM_USED_WORD_BITS] &
+	       (1u << param_index % PARAM_USED_WORD_BITS);
 }
 
 void param_set_used_internal(param_t param)
@@ -810,14 +853,28 @@ void param_set_used_internal(param_t param)
 		return;
 	}
 
-	param_changed_storage[param_index / bits_per_allocation_unit] |=
-		(1 << param_index % bits_per_allocation_unit);
+	unsigned word = param_index / PARAM_USED_WORD_BITS;
+	uint32_t bit = 1u << (param_index % PARAM_USED_WORD_BITS);
+
+	/* param_find() runs from any thread, so update the index atomically
+	 * instead of taking the param lock, which callers may already hold
+	 */
+	if (__atomic_fetch_or(&param_used_storage[word], bit, __ATOMIC_RELAXED) & bit) {
+		return;
+	}
+
+	/* every later word now has one more used param in front of it */
+	for (unsigned i = word + 1; i < param_used_words; i++) {
+		__atomic_fetch_add(&param_used_rank[i], 1, __ATOMIC_RELAXED);
+	}
+
+	__atomic_fetch_add(&param_used_count, 1, __ATOMIC_RELEASE);
 }
 
 int
 param_reset(param_t param)
 {
-	struct param_wbuf_s *s = NULL;
+	union param_value_u *s = NULL;
 	bool param_found = false;
 
 	param_lock();
@@ -829,8 +886,7 @@ param_reset(param_t param)
 
 		/* if we found one, erase it */
 		if (s != NULL) {
-			int pos = utarray_eltidx(param_values, s);
-			utarray_erase(param_values, pos, 1);
+			param_clear_changed(param);
 		}
 
 		param_found = true;
@@ -851,12 +907,10 @@ param_reset_all_internal(bool auto_save)
 {
 	param_lock();
 
-	if (param_values != NULL) {
-		utarray_free(param_values);
-	}
-
 	/* mark as reset / deleted */
-	param_values = NULL;
+	for (param_t param = 0; handle_in_range(param); param++) {
+		param_clear_changed(param);
+	}
 
 	if (auto_save) {
 		param_autosave();
@@ -1040,7 +1094,7 @@ param_load_default_no_notify(void)
 int
 param_export(int fd, bool only_unsaved)
 {
-	struct param_wbuf_s *s = NULL;
+	union param_value_u *s = NULL;
 	struct bson_encoder_s encoder;
 	int	result = -1;
 
@@ -1048,53 +1102,55 @@ param_export(int fd, bool only_unsaved)
 
 	bson_encoder_init_file(&encoder, fd);
 
-	/* no modified parameters -> we are done */
-	if (param_values == NULL) {
-		result = 0;
-		goto out;
-	}
-
 	/* First of all, update the index which will call param_get for params
 	 * that have recently been changed. */
 	update_index_from_shmem();
 
-	while ((s = (struct param_wbuf_s *)utarray_next(param_values, s)) != NULL) {
+	for (param_t param = 0; handle_in_range(param); param++) {
 
 		int32_t	i;
 		float	f;
 
+		/* skip whole words without modified parameters */
+		if (param_changed_bits[PARAM_BIT_WORD(param)] == 0) {
+			param |= PARAM_USED_WORD_BITS - 1;
+			continue;
+		}
+
+		s = param_find_changed(param);
+
 		/*
 		 * If we are only saving values changed since last save, and this
 		 * one hasn't, then skip it
 		 */
-		if (only_unsaved && !s->unsaved) {
+		if (s == NULL || (only_unsaved && !PARAM_BIT_TEST(param_unsaved_bits, param))) {
 			continue;
 		}
 
-		s->unsaved = false;
+		PARAM_BIT_CLEAR(param_unsaved_bits, param);
 
 		/* Make sure to get latest from shmem before saving. */
-		update_from_shmem(s->param, &s->val);
+		update_from_shmem(param, s);
 
 		/* append the appropriate BSON type object */
 
-		switch (param_type(s->param)) {
+		switch (param_type(param)) {
 
 		case PARAM_TYPE_INT32:
-			i = s->val.i;
+			i = s->i;
 
-			if (bson_encoder_append_int(&encoder, param_name(s->param), i)) {
-				PX4_DEBUG("BSON append failed for '%s'", param_name(s->param));
+			if (bson_encoder_append_int(&encoder, param_name(param), i)) {
+				PX4_DEBUG("BSON append failed for '%s'", param_name(param));
 				goto out;
 			}
 
 			break;
 
 		case PARAM_TYPE_FLOAT:
-			f = s->val.f;
+			f = s->f;
 
-			if (bson_encoder_append_double(&encoder, param_name(s->param), f)) {
-				PX4_DEBUG("BSON append failed for '%s'", param_name(s->param));
+			if (bson_encoder_append_double(&encoder, param_name(param), f)) {
+				PX4_DEBUG("BSON append failed for '%s'", param_name(param));
 				goto out;
 			}
 
@@ -1102,11 +1158,11 @@ param_export(int fd, bool only_unsaved)
 
 		case PARAM_TYPE_STRUCT ... PARAM_TYPE_STRUCT_MAX:
 			if (bson_encoder_append_binary(&encoder,
-						       param_name(s->param),
+						       param_name(param),
 						       BSON_BIN_BINARY,
-						       param_size(s->param),
-						       param_get_value_ptr(s->param))) {
-				PX4_DEBUG("BSON append failed for '%s'", param_name(s->param));
+						       param_size(param),
+						       param_get_value_ptr(param))) {
+				PX4_DEBUG("BSON append failed for '%s'", param_name(param));
 				goto out;
 			}
 
@@ -1310,8 +1366,14 @@ param_foreach(void (*func)(void *arg, param_t param), void *arg, bool only_chang
 }
 
 uint32_t param_hash_check(void)
+{
+	return param_hash_check_values(NULL, 0);
+}
+
+uint32_t param_hash_check_values(uint32_t *value_hashes, unsigned count)
 {
 	uint32_t param_hash = 0;
+	unsigned used_index = 0;
 
 	param_lock();
 
@@ -1325,6 +1387,12 @@ uint32_t param_hash_check(void)
 		const void *val = param_get_value_ptr(param);
 		param_hash = crc32part((const uint8_t *)name, strlen(name), param_hash);
 		param_hash = crc32part(val, sizeof(union param_value_u), param_hash);
+
+		if (value_hashes != NULL && used_index < count) {
+			value_hashes[used_index] = crc32part(val, sizeof(union param_value_u), 0);
+		}
+
+		used_index++;
 	}
 
 	param_unlock();
@@ -1332,6 +1400,19 @@ uint32_t param_hash_check(void)
 	return param_hash;
 }
 
+uint32_t param_value_hash(param_t param)
+{
+	uint32_t hash = 0;
+
+	if (handle_in_range(param)) {
+		param_lock();
+		hash = crc32part(param_get_value_ptr(param), sizeof(union param_value_u), 0);
+		param_unlock();
+	}
+
+	return hash;
+}
+
 void init_params(void)
 {
 #ifdef __PX4_QURT
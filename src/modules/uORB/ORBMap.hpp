@@ -33,6 +33,7 @@
 
 #pragma once
 
+#include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
 
@@ -43,11 +44,18 @@ class DeviceNode;
 class ORBMap;
 }
 
+/**
+ * Map from node name to DeviceNode.
+ *
+ * Nodes are kept in a singly linked list in insertion order (used for iteration),
+ * and additionally chained into a fixed number of hash buckets for lookups.
+ */
 class uORB::ORBMap
 {
 public:
 	struct Node {
 		struct Node *next;
+		struct Node *bucket_next; ///< next node in the same hash bucket
 		const char *node_name;
 		uORB::DeviceNode *node;
 	};
@@ -55,7 +63,9 @@ public:
 	ORBMap() :
 		_top(nullptr),
 		_end(nullptr)
-	{ }
+	{
+		memset(_buckets, 0, sizeof(_buckets));
+	}
 	~ORBMap()
 	{
 		while (_top != nullptr) {
@@ -98,36 +108,21 @@ public:
 		_end->next = nullptr;
 		_end->node_name = node_name;
 		_end->node = node;
+
+		Node **bucket = &_buckets[hash(node_name)];
+		_end->bucket_next = *bucket;
+		*bucket = _end;
 	}
 
 	bool find(const char *node_name)
 	{
-		Node *p = _top;
-
-		while (p) {
-			if (strcmp(p->node_name, node_name) == 0) {
-				return true;
-			}
-
-			p = p->next;
-		}
-
-		return false;
+		return findNode(node_name) != nullptr;
 	}
 
 	uORB::DeviceNode *get(const char *node_name)
 	{
-		Node *p = _top;
-
-		while (p) {
-			if (strcmp(p->node_name, node_name) == 0) {
-				return p->node;
-			}
-
-			p = p->next;
-		}
-
-		return nullptr;
+		Node *p = findNode(node_name);
+		return p ? p->node : nullptr;
 	}
 
 	Node *top() const
@@ -141,6 +136,35 @@ public:
 	}
 
 private:
+	static constexpr unsigned NUM_BUCKETS = 64; ///< must be a power of 2
+
+	/** FNV-1a hash of the node name, reduced to a bucket index */
+	static unsigned hash(const char *node_name)
+	{
+		uint32_t h = 2166136261u;
+
+		while (*node_name) {
+			h = (h ^ (uint8_t)*node_name++) * 16777619u;
+		}
+
+		return h & (NUM_BUCKETS - 1);
+	}
+
+	Node *findNode(const char *node_name) const
+	{
+		Node *p = _buckets[hash(node_name)];
+
+		while (p) {
+			if (strcmp(p->node_name, node_name) == 0) {
+				return p;
+			}
+
+			p = p->bucket_next;
+		}
+
+		return nullptr;
+	}
+
 	void unlinkNext(Node *a)
 	{
 		Node *b = a->next;
@@ -150,6 +174,17 @@ private:
 				_end = a;
 			}
 
+			/* remove it from its bucket */
+			Node **bucket = &_buckets[hash(b->node_name)];
+
+			while (*bucket && *bucket != b) {
+				bucket = &(*bucket)->bucket_next;
+			}
+
+			if (*bucket) {
+				*bucket = b->bucket_next;
+			}
+
 			a->next = b->next;
 			free(b);
 		}
@@ -157,5 +192,5 @@ private:
 
 	Node *_top;
 	Node *_end;
+	Node *_buckets[NUM_BUCKETS];
 };
-
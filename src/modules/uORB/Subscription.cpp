@@ -37,7 +37,14 @@
  */
 
 #include "Subscription.hpp"
+#include "uORBManager.hpp"
+#include "uORBDevices.hpp"
 #include <px4_defines.h>
+#include <px4_time.h>
+#include <drivers/drv_hrt.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
 
 namespace uORB
 {
@@ -89,4 +96,177 @@ SubscriptionBase::~SubscriptionBase()
 	if (ret != PX4_OK) { PX4_ERR("orb unsubscribe failed"); }
 }
 
+SubscriptionDirectBase::SubscriptionDirectBase(const struct orb_metadata *meta, unsigned instance) :
+	_meta(meta),
+	_node(nullptr),
+	_generation(0),
+	_borrow_seq(0)
+{
+	_node = uORB::Manager::get_instance()->orb_get_node(meta, instance);
+
+	if (_node == nullptr) {
+		PX4_ERR("sub failed");
+		return;
+	}
+
+	/* default to no pending update, same as orb_subscribe() */
+	_generation = _node->published_message_count();
+	_node->add_internal_subscriber();
+}
+
+SubscriptionDirectBase::~SubscriptionDirectBase()
+{
+	if (_node != nullptr) {
+		_node->remove_internal_subscriber();
+	}
+}
+
+bool SubscriptionDirectBase::updated()
+{
+	return _node != nullptr && _node->updated(_generation);
+}
+
+bool SubscriptionDirectBase::update(void *data)
+{
+	if (updated()) {
+		return _node->copy(data, _generation);
+	}
+
+	return false;
+}
+
+bool SubscriptionDirectBase::copy(void *data)
+{
+	if (_node == nullptr) {
+		return false;
+	}
+
+	return _node->copy(data, _generation);
+}
+
+const void *SubscriptionDirectBase::borrow()
+{
+	if (_node == nullptr) {
+		return nullptr;
+	}
+
+	return _node->borrow(_generation, _borrow_seq);
+}
+
+bool SubscriptionDirectBase::borrowValid() const
+{
+	return _node != nullptr && _node->borrow_valid(_borrow_seq);
+}
+
+SubscriptionCallback::SubscriptionCallback(const struct orb_metadata *meta, unsigned instance) :
+	SubscriptionDirectBase(meta, instance),
+	_next_callback(nullptr),
+	_registered(false)
+{
+}
+
+SubscriptionCallback::~SubscriptionCallback()
+{
+	unregisterCallback();
+}
+
+bool SubscriptionCallback::registerCallback()
+{
+	if (_node == nullptr) {
+		return false;
+	}
+
+	if (!_registered) {
+		_node->register_callback(this);
+		_registered = true;
+	}
+
+	return true;
+}
+
+void SubscriptionCallback::unregisterCallback()
+{
+	if (_registered) {
+		_node->unregister_callback(this);
+		_registered = false;
+	}
+}
+
+SubscriptionWakeup::SubscriptionWakeup(const struct orb_metadata *meta, unsigned instance) :
+	SubscriptionCallback(meta, instance),
+	_perf_name(nullptr),
+	_wakeup_latency_perf(nullptr)
+{
+	px4_sem_init(&_sem, 0, 0);
+
+	/* _sem use case is a signal */
+	px4_sem_setprotocol(&_sem, SEM_PRIO_NONE);
+
+	if (asprintf(&_perf_name, "uorb_wakeup_%s", meta->o_name) > 0) {
+		_wakeup_latency_perf = perf_alloc(PC_ELAPSED, _perf_name);
+
+	} else {
+		_perf_name = nullptr;
+	}
+}
+
+SubscriptionWakeup::~SubscriptionWakeup()
+{
+	/* make sure the publisher does not call us anymore before tearing down */
+	unregisterCallback();
+
+	px4_sem_destroy(&_sem);
+	perf_free(_wakeup_latency_perf);
+	free(_perf_name);
+}
+
+void SubscriptionWakeup::call()
+{
+	int value;
+	px4_sem_getvalue(&_sem, &value);
+
+	/* only wake up once, no matter how many publications happened in between */
+	if (value <= 0) {
+		px4_sem_post(&_sem);
+	}
+}
+
+bool SubscriptionWakeup::wait(unsigned timeout_ms)
+{
+	/* do not sleep if there is unread data already */
+	if (updated()) {
+		return true;
+	}
+
+	struct timespec ts;
+
+	if (timeout_ms > 0) {
+		px4_clock_gettime(CLOCK_REALTIME, &ts);
+
+		/* calculate an absolute time in the future */
+		const unsigned billion = (1000 * 1000 * 1000);
+		uint64_t nsecs = ts.tv_nsec + ((uint64_t)timeout_ms * 1000 * 1000);
+		ts.tv_sec += nsecs / billion;
+		nsecs -= (nsecs / billion) * billion;
+		ts.tv_nsec = nsecs;
+	}
+
+	/* the semaphore can still be posted from a publication that was already
+	 * collected without waiting, so loop until there is actually new data */
+	do {
+		int ret = (timeout_ms > 0) ? px4_sem_timedwait(&_sem, &ts) : px4_sem_wait(&_sem);
+
+		if (ret != 0 && errno != EINTR) {
+			/* timeout */
+			return false;
+		}
+
+	} while (!updated());
+
+	hrt_abstime last_update = _node->last_update();
+	perf_set_elapsed(_wakeup_latency_perf, hrt_elapsed_time(&last_update));
+
+	return true;
+}
+
 } // namespace uORB
@@ -43,10 +43,14 @@
 #include <uORB/uORB.h>
 #include <containers/List.hpp>
 #include <systemlib/err.h>
+#include <systemlib/perf_counter.h>
+#include <px4_sem.h>
 
 namespace uORB
 {
 
+class DeviceNode;
+
 /**
  * Base subscription warapper class, used in list traversal
  * of various subscriptions.
@@ -219,4 +223,214 @@ private:
 	T _data;
 };
 
+/**
+ * Subscription that reads directly from the topic node instead of going
+ * through a file descriptor.
+ *
+ * Checking for and copying an update is a generation compare and a memcpy:
+ * no fd lookup, no ioctl and no file descriptor is used up by the subscription.
+ * Update intervals and poll() are not supported, use SubscriptionBase for these.
+ */
+class __EXPORT SubscriptionDirectBase
+{
+public:
+	/**
+	 * Constructor
+	 *
+	 * @param meta The uORB metadata (usually from the ORB_ID()
+	 * 	macro) for the topic.
+	 * @param instance The instance for multi sub.
+	 */
+	SubscriptionDirectBase(const struct orb_metadata *meta, unsigned instance = 0);
+
+	virtual ~SubscriptionDirectBase();
+
+	/**
+	 * Check if there is a new update.
+	 */
+	bool updated();
+
+	/**
+	 * Copy the latest data if there is a new update.
+	 * @param data The uORB message struct we are updating.
+	 * @return true if data was copied
+	 */
+	bool update(void *data);
+
+	/**
+	 * Copy the latest data, whether it is new or not.
+	 * @param data The uORB message struct we are updating.
+	 * @return true if data was copied, false if nothing was published yet
+	 */
+	bool copy(void *data);
+
+	/**
+	 * Get a read-only view of the latest data instead of copying it.
+	 *
+	 * The data can be overwritten by a publisher at any time: after reading the
+	 * needed fields, check borrowValid() and discard the values if it fails.
+	 * @return view of the data, nullptr if nothing was published yet or borrowing
+	 *         is not supported on this platform (use copy() then)
+	 */
+	const void *borrow();
+
+	/**
+	 * Check that the view returned by the last borrow() is still intact.
+	 */
+	bool borrowValid() const;
+
+	const struct orb_metadata *getMeta() const { return _meta; }
+	bool valid() const { return _node != nullptr; }
+
+protected:
+	const struct orb_metadata *_meta;
+	DeviceNode *_node;
+	unsigned _generation; ///< last generation this subscription has seen
+	unsigned _borrow_seq; ///< node sequence count at the last borrow()
+
+private:
+	// disallow copy
+	SubscriptionDirectBase(const SubscriptionDirectBase &other);
+	// disallow assignment
+	SubscriptionDirectBase &operator=(const SubscriptionDirectBase &other);
+};
+
+/**
+ * Direct subscription wrapper class
+ */
+template<class T>
+class __EXPORT SubscriptionDirect :
+	public SubscriptionDirectBase
+{
+public:
+	SubscriptionDirect(const struct orb_metadata *meta, unsigned instance = 0) :
+		SubscriptionDirectBase(meta, instance),
+		_data() // initialize data structure to zero
+	{}
+
+	virtual ~SubscriptionDirect() {}
+
+	/**
+	 * Update the embedded struct if there is new data.
+	 * @return true if the embedded struct was updated
+	 */
+	bool update()
+	{
+		return SubscriptionDirectBase::update((void *)(&_data));
+	}
+
+	/**
+	 * Copy the latest data into the embedded struct.
+	 */
+	bool copy()
+	{
+		return SubscriptionDirectBase::copy((void *)(&_data));
+	}
+
+	/**
+	 * Typed version of SubscriptionDirectBase::borrow().
+	 */
+	const T *borrow()
+	{
+		return (const T *)SubscriptionDirectBase::borrow();
+	}
+
+	/*
+	 * This function gets the T struct data
+	 * */
+	const T &get() const
+	{
+		return _data;
+	}
+
+private:
+	T _data;
+};
+
+/**
+ * Direct subscription that gets called back by the publisher.
+ *
+ * After registerCallback(), call() is invoked from DeviceNode::write() after every
+ * publication, so consumers can be woken up without setting up a poll() on
+ * every iteration.
+ */
+class __EXPORT SubscriptionCallback : public SubscriptionDirectBase
+{
+public:
+	/**
+	 * Constructor
+	 *
+	 * @param meta The uORB metadata (usually from the ORB_ID()
+	 * 	macro) for the topic.
+	 * @param instance The instance for multi sub.
+	 */
+	SubscriptionCallback(const struct orb_metadata *meta, unsigned instance = 0);
+
+	virtual ~SubscriptionCallback();
+
+	/**
+	 * Start getting called back on publications.
+	 * @return true on success
+	 */
+	bool registerCallback();
+
+	/**
+	 * Stop getting called back on publications.
+	 */
+	void unregisterCallback();
+
+	/**
+	 * Called by the publisher after each publication.
+	 *
+	 * This runs in the publisher's context (this can be an interrupt on NuttX)
+	 * with the topic node locked: it must be short, must not block and must not
+	 * access the same topic.
+	 */
+	virtual void call() = 0;
+
+private:
+	friend class DeviceNode;
+
+	SubscriptionCallback *_next_callback; ///< next callback registered on the same node
+	bool _registered;
+};
+
+/**
+ * Callback subscription that wakes up a thread waiting on it.
+ *
+ * The semaphore is set up once at construction, so waiting does not need any
+ * per-iteration setup. The time from publication to wakeup is traced in a perf
+ * counter named uorb_wakeup_<topic>.
+ */
+class __EXPORT SubscriptionWakeup : public SubscriptionCallback
+{
+public:
+	/**
+	 * Constructor
+	 *
+	 * @param meta The uORB metadata (usually from the ORB_ID()
+	 * 	macro) for the topic.
+	 * @param instance The instance for multi sub.
+	 */
+	SubscriptionWakeup(const struct orb_metadata *meta, unsigned instance = 0);
+
+	virtual ~SubscriptionWakeup();
+
+	/**
+	 * Block until there is a new update or the timeout expires.
+	 * registerCallback() must have been called before.
+	 *
+	 * @param timeout_ms timeout in milliseconds, 0 to wait forever
+	 * @return true if there is a new update
+	 */
+	bool wait(unsigned timeout_ms);
+
+	virtual void call();
+
+private:
+	px4_sem_t _sem;
+	char *_perf_name;
+	perf_counter_t _wakeup_latency_perf; ///< time from publication to wakeup
+};
+
 } // namespace uORB
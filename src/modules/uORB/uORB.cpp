@@ -89,6 +89,16 @@ int  orb_publish(const struct orb_metadata *meta, orb_advert_t handle, const voi
 	return uORB::Manager::get_instance()->orb_publish(meta, handle, data);
 }
 
+void *orb_loan(const struct orb_metadata *meta, orb_advert_t handle)
+{
+	return uORB::Manager::get_instance()->orb_loan(meta, handle);
+}
+
+int  orb_commit(const struct orb_metadata *meta, orb_advert_t handle)
+{
+	return uORB::Manager::get_instance()->orb_commit(meta, handle);
+}
+
 int  orb_subscribe(const struct orb_metadata *meta)
 {
 	return uORB::Manager::get_instance()->orb_subscribe(meta);
@@ -109,6 +119,11 @@ int  orb_copy(const struct orb_metadata *meta, int handle, void *buffer)
 	return uORB::Manager::get_instance()->orb_copy(meta, handle, buffer);
 }
 
+int  orb_copy_batch(const struct orb_metadata *meta, int handle, void *buffer, unsigned max_n, uint32_t *lost)
+{
+	return uORB::Manager::get_instance()->orb_copy_batch(meta, handle, buffer, max_n, lost);
+}
+
 int  orb_check(int handle, bool *updated)
 {
 	return uORB::Manager::get_instance()->orb_check(handle, updated);
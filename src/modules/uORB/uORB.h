@@ -177,6 +177,16 @@ extern int orb_publish_auto(const struct orb_metadata *meta, orb_advert_t *handl
  */
 extern int	orb_publish(const struct orb_metadata *meta, orb_advert_t handle, const void *data) __EXPORT;
 
+/**
+ * @see uORB::Manager::orb_loan()
+ */
+extern void	*orb_loan(const struct orb_metadata *meta, orb_advert_t handle) __EXPORT;
+
+/**
+ * @see uORB::Manager::orb_commit()
+ */
+extern int	orb_commit(const struct orb_metadata *meta, orb_advert_t handle) __EXPORT;
+
 /**
  * @see uORB::Manager::orb_subscribe()
  */
@@ -197,6 +207,12 @@ extern int	orb_unsubscribe(int handle) __EXPORT;
  */
 extern int	orb_copy(const struct orb_metadata *meta, int handle, void *buffer) __EXPORT;
 
+/**
+ * @see uORB::Manager::orb_copy_batch()
+ */
+extern int	orb_copy_batch(const struct orb_metadata *meta, int handle, void *buffer, unsigned max_n,
+			       uint32_t *lost) __EXPORT;
+
 /**
  * @see uORB::Manager::orb_check()
  */
@@ -69,6 +69,7 @@
 #include "uORBUtils.hpp"
 #include "uORBManager.hpp"
 #include "uORBCommunicator.hpp"
+#include "Subscription.hpp"
 #include <px4_sem.hpp>
 #include <stdlib.h>
 
@@ -220,45 +221,276 @@ uORB::DeviceNode::read(device::file_t *filp, char *buffer, size_t buflen)
 		return -EIO;
 	}
 
+#ifndef __PX4_NUTTX
+
+	/*
+	 * Subscribers without an update interval only modify their own state on a
+	 * read, so the copy can be done without taking the node lock.
+	 */
+	if (sd->update_interval == nullptr && read_unlocked(buffer, sd->generation)) {
+		sd->set_priority(_priority);
+		sd->set_update_reported(false);
+		return _meta->o_size;
+	}
+
+#endif
+
 	/*
 	 * Perform an atomic copy & state update
 	 */
 	ATOMIC_ENTER;
 
-	if (_generation > sd->generation + _queue_size) {
+	read_locked(buffer, sd->generation);
+
+	/* set priority */
+	sd->set_priority(_priority);
+
+	/*
+	 * Clear the flag that indicates that an update has been reported, as
+	 * we have just collected it.
+	 */
+	sd->set_update_reported(false);
+
+	ATOMIC_LEAVE;
+
+	return _meta->o_size;
+}
+
+void
+uORB::DeviceNode::read_locked(char *buffer, unsigned &generation)
+{
+	if (_generation > generation + _queue_size) {
 		/* Reader is too far behind: some messages are lost */
-		_lost_messages += _generation - (sd->generation + _queue_size);
-		sd->generation = _generation - _queue_size;
+#ifdef __PX4_NUTTX
+		_lost_messages += _generation - (generation + _queue_size);
+#else
+		__atomic_fetch_add(&_lost_messages, _generation - (generation + _queue_size), __ATOMIC_RELAXED);
+#endif
+		generation = _generation - _queue_size;
 	}
 
-	if (_generation == sd->generation && sd->generation > 0) {
+	if (_generation == generation && generation > 0) {
 		/* The subscriber already read the latest message, but nothing new was published yet.
 		 * Return the previous message
 		 */
-		--sd->generation;
+		--generation;
 	}
 
 	/* if the caller doesn't want the data, don't give it to them */
 	if (nullptr != buffer) {
-		memcpy(buffer, _data + (_meta->o_size * (sd->generation % _queue_size)), _meta->o_size);
+		memcpy(buffer, _data + (_meta->o_size * (generation % _queue_size)), _meta->o_size);
 	}
 
-	if (sd->generation < _generation) {
-		++sd->generation;
+	if (generation < _generation) {
+		++generation;
 	}
+}
 
-	/* set priority */
-	sd->set_priority(_priority);
+unsigned
+uORB::DeviceNode::read_batch_locked(char *buffer, unsigned max_n, unsigned &generation, uint32_t &lost)
+{
+	lost = 0;
 
-	/*
-	 * Clear the flag that indicates that an update has been reported, as
-	 * we have just collected it.
-	 */
-	sd->set_update_reported(false);
+	if (_generation > generation + _queue_size) {
+		const unsigned skipped = _generation - (generation + _queue_size);
+#ifdef __PX4_NUTTX
+		_lost_messages += skipped;
+#else
+		__atomic_fetch_add(&_lost_messages, skipped, __ATOMIC_RELAXED);
+#endif
+
+		/* single-slot topics only ever hold the latest value, so skipping samples is expected there */
+		if (_queue_size > 1) {
+			lost = skipped;
+		}
+
+		generation = _generation - _queue_size;
+	}
+
+	unsigned n = 0;
+
+	while (generation < _generation && n < max_n) {
+		memcpy(buffer + (_meta->o_size * n), _data + (_meta->o_size * (generation % _queue_size)), _meta->o_size);
+		++generation;
+		++n;
+	}
+
+	return n;
+}
+
+#ifndef __PX4_NUTTX
+bool
+uORB::DeviceNode::read_unlocked(char *buffer, unsigned &generation, const uint8_t **slot, unsigned *slot_seq)
+{
+	for (int attempt = 0; attempt < SEQLOCK_READ_ATTEMPTS; ++attempt) {
+		const unsigned seq = __atomic_load_n(&_seq, __ATOMIC_ACQUIRE);
+
+		if (seq & 1) {
+			/* a publisher is in the middle of a write */
+			continue;
+		}
+
+		/* same queue handling as read_locked(), but on local copies until the read is validated */
+		const unsigned node_generation = _generation;
+		unsigned read_generation = generation;
+		uint32_t lost_messages = 0;
+
+		if (node_generation > read_generation + _queue_size) {
+			lost_messages = node_generation - (read_generation + _queue_size);
+			read_generation = node_generation - _queue_size;
+		}
+
+		if (node_generation == read_generation && read_generation > 0) {
+			--read_generation;
+		}
+
+		const uint8_t *read_slot = _data + (_meta->o_size * (read_generation % _queue_size));
+
+		if (nullptr != buffer) {
+			memcpy(buffer, read_slot, _meta->o_size);
+		}
+
+		/* make sure the copy is complete before checking the sequence count again */
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+		if (__atomic_load_n(&_seq, __ATOMIC_RELAXED) != seq) {
+			continue;
+		}
+
+		if (read_generation < node_generation) {
+			++read_generation;
+		}
+
+		generation = read_generation;
+
+		if (slot != nullptr) {
+			*slot = read_slot;
+			*slot_seq = seq;
+		}
+
+		if (lost_messages > 0) {
+			__atomic_fetch_add(&_lost_messages, lost_messages, __ATOMIC_RELAXED);
+		}
+
+		return true;
+	}
+
+	/* contended: let the caller fall back to the locked copy, which cannot be starved */
+	return false;
+}
+#endif /* __PX4_NUTTX */
+
+const void *
+uORB::DeviceNode::borrow(unsigned &generation, unsigned &borrow_seq)
+{
+#ifdef __PX4_NUTTX
+	/* readers and interrupt-context publishers synchronize with critical sections,
+	 * a view into _data cannot be validated */
+	return nullptr;
+#else
+
+	if (_data == nullptr) {
+		return nullptr;
+	}
+
+	const uint8_t *slot = nullptr;
+
+	if (!read_unlocked(nullptr, generation, &slot, &borrow_seq)) {
+		return nullptr;
+	}
+
+	return slot;
+#endif /* __PX4_NUTTX */
+}
+
+bool
+uORB::DeviceNode::borrow_valid(unsigned borrow_seq) const
+{
+#ifdef __PX4_NUTTX
+	return false;
+#else
+	/* make sure all reads through the view are done before checking the sequence count */
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	return __atomic_load_n(&_seq, __ATOMIC_RELAXED) == borrow_seq;
+#endif
+}
+
+void *
+uORB::DeviceNode::loan()
+{
+#ifdef __PX4_NUTTX
+	/* readers of an in-place write could not be excluded without a long critical section */
+	return nullptr;
+#else
+
+	/* the advertiser always publishes, so the buffer exists already */
+	if (_data == nullptr) {
+		return nullptr;
+	}
+
+	lock();
+	_loaned = true;
+
+	/* odd sequence count: lock-free readers retry or fall back to the lock until commit() */
+	__atomic_store_n(&_seq, _seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	return _data + (_meta->o_size * (_generation % _queue_size));
+#endif /* __PX4_NUTTX */
+}
+
+int
+uORB::DeviceNode::commit()
+{
+#ifdef __PX4_NUTTX
+	/* loan() never succeeds here */
+	return PX4_ERROR;
+#else
+
+	/* without an outstanding loan the lock is not held, _seq and the lock must stay untouched */
+	if (!_loaned) {
+		return PX4_ERROR;
+	}
+
+	_loaned = false;
+	_last_update = hrt_absolute_time();
+	_generation++;
+	_published = true;
+
+	__atomic_store_n(&_seq, _seq + 1, __ATOMIC_RELEASE);
+	unlock();
+
+	poll_notify(POLLIN);
+
+	if (_callbacks != nullptr) {
+		notify_callbacks();
+	}
+
+	return PX4_OK;
+#endif /* __PX4_NUTTX */
+}
+
+bool
+uORB::DeviceNode::copy(void *dst, unsigned &generation)
+{
+	/* nothing to copy before the first publication */
+	if (_data == nullptr) {
+		return false;
+	}
+
+#ifndef __PX4_NUTTX
+
+	if (read_unlocked((char *)dst, generation)) {
+		return true;
+	}
 
+#endif
+
+	ATOMIC_ENTER;
+	read_locked((char *)dst, generation);
 	ATOMIC_LEAVE;
 
-	return _meta->o_size;
+	return true;
 }
 
 ssize_t
@@ -312,6 +544,11 @@ uORB::DeviceNode::write(device::file_t *filp, const char *buffer, size_t buflen)
 
 	/* Perform an atomic copy. */
 	ATOMIC_ENTER;
+#ifndef __PX4_NUTTX
+	/* odd sequence count: lock-free readers retry until the copy is complete */
+	__atomic_store_n(&_seq, _seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+#endif
 	memcpy(_data + (_meta->o_size * (_generation % _queue_size)), buffer, _meta->o_size);
 
 	/* update the timestamp and generation count */
@@ -321,14 +558,59 @@ uORB::DeviceNode::write(device::file_t *filp, const char *buffer, size_t buflen)
 
 	_published = true;
 
+#ifndef __PX4_NUTTX
+	__atomic_store_n(&_seq, _seq + 1, __ATOMIC_RELEASE);
+#endif
 	ATOMIC_LEAVE;
 
 	/* notify any poll waiters */
 	poll_notify(POLLIN);
 
+	/* wake up the consumers waiting for a callback */
+	if (_callbacks != nullptr) {
+		notify_callbacks();
+	}
+
 	return _meta->o_size;
 }
 
+void
+uORB::DeviceNode::notify_callbacks()
+{
+	ATOMIC_ENTER;
+
+	for (SubscriptionCallback *callback = _callbacks; callback != nullptr; callback = callback->_next_callback) {
+		callback->call();
+	}
+
+	ATOMIC_LEAVE;
+}
+
+void
+uORB::DeviceNode::register_callback(SubscriptionCallback *callback)
+{
+	ATOMIC_ENTER;
+	callback->_next_callback = _callbacks;
+	_callbacks = callback;
+	ATOMIC_LEAVE;
+}
+
+void
+uORB::DeviceNode::unregister_callback(SubscriptionCallback *callback)
+{
+	ATOMIC_ENTER;
+
+	for (SubscriptionCallback **p = &_callbacks; *p != nullptr; p = &(*p)->_next_callback) {
+		if (*p == callback) {
+			*p = callback->_next_callback;
+			callback->_next_callback = nullptr;
+			break;
+		}
+	}
+
+	ATOMIC_LEAVE;
+}
+
 int
 uORB::DeviceNode::ioctl(device::file_t *filp, int cmd, unsigned long arg)
 {
@@ -402,6 +684,29 @@ uORB::DeviceNode::ioctl(device::file_t *filp, int cmd, unsigned long arg)
 		//and only one advertiser is allowed to open the DeviceNode at the same time.
 		return update_queue_size(arg);
 
+	case ORBIOCCOPYBATCH: {
+			orb_copy_batch_arg *batch = (orb_copy_batch_arg *)arg;
+			batch->n = 0;
+			batch->lost = 0;
+
+			if (_data == nullptr || batch->buffer == nullptr) {
+				return PX4_OK;
+			}
+
+			/* drain the whole backlog under one lock so that no sample can be overwritten halfway */
+			ATOMIC_ENTER;
+
+			/* rate-limited subscribers only get data once their interval has expired, like orb_check */
+			if (appears_updated(sd)) {
+				batch->n = read_batch_locked((char *)batch->buffer, batch->max_n, sd->generation, batch->lost);
+				sd->set_priority(_priority);
+				sd->set_update_reported(false);
+			}
+
+			ATOMIC_LEAVE;
+			return PX4_OK;
+		}
+
 	case ORBIOCGETINTERVAL:
 		if (sd->update_interval) {
 			*(unsigned *)arg = sd->update_interval->interval;
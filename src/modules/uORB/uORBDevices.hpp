@@ -63,6 +63,7 @@ namespace uORB
 class DeviceNode;
 class DeviceMaster;
 class Manager;
+class SubscriptionCallback;
 }
 
 /**
@@ -188,6 +189,81 @@ public:
 	 */
 	bool print_statistics(bool reset);
 
+	/**
+	 * Copy the next sample without going through the file descriptor layer.
+	 *
+	 * This is used by subscribers holding a direct pointer to the node
+	 * (@see uORB::SubscriptionDirect). The caller keeps its own generation
+	 * count, which is advanced in the same way as for a file descriptor
+	 * subscription. Update intervals are not supported on this path.
+	 *
+	 * @param dst         Destination of size o_size, or nullptr to only advance the generation.
+	 * @param generation  Last generation the caller has seen.
+	 * @return true if data was copied, false if nothing has been published yet
+	 */
+	bool copy(void *dst, unsigned &generation);
+
+	/**
+	 * Get a read-only view of the next sample instead of copying it.
+	 *
+	 * The generation is advanced as for copy(). The view can be overwritten by
+	 * publishers at any time: after reading from it, borrow_valid() must be checked
+	 * and the values discarded if it fails.
+	 *
+	 * @param generation  Last generation the caller has seen.
+	 * @param borrow_seq  Set to the value to pass to borrow_valid().
+	 * @return pointer into the queue, nullptr if nothing has been published yet or
+	 *         borrowing is not supported (NuttX). Use copy() in that case.
+	 */
+	const void *borrow(unsigned &generation, unsigned &borrow_seq);
+
+	/**
+	 * Check that a view returned by borrow() has not been written to since.
+	 */
+	bool borrow_valid(unsigned borrow_seq) const;
+
+	/**
+	 * Start an in-place publication: get a pointer to the queue slot of the next sample.
+	 *
+	 * The node stays locked until commit() is called, so the caller must fill the
+	 * slot quickly and without blocking. The slot holds an old sample, all fields
+	 * must be written.
+	 *
+	 * @return pointer to the slot, nullptr if loaning is not supported (NuttX)
+	 */
+	void *loan();
+
+	/**
+	 * Publish the sample filled in through loan() and unlock the node.
+	 *
+	 * @return PX4_OK, PX4_ERROR if there is no outstanding loan
+	 */
+	int commit();
+
+	/**
+	 * Check whether there is data a direct subscriber at generation has not seen yet.
+	 */
+	bool updated(unsigned generation) const { return _data != nullptr && generation != _generation; }
+
+	/**
+	 * Register a callback that is called after every publication to this node.
+	 *
+	 * The callback runs in the context of the publisher (this can be an interrupt
+	 * on NuttX), with the node locked. It must be short, must not block and must
+	 * not call back into this node.
+	 */
+	void register_callback(SubscriptionCallback *callback);
+
+	/**
+	 * Remove a callback registered with register_callback().
+	 */
+	void unregister_callback(SubscriptionCallback *callback);
+
+	/**
+	 * Time of the last publication.
+	 */
+	hrt_abstime last_update() const { return _last_update; }
+
 	unsigned int get_queue_size() const { return _queue_size; }
 	int16_t subscriber_count() const { return _subscriber_count; }
 	uint32_t lost_message_count() const { return _lost_messages; }
@@ -228,6 +304,11 @@ private:
 	bool _published;  /**< has ever data been published */
 	uint8_t _queue_size; /**< maximum number of elements in the queue */
 	int16_t _subscriber_count;
+	SubscriptionCallback *_callbacks = nullptr; ///< registered callbacks, linked via SubscriptionCallback::_next_callback
+#ifndef __PX4_NUTTX
+	unsigned _seq = 0; /**< write sequence count, odd while a publisher is writing to _data */
+	bool _loaned = false; /**< a loan() is outstanding, the node is locked until commit() */
+#endif
 
 	inline static SubscriberData    *filp_to_sd(device::file_t *filp);
 
@@ -255,6 +336,50 @@ private:
 	 */
 	static void   update_deferred_trampoline(void *arg);
 
+	/**
+	 * Copy the next sample for a reader and advance its generation.
+	 *
+	 * Lock must already be held when calling this.
+	 *
+	 * @param buffer      Destination of size o_size, or nullptr to only advance the generation.
+	 * @param generation  Last generation the reader has seen.
+	 */
+	void      read_locked(char *buffer, unsigned &generation);
+
+	/**
+	 * Copy all samples newer than generation, oldest first. Must be called with the node locked.
+	 * @param buffer  Room for max_n samples.
+	 * @param max_n  Maximum number of samples to copy.
+	 * @param generation  Last generation the reader has seen; advanced past the copied samples.
+	 * @param lost  Set to the number of queued samples that were overwritten before they could be read
+	 *      (always 0 for topics with a queue size of 1).
+	 * @return    Number of samples copied.
+	 */
+	unsigned  read_batch_locked(char *buffer, unsigned max_n, unsigned &generation, uint32_t &lost);
+
+#ifndef __PX4_NUTTX
+	static constexpr int SEQLOCK_READ_ATTEMPTS = 4; ///< lock-free read retries before falling back to the lock
+
+	/**
+	 * Same as read_locked(), but without taking the node lock.
+	 *
+	 * The copy is validated against the publisher's sequence count and only then
+	 * committed to the reader's generation. Must not be used for rate-limited
+	 * subscribers, whose state is also modified from the publisher's poll_notify().
+	 *
+	 * @param slot      If not null, set to the queue slot that was read.
+	 * @param slot_seq  Sequence count at the time of the read, set together with slot.
+	 * @return true on success, false if the read kept racing with publishers
+	 */
+	bool      read_unlocked(char *buffer, unsigned &generation, const uint8_t **slot = nullptr,
+				unsigned *slot_seq = nullptr);
+#endif
+
+	/**
+	 * Call all registered callbacks.
+	 */
+	void      notify_callbacks();
+
 	/**
 	 * Check whether a topic appears updated to a subscriber.
 	 *
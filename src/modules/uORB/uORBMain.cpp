@@ -74,7 +74,7 @@ $ uorb top
 
 	PRINT_MODULE_USAGE_NAME("uorb", "communication");
 	PRINT_MODULE_USAGE_COMMAND("start");
-	PRINT_MODULE_USAGE_COMMAND_DESCR("status", "Print topic statistics");
+	PRINT_MODULE_USAGE_COMMAND_DESCR("status", "Print topic statistics and advertise/subscribe latency");
 	PRINT_MODULE_USAGE_COMMAND_DESCR("top", "Monitor topic publication rates");
 	PRINT_MODULE_USAGE_PARAM_FLAG('a', "print all instead of only currently publishing topics", true);
 	PRINT_MODULE_USAGE_ARG("<filter1> [<filter2>]", "topic(s) to match (implies -a)", true);
@@ -127,6 +127,7 @@ uorb_main(int argc, char *argv[])
 	if (!strcmp(argv[1], "status")) {
 		if (g_dev != nullptr) {
 			g_dev->printStatistics(true);
+			uORB::Manager::get_instance()->print_latency_statistics();
 
 		} else {
 			PX4_INFO("uorb is not running");
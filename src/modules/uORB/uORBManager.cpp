@@ -62,7 +62,9 @@ bool uORB::Manager::initialize()
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 uORB::Manager::Manager()
-	: _comm_channel(nullptr)
+	: _comm_channel(nullptr),
+	  _advertise_perf(perf_alloc(PC_ELAPSED, "uorb_advertise")),
+	  _subscribe_perf(perf_alloc(PC_ELAPSED, "uorb_subscribe"))
 {
 	for (int i = 0; i < Flavor_count; ++i) {
 		_device_masters[i] = nullptr;
@@ -91,6 +93,15 @@ uORB::Manager::~Manager()
 			delete _device_masters[i];
 		}
 	}
+
+	perf_free(_advertise_perf);
+	perf_free(_subscribe_perf);
+}
+
+void uORB::Manager::print_latency_statistics()
+{
+	perf_print_counter(_advertise_perf);
+	perf_print_counter(_subscribe_perf);
 }
 
 uORB::DeviceMaster *uORB::Manager::get_device_master(Flavor flavor)
@@ -174,6 +185,7 @@ orb_advert_t uORB::Manager::orb_advertise_multi(const struct orb_metadata *meta,
 
 	int result, fd;
 	orb_advert_t advertiser;
+	const hrt_abstime start = hrt_absolute_time();
 
 	/* open the node as an advertiser */
 	fd = node_open(PUBSUB, meta, data, true, instance, priority);
@@ -212,6 +224,9 @@ orb_advert_t uORB::Manager::orb_advertise_multi(const struct orb_metadata *meta,
 		return nullptr;
 	}
 
+	/* perf_begin() keeps one start time per counter, concurrent advertisers would overwrite it */
+	perf_set_elapsed(_advertise_perf, hrt_elapsed_time(&start));
+
 	return advertiser;
 }
 
@@ -230,13 +245,73 @@ int uORB::Manager::orb_unadvertise(orb_advert_t handle)
 
 int uORB::Manager::orb_subscribe(const struct orb_metadata *meta)
 {
-	return node_open(PUBSUB, meta, nullptr, false);
+	const hrt_abstime start = hrt_absolute_time();
+	int fd = node_open(PUBSUB, meta, nullptr, false);
+	perf_set_elapsed(_subscribe_perf, hrt_elapsed_time(&start));
+	return fd;
 }
 
 int uORB::Manager::orb_subscribe_multi(const struct orb_metadata *meta, unsigned instance)
 {
+	const hrt_abstime start = hrt_absolute_time();
 	int inst = instance;
-	return node_open(PUBSUB, meta, nullptr, false, &inst);
+	int fd = node_open(PUBSUB, meta, nullptr, false, &inst);
+	perf_set_elapsed(_subscribe_perf, hrt_elapsed_time(&start));
+	return fd;
+}
+
+uORB::DeviceNode *uORB::Manager::orb_get_node(const struct orb_metadata *meta, unsigned instance)
+{
+	if (nullptr == meta) {
+		errno = ENOENT;
+		return nullptr;
+	}
+
+	uORB::DeviceMaster *device_master = get_device_master(PUBSUB);
+
+	if (device_master == nullptr) {
+		return nullptr;
+	}
+
+	const hrt_abstime start = hrt_absolute_time();
+
+	/* instance 0 is created the same way as by orb_subscribe() */
+	int inst = instance;
+	int *instance_ptr = (instance > 0) ? &inst : nullptr;
+	char path[orb_maxpath];
+	int ret = uORB::Utils::node_mkpath(path, PUBSUB, meta, instance_ptr);
+
+	if (ret != PX4_OK) {
+		errno = -ret;
+		return nullptr;
+	}
+
+	uORB::DeviceNode *node = device_master->getDeviceNode(path);
+
+	if (node == nullptr) {
+		/* try to create the node */
+		if (node_advertise(meta, instance_ptr) != PX4_OK) {
+			return nullptr;
+		}
+
+		/* update the path, as it might have been updated during the node_advertise call */
+		ret = uORB::Utils::node_mkpath(path, PUBSUB, meta, instance_ptr);
+
+		if (ret != PX4_OK) {
+			errno = -ret;
+			return nullptr;
+		}
+
+		node = device_master->getDeviceNode(path);
+	}
+
+	if (node == nullptr) {
+		errno = EIO;
+	}
+
+	perf_set_elapsed(_subscribe_perf, hrt_elapsed_time(&start));
+
+	return node;
 }
 
 int uORB::Manager::orb_unsubscribe(int fd)
@@ -257,6 +332,59 @@ int uORB::Manager::orb_publish(const struct orb_metadata *meta, orb_advert_t han
 	return uORB::DeviceNode::publish(meta, handle, data);
 }
 
+void *uORB::Manager::orb_loan(const struct orb_metadata *meta, orb_advert_t handle)
+{
+#ifdef ORB_USE_PUBLISHER_RULES
+
+	if (handle == _Instance) {
+		return nullptr;
+	}
+
+#endif /* ORB_USE_PUBLISHER_RULES */
+
+	uORB::DeviceNode *devnode = (uORB::DeviceNode *)handle;
+
+	if ((devnode == nullptr) || (meta == nullptr) || (devnode->get_meta() != meta)) {
+		errno = EINVAL;
+		return nullptr;
+	}
+
+	/* the remote side needs the data as a message, publish() handles this */
+	if (_comm_channel != nullptr) {
+		return nullptr;
+	}
+
+	return devnode->loan();
+}
+
+int uORB::Manager::orb_commit(const struct orb_metadata *meta, orb_advert_t handle)
+{
+#ifdef ORB_USE_PUBLISHER_RULES
+
+	/* orb_loan() never hands out a buffer for a suppressed publication */
+	if (handle == _Instance) {
+		errno = EINVAL;
+		return ERROR;
+	}
+
+#endif /* ORB_USE_PUBLISHER_RULES */
+
+	uORB::DeviceNode *devnode = (uORB::DeviceNode *)handle;
+
+	if ((devnode == nullptr) || (meta == nullptr) || (devnode->get_meta() != meta)) {
+		errno = EINVAL;
+		return ERROR;
+	}
+
+	if (devnode->commit() != PX4_OK) {
+		/* no outstanding loan */
+		errno = EINVAL;
+		return ERROR;
+	}
+
+	return PX4_OK;
+}
+
 int uORB::Manager::orb_copy(const struct orb_metadata *meta, int handle, void *buffer)
 {
 	int ret;
@@ -275,6 +403,26 @@ int uORB::Manager::orb_copy(const struct orb_metadata *meta, int handle, void *b
 	return PX4_OK;
 }
 
+int uORB::Manager::orb_copy_batch(const struct orb_metadata *meta, int handle, void *buffer, unsigned max_n,
+				  uint32_t *lost)
+{
+	orb_copy_batch_arg batch;
+	batch.buffer = buffer;
+	batch.max_n = max_n;
+	batch.n = 0;
+	batch.lost = 0;
+
+	if (px4_ioctl(handle, ORBIOCCOPYBATCH, (unsigned long)(uintptr_t)&batch) < 0) {
+		return ERROR;
+	}
+
+	if (lost) {
+		*lost = batch.lost;
+	}
+
+	return batch.n;
+}
+
 int uORB::Manager::orb_check(int handle, bool *updated)
 {
 	/* Set to false here so that if `px4_ioctl` fails to false. */
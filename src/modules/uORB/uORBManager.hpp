@@ -46,6 +46,7 @@
 #endif
 
 #include "uORBCommunicator.hpp"
+#include <systemlib/perf_counter.h>
 
 namespace uORB
 {
@@ -178,6 +179,35 @@ public:
 	 */
 	int  orb_publish(const struct orb_metadata *meta, orb_advert_t handle, const void *data) ;
 
+	/**
+	 * Loan the buffer for the next publication, to fill it in place.
+	 *
+	 * This saves the copy of the data into the topic, which is relevant for
+	 * large topics. The topic is locked until orb_commit() is called, so the
+	 * caller must fill in all the fields quickly and without blocking.
+	 *
+	 * Loaning is not available on NuttX, if a multi-ORB communicator is used,
+	 * or for publications suppressed by publisher rules. In these cases nullptr
+	 * is returned and the caller must fill a local struct and use orb_publish().
+	 *
+	 * @param meta    The uORB metadata (usually from the ORB_ID() macro)
+	 *      for the topic.
+	 * @param handle  The handle returned from orb_advertise.
+	 * @return    pointer to o_size bytes to fill, or nullptr (see above).
+	 */
+	void *orb_loan(const struct orb_metadata *meta, orb_advert_t handle);
+
+	/**
+	 * Publish the data filled in after a successful orb_loan().
+	 *
+	 * @param meta    The uORB metadata (usually from the ORB_ID() macro)
+	 *      for the topic.
+	 * @param handle  The handle returned from orb_advertise.
+	 * @return    OK on success, ERROR otherwise with errno set accordingly
+	 *      (EINVAL also if there is no outstanding loan on the handle).
+	 */
+	int  orb_commit(const struct orb_metadata *meta, orb_advert_t handle);
+
 	/**
 	 * Subscribe to a topic.
 	 *
@@ -240,6 +270,21 @@ public:
 	 */
 	int  orb_subscribe_multi(const struct orb_metadata *meta, unsigned instance) ;
 
+	/**
+	 * Get the node of a topic instance for direct access, bypassing the
+	 * file descriptor layer.
+	 *
+	 * Like orb_subscribe_multi(), this succeeds even if the topic has not been
+	 * advertised yet; in that case the node is created. Nodes are never deleted,
+	 * so the returned pointer stays valid.
+	 *
+	 * @param meta    The uORB metadata (usually from the ORB_ID() macro)
+	 *      for the topic.
+	 * @param instance  The instance of the topic.
+	 * @return    nullptr on error, otherwise the node.
+	 */
+	uORB::DeviceNode *orb_get_node(const struct orb_metadata *meta, unsigned instance);
+
 	/**
 	 * Unsubscribe from a topic.
 	 *
@@ -266,6 +311,29 @@ public:
 	 */
 	int  orb_copy(const struct orb_metadata *meta, int handle, void *buffer) ;
 
+	/**
+	 * Fetch all pending samples of a queued topic.
+	 *
+	 * Copies every sample published since the last copy on this handle, oldest
+	 * first, and resets the updated flag like orb_copy. The whole backlog is
+	 * drained under a single node lock, so a publisher cannot overwrite a slot
+	 * in the middle of the batch.
+	 *
+	 * @param meta    The uORB metadata (usually from the ORB_ID() macro)
+	 *      for the topic.
+	 * @param handle  A handle returned from orb_subscribe.
+	 * @param buffer  Room for max_n samples of meta->o_size bytes each.
+	 * @param max_n   Capacity of buffer in samples. Samples that do not fit
+	 *      stay pending for the next call.
+	 * @param lost    If not NULL, set to the number of samples that were
+	 *      overwritten in the queue before this handle could read them.
+	 *      Always 0 for topics that are not queued.
+	 * @return    Number of samples copied (0 if nothing new or the rate
+	 *      limit set by orb_set_interval has not expired yet), ERROR otherwise
+	 *      with errno set accordingly.
+	 */
+	int  orb_copy_batch(const struct orb_metadata *meta, int handle, void *buffer, unsigned max_n, uint32_t *lost);
+
 	/**
 	 * Check whether a topic has been published to since the last orb_copy.
 	 *
@@ -372,6 +440,11 @@ public:
 	 */
 	bool is_remote_subscriber_present(const char *messageName);
 
+	/**
+	 * Print the advertise and subscribe latency statistics.
+	 */
+	void print_latency_statistics();
+
 private: // class methods
 	/**
 	 * Advertise a node; don't consider it an error if the node has
@@ -414,6 +487,9 @@ private: // data members
 
 	DeviceMaster *_device_masters[Flavor_count]; ///< Allow at most one DeviceMaster per Flavor
 
+	perf_counter_t _advertise_perf; ///< time spent in orb_advertise_multi
+	perf_counter_t _subscribe_perf; ///< time spent in orb_subscribe_multi / orb_get_node
+
 private: //class methods
 	Manager();
 	~Manager();
@@ -33,14 +33,18 @@
 
 #include "uORBTest_UnitTest.hpp"
 #include "../uORBCommon.hpp"
+#include "../Subscription.hpp"
 #include <px4_config.h>
 #include <px4_time.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <errno.h>
 #include <poll.h>
 
 ORB_DEFINE(orb_test, struct orb_test, sizeof(orb_test), "ORB_TEST:int val;hrt_abstime time;");
 ORB_DEFINE(orb_multitest, struct orb_test, sizeof(orb_test), "ORB_MULTITEST:int val;hrt_abstime time;");
+ORB_DEFINE(orb_test_direct, struct orb_test, sizeof(orb_test), "ORB_TEST_DIRECT:int val;hrt_abstime time;");
+ORB_DEFINE(orb_test_wakeup, struct orb_test, sizeof(orb_test), "ORB_TEST_WAKEUP:int val;hrt_abstime time;");
 
 ORB_DEFINE(orb_test_medium, struct orb_test_medium, sizeof(orb_test_medium),
 	   "ORB_TEST_MEDIUM:int val;hrt_abstime time;char[64] junk;");
@@ -50,6 +54,10 @@ ORB_DEFINE(orb_test_medium_queue, struct orb_test_medium, sizeof(orb_test_medium
 	   "ORB_TEST_MEDIUM_MULTI:int val;hrt_abstime time;char[64] junk;");
 ORB_DEFINE(orb_test_medium_queue_poll, struct orb_test_medium, sizeof(orb_test_medium),
 	   "ORB_TEST_MEDIUM_MULTI:int val;hrt_abstime time;char[64] junk;");
+ORB_DEFINE(orb_test_medium_queue_batch, struct orb_test_medium, sizeof(orb_test_medium),
+	   "ORB_TEST_MEDIUM_MULTI:int val;hrt_abstime time;char[64] junk;");
+ORB_DEFINE(orb_test_medium_queue_bench, struct orb_test_medium, sizeof(orb_test_medium),
+	   "ORB_TEST_MEDIUM_MULTI:int val;hrt_abstime time;char[64] junk;");
 
 ORB_DEFINE(orb_test_large, struct orb_test_large, sizeof(orb_test_large),
 	   "ORB_TEST_LARGE:int val;hrt_abstime time;char[512] junk;");
@@ -193,7 +201,31 @@ int uORBTest::UnitTest::test()
 		return ret;
 	}
 
-	return test_queue_poll_notify();
+	ret = test_queue_poll_notify();
+
+	if (ret != OK) {
+		return ret;
+	}
+
+	ret = test_queue_batch();
+
+	if (ret != OK) {
+		return ret;
+	}
+
+	ret = test_direct();
+
+	if (ret != OK) {
+		return ret;
+	}
+
+	ret = test_wakeup();
+
+	if (ret != OK) {
+		return ret;
+	}
+
+	return test_loan();
 }
 
 int uORBTest::UnitTest::test_unadvertise()
@@ -812,6 +844,595 @@ int uORBTest::UnitTest::test_queue_poll_notify()
 	return test_note("PASS orb queuing (poll & notify), got %i messages", next_expected_val);
 }
 
+int uORBTest::UnitTest::test_queue_batch()
+{
+	test_note("Testing orb queuing (batch copy)");
+
+	struct orb_test_medium t, u[8];
+	const unsigned int queue_size = 8;
+	uint32_t lost = 0;
+	bool updated;
+
+	int sfd = orb_subscribe(ORB_ID(orb_test_medium_queue_batch));
+
+	if (sfd < 0) {
+		return test_fail("subscribe failed: %d", errno);
+	}
+
+	t.val = 0;
+	orb_advert_t ptopic = orb_advertise_queue(ORB_ID(orb_test_medium_queue_batch), &t, queue_size);
+
+	if (ptopic == nullptr) {
+		return test_fail("advertise failed: %d", errno);
+	}
+
+	int n = orb_copy_batch(ORB_ID(orb_test_medium_queue_batch), sfd, u, queue_size, &lost);
+
+	if (n != 1 || u[0].val != 0 || lost != 0) {
+		return test_fail("initial batch: got %i samples (val %i, lost %u)", n, u[0].val, lost);
+	}
+
+	n = orb_copy_batch(ORB_ID(orb_test_medium_queue_batch), sfd, u, queue_size, &lost);
+
+	if (n != 0) {
+		return test_fail("spurious batch of %i samples", n);
+	}
+
+	test_note("  Testing partial queue...");
+
+	for (int i = 1; i <= 5; ++i) {
+		t.val = i;
+		orb_publish(ORB_ID(orb_test_medium_queue_batch), ptopic, &t);
+	}
+
+	n = orb_copy_batch(ORB_ID(orb_test_medium_queue_batch), sfd, u, queue_size, &lost);
+
+	if (n != 5 || lost != 0) {
+		return test_fail("got %i samples (lost %u), expected 5", n, lost);
+	}
+
+	for (int i = 0; i < n; ++i) {
+		if (u[i].val != i + 1) {
+			return test_fail("sample %i mismatch: %i expected %i", i, u[i].val, i + 1);
+		}
+	}
+
+	orb_check(sfd, &updated);
+
+	if (updated) {
+		return test_fail("updated flag still set after batch");
+	}
+
+	test_note("  Testing overflow...");
+	const int overflow_by = 3;
+
+	for (int i = 0; i < (int)queue_size + overflow_by; ++i) {
+		t.val = 100 + i;
+		orb_publish(ORB_ID(orb_test_medium_queue_batch), ptopic, &t);
+	}
+
+	n = orb_copy_batch(ORB_ID(orb_test_medium_queue_batch), sfd, u, queue_size, &lost);
+
+	if (n != (int)queue_size || lost != (uint32_t)overflow_by) {
+		return test_fail("got %i samples (lost %u), expected %u (lost %i)", n, lost, queue_size, overflow_by);
+	}
+
+	for (int i = 0; i < n; ++i) {
+		if (u[i].val != 100 + overflow_by + i) {
+			return test_fail("sample %i mismatch: %i expected %i", i, u[i].val, 100 + overflow_by + i);
+		}
+	}
+
+	test_note("  Testing small buffer...");
+
+	for (int i = 0; i < 4; ++i) {
+		t.val = 200 + i;
+		orb_publish(ORB_ID(orb_test_medium_queue_batch), ptopic, &t);
+	}
+
+	n = orb_copy_batch(ORB_ID(orb_test_medium_queue_batch), sfd, u, 3, &lost);
+
+	if (n != 3 || u[2].val != 202) {
+		return test_fail("got %i samples, expected 3", n);
+	}
+
+	orb_check(sfd, &updated);
+
+	if (!updated) {
+		return test_fail("update flag not set with samples left");
+	}
+
+	n = orb_copy_batch(ORB_ID(orb_test_medium_queue_batch), sfd, u, 3, nullptr);
+
+	if (n != 1 || u[0].val != 203) {
+		return test_fail("remainder: got %i samples (val %i), expected 1 (val 203)", n, u[0].val);
+	}
+
+	orb_unsubscribe(sfd);
+	orb_unadvertise(ptopic);
+
+	return test_note("PASS orb queuing (batch copy)");
+}
+
+int uORBTest::UnitTest::test_direct()
+{
+	test_note("Testing direct subscription");
+
+	struct orb_test t, u;
+
+	/* subscribe before advertising: the node must be created */
+	uORB::SubscriptionDirect<orb_test> sub(ORB_ID(orb_test_direct));
+
+	if (!sub.valid()) {
+		return test_fail("direct subscribe failed: %d", errno);
+	}
+
+	if (sub.updated() || sub.copy()) {
+		return test_fail("updated before advertise");
+	}
+
+	/* the fd subscription and the advertisement must end up on the same node */
+	int sfd = orb_subscribe(ORB_ID(orb_test_direct));
+	t.val = 1;
+	orb_advert_t ptopic = orb_advertise(ORB_ID(orb_test_direct), &t);
+
+	if (ptopic == nullptr) {
+		return test_fail("advertise failed: %d", errno);
+	}
+
+	if (!sub.updated()) {
+		return test_fail("missing updated flag");
+	}
+
+	if (!sub.update() || sub.get().val != 1) {
+		return test_fail("update(1) mismatch: %d expected %d", sub.get().val, 1);
+	}
+
+	if (sub.updated() || sub.update()) {
+		return test_fail("spurious updated flag");
+	}
+
+	t.val = 2;
+	orb_publish(ORB_ID(orb_test_direct), ptopic, &t);
+	orb_copy(ORB_ID(orb_test_direct), sfd, &u);
+
+	if (u.val != 2) {
+		return test_fail("fd copy mismatch: %d expected %d", u.val, 2);
+	}
+
+	if (!sub.update() || sub.get().val != 2) {
+		return test_fail("update(2) mismatch: %d expected %d", sub.get().val, 2);
+	}
+
+	/* copy() returns the latest data even if it was already seen */
+	if (!sub.copy() || sub.get().val != 2) {
+		return test_fail("copy mismatch: %d expected %d", sub.get().val, 2);
+	}
+
+	orb_unsubscribe(sfd);
+	orb_unadvertise(ptopic);
+
+	return test_note("PASS direct subscription");
+}
+
+int uORBTest::UnitTest::pub_test_wakeup_entry(char *const argv[])
+{
+	uORBTest::UnitTest &t = uORBTest::UnitTest::instance();
+	return t.pub_test_wakeup_main();
+}
+
+int uORBTest::UnitTest::pub_test_wakeup_main()
+{
+	struct orb_test t;
+	t.val = 0;
+	t.time = hrt_absolute_time();
+	orb_advert_t ptopic = orb_advertise(ORB_ID(orb_test_wakeup), &t);
+
+	if (ptopic == nullptr) {
+		_thread_should_exit = true;
+		return test_fail("advertise failed: %d", errno);
+	}
+
+	for (int i = 1; i <= 100; ++i) {
+		usleep(2000);
+		t.val = i;
+		t.time = hrt_absolute_time();
+		orb_publish(ORB_ID(orb_test_wakeup), ptopic, &t);
+	}
+
+	usleep(100 * 1000);
+	_thread_should_exit = true;
+	orb_unadvertise(ptopic);
+
+	return 0;
+}
+
+int uORBTest::UnitTest::test_wakeup()
+{
+	test_note("Testing wakeup subscription");
+
+	uORB::SubscriptionWakeup sub(ORB_ID(orb_test_wakeup));
+
+	if (!sub.registerCallback()) {
+		return test_fail("register callback failed");
+	}
+
+	_thread_should_exit = false;
+
+	char *const args[1] = { nullptr };
+	int pubsub_task = px4_task_spawn_cmd("uorb_test_wakeup",
+					     SCHED_DEFAULT,
+					     SCHED_PRIORITY_MAX - 5,
+					     1500,
+					     (px4_main_t)&uORBTest::UnitTest::pub_test_wakeup_entry,
+					     args);
+
+	if (pubsub_task < 0) {
+		return test_fail("failed launching task");
+	}
+
+	struct orb_test t;
+	int num_received = 0;
+	hrt_abstime latency_sum = 0;
+
+	while (!_thread_should_exit) {
+		if (!sub.wait(500)) {
+			if (_thread_should_exit) {
+				break;
+			}
+
+			return test_fail("wait timeout");
+		}
+
+		sub.update(&t);
+
+		/* skip the initial publication of the advertisement */
+		if (t.val > 0) {
+			latency_sum += hrt_elapsed_time(&t.time);
+			++num_received;
+		}
+	}
+
+	if (num_received < 90) {
+		return test_fail("too few wakeups: %i", num_received);
+	}
+
+	return test_note("PASS wakeup subscription, %i wakeups, mean latency %.1f us", num_received,
+			 (double)latency_sum / num_received);
+}
+
+int uORBTest::UnitTest::test_loan()
+{
+	test_note("Testing loan & borrow");
+
+	struct orb_test_large t, u;
+	t.val = 1;
+	orb_advert_t ptopic = orb_advertise(ORB_ID(orb_test_large), &t);
+
+	if (ptopic == nullptr) {
+		return test_fail("advertise failed: %d", errno);
+	}
+
+	int sfd = orb_subscribe(ORB_ID(orb_test_large));
+	uORB::SubscriptionDirect<orb_test_large> sub(ORB_ID(orb_test_large));
+
+	/* a commit without an outstanding loan must fail and leave the topic usable */
+	if (PX4_OK == orb_commit(ORB_ID(orb_test_large), ptopic)) {
+		return test_fail("commit without loan succeeded");
+	}
+
+	struct orb_test_large *loaned = (struct orb_test_large *)orb_loan(ORB_ID(orb_test_large), ptopic);
+
+	if (loaned == nullptr) {
+		/* not supported on this platform/configuration */
+		orb_unsubscribe(sfd);
+		orb_unadvertise(ptopic);
+		return test_note("SKIP loan & borrow (not supported)");
+	}
+
+	loaned->val = 2;
+	loaned->time = hrt_absolute_time();
+
+	if (PX4_OK != orb_commit(ORB_ID(orb_test_large), ptopic)) {
+		return test_fail("commit failed");
+	}
+
+	if (PX4_OK == orb_commit(ORB_ID(orb_test_large), ptopic)) {
+		return test_fail("second commit succeeded");
+	}
+
+	if (PX4_OK != orb_copy(ORB_ID(orb_test_large), sfd, &u) || u.val != 2) {
+		return test_fail("copy after commit mismatch: %d expected %d", u.val, 2);
+	}
+
+	const orb_test_large *view = sub.borrow();
+
+	if (view == nullptr || view->val != 2 || !sub.borrowValid()) {
+		return test_fail("borrow mismatch");
+	}
+
+	if (sub.updated()) {
+		return test_fail("spurious updated flag after borrow");
+	}
+
+	/* a new publication must invalidate the view */
+	t.val = 3;
+	orb_publish(ORB_ID(orb_test_large), ptopic, &t);
+
+	if (sub.borrowValid()) {
+		return test_fail("borrowed view still valid after publish");
+	}
+
+	orb_unsubscribe(sfd);
+	orb_unadvertise(ptopic);
+
+	return test_note("PASS loan & borrow");
+}
+
+int uORBTest::UnitTest::copy_latency_entry(int argc, char *argv[])
+{
+	uORBTest::UnitTest &t = uORBTest::UnitTest::instance();
+	/* the subscriber index is the last argument (NuttX passes the task name first) */
+	return t.copy_latency_main(atoi(argv[argc - 1]));
+}
+
+int uORBTest::UnitTest::copy_latency_main(int index)
+{
+	struct orb_test_medium t;
+	int sfd = orb_subscribe(ORB_ID(orb_test_medium));
+
+	_copy_test_total_us[index] = 0;
+	_copy_test_max_us[index] = 0;
+	_copy_test_count[index] = 0;
+
+	while (!_copy_test_should_exit) {
+		/* copy back-to-back to maximize contention with the publisher and the other subscribers */
+		hrt_abstime start = hrt_absolute_time();
+		orb_copy(ORB_ID(orb_test_medium), sfd, &t);
+		uint32_t elapsed = (uint32_t)hrt_elapsed_time(&start);
+
+		_copy_test_total_us[index] += elapsed;
+		_copy_test_count[index]++;
+
+		if (elapsed > _copy_test_max_us[index]) {
+			_copy_test_max_us[index] = elapsed;
+		}
+
+		if ((_copy_test_count[index] % 100) == 0) {
+			usleep(1);
+		}
+	}
+
+	orb_unsubscribe(sfd);
+
+	/* the subscriber tasks finish concurrently, release makes the statistics visible to the waiter */
+	__atomic_fetch_add(&_copy_test_num_done, 1, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+int uORBTest::UnitTest::copy_latency_test(int num_subscribers)
+{
+	test_note("---------------- COPY LATENCY TEST ------------------");
+
+	if (num_subscribers < 1 || num_subscribers > MAX_COPY_SUBSCRIBERS) {
+		return test_fail("number of subscribers must be in [1, %i]", MAX_COPY_SUBSCRIBERS);
+	}
+
+	struct orb_test_medium t;
+	t.val = 0;
+	t.time = hrt_absolute_time();
+
+	orb_advert_t ptopic = orb_advertise(ORB_ID(orb_test_medium), &t);
+
+	if (ptopic == nullptr) {
+		return test_fail("advertise failed: %d", errno);
+	}
+
+	_copy_test_should_exit = false;
+	__atomic_store_n(&_copy_test_num_done, 0, __ATOMIC_RELAXED);
+
+	for (int i = 0; i < num_subscribers; ++i) {
+		char index_str[8];
+		snprintf(index_str, sizeof(index_str), "%i", i);
+		char *const args[2] = { index_str, nullptr };
+		int task = px4_task_spawn_cmd("uorb_copy_sub",
+					      SCHED_DEFAULT,
+					      SCHED_PRIORITY_MAX - 5,
+					      1500,
+					      (px4_main_t)&uORBTest::UnitTest::copy_latency_entry,
+					      args);
+
+		if (task < 0) {
+			_copy_test_should_exit = true;
+			return test_fail("failed launching task");
+		}
+	}
+
+	/* publish at 1 kHz for 2 seconds */
+	for (int i = 0; i < 2000; ++i) {
+		t.val = i;
+		t.time = hrt_absolute_time();
+		orb_publish(ORB_ID(orb_test_medium), ptopic, &t);
+		usleep(1000);
+	}
+
+	_copy_test_should_exit = true;
+
+	/* the subscribers copy at most 100 times before they check the exit flag again */
+	int wait_count = 0;
+
+	while (__atomic_load_n(&_copy_test_num_done, __ATOMIC_ACQUIRE) < num_subscribers) {
+		if (++wait_count > 200) {
+			orb_unadvertise(ptopic);
+			return test_fail("subscribers did not finish within 2 s");
+		}
+
+		usleep(10000);
+	}
+
+	orb_unadvertise(ptopic);
+
+	uint64_t total_us = 0;
+	uint64_t total_count = 0;
+	uint32_t max_us = 0;
+
+	for (int i = 0; i < num_subscribers; ++i) {
+		total_us += _copy_test_total_us[i];
+		total_count += _copy_test_count[i];
+
+		if (_copy_test_max_us[i] > max_us) {
+			max_us = _copy_test_max_us[i];
+		}
+	}
+
+	if (total_count == 0) {
+		return test_fail("no copies done");
+	}
+
+	test_note("%i subscribers: %" PRIu64 " copies, mean: %8.4f us, max: %u us", num_subscribers, total_count,
+		  (double)total_us / total_count, max_us);
+
+	return PX4_OK;
+}
+
+int uORBTest::UnitTest::pub_queue_bench_entry(char *const argv[])
+{
+	uORBTest::UnitTest &t = uORBTest::UnitTest::instance();
+	return t.pub_queue_bench_main();
+}
+
+int uORBTest::UnitTest::pub_queue_bench_main()
+{
+	struct orb_test_medium t;
+	t.val = 0;
+	t.time = hrt_absolute_time();
+
+	orb_advert_t ptopic = orb_advertise_queue(ORB_ID(orb_test_medium_queue_bench), &t, QUEUE_BENCH_SIZE);
+
+	if (ptopic == nullptr) {
+		_thread_should_exit = true;
+		return test_fail("advertise failed: %d", errno);
+	}
+
+	/* publish at 1 kHz for 2 seconds */
+	for (int i = 1; i <= 2000; ++i) {
+		usleep(1000);
+		t.val = i;
+		t.time = hrt_absolute_time();
+		orb_publish(ORB_ID(orb_test_medium_queue_bench), ptopic, &t);
+	}
+
+	_num_messages_sent = t.val + 1;
+	usleep(50 * 1000);
+	_thread_should_exit = true;
+	orb_unadvertise(ptopic);
+
+	return 0;
+}
+
+int uORBTest::UnitTest::queue_batch_run(bool batch)
+{
+	struct orb_test_medium u[QUEUE_BENCH_SIZE];
+	int sfd = orb_subscribe(ORB_ID(orb_test_medium_queue_bench));
+
+	if (sfd < 0) {
+		return test_fail("subscribe failed: %d", errno);
+	}
+
+	_thread_should_exit = false;
+	_num_messages_sent = 0;
+
+	char *const args[1] = { nullptr };
+	int pub_task = px4_task_spawn_cmd("uorb_queue_bench",
+					  SCHED_DEFAULT,
+					  SCHED_PRIORITY_MAX - 5,
+					  1500,
+					  (px4_main_t)&uORBTest::UnitTest::pub_queue_bench_entry,
+					  args);
+
+	if (pub_task < 0) {
+		orb_unsubscribe(sfd);
+		return test_fail("failed launching task");
+	}
+
+	uint64_t total_us = 0;
+	uint32_t max_us = 0;
+	int received = 0;
+	int calls = 0;
+	int next_expected_val = 0;
+	int lost = 0;
+
+	while (!_thread_should_exit) {
+		/* let about 10 samples pile up, like a consumer running at 100 Hz */
+		usleep(10 * 1000);
+
+		hrt_abstime start = hrt_absolute_time();
+		int n = 0;
+
+		if (batch) {
+			n = orb_copy_batch(ORB_ID(orb_test_medium_queue_bench), sfd, u, QUEUE_BENCH_SIZE, nullptr);
+			++calls;
+
+		} else {
+			bool updated = true;
+
+			while (n < (int)QUEUE_BENCH_SIZE) {
+				orb_check(sfd, &updated);
+				++calls;
+
+				if (!updated) {
+					break;
+				}
+
+				orb_copy(ORB_ID(orb_test_medium_queue_bench), sfd, &u[n++]);
+				++calls;
+			}
+		}
+
+		uint32_t elapsed = (uint32_t)hrt_elapsed_time(&start);
+		total_us += elapsed;
+
+		if (elapsed > max_us) {
+			max_us = elapsed;
+		}
+
+		for (int i = 0; i < n; ++i) {
+			if (u[i].val > next_expected_val) {
+				lost += u[i].val - next_expected_val;
+			}
+
+			next_expected_val = u[i].val + 1;
+		}
+
+		received += n;
+	}
+
+	orb_unsubscribe(sfd);
+
+	if (received == 0) {
+		return test_fail("no samples received");
+	}
+
+	test_note("%s: %i/%i samples, %i lost, %i calls, %8.4f us/sample, max drain: %u us",
+		  batch ? "orb_copy_batch  " : "orb_check + copy", received, (int)_num_messages_sent, lost, calls,
+		  (double)total_us / received, max_us);
+
+	return PX4_OK;
+}
+
+int uORBTest::UnitTest::queue_batch_test()
+{
+	test_note("---------------- QUEUE BATCH TEST ------------------");
+
+	int ret = queue_batch_run(false);
+
+	if (ret != PX4_OK) {
+		return ret;
+	}
+
+	return queue_batch_run(true);
+}
 
 int uORBTest::UnitTest::test_fail(const char *fmt, ...)
 {
@@ -44,6 +44,8 @@ struct orb_test {
 };
 ORB_DECLARE(orb_test);
 ORB_DECLARE(orb_multitest);
+ORB_DECLARE(orb_test_direct);
+ORB_DECLARE(orb_test_wakeup);
 
 
 struct orb_test_medium {
@@ -55,6 +57,8 @@ ORB_DECLARE(orb_test_medium);
 ORB_DECLARE(orb_test_medium_multi);
 ORB_DECLARE(orb_test_medium_queue);
 ORB_DECLARE(orb_test_medium_queue_poll);
+ORB_DECLARE(orb_test_medium_queue_batch);
+ORB_DECLARE(orb_test_medium_queue_bench);
 
 struct orb_test_large {
 	int val;
@@ -78,6 +82,8 @@ public:
 	~UnitTest() {}
 	int test();
 	template<typename S> int latency_test(orb_id_t T, bool print);
+	int copy_latency_test(int num_subscribers);
+	int queue_batch_test();
 	int info();
 
 private:
@@ -114,8 +120,32 @@ private:
 	static int pub_test_queue_entry(char *const argv[]);
 	int pub_test_queue_main();
 	int test_queue_poll_notify();
+	int test_queue_batch();
+
+	int test_direct();
+
+	int test_wakeup();
+	int test_loan();
+	static int pub_test_wakeup_entry(char *const argv[]);
+	int pub_test_wakeup_main();
 	volatile int _num_messages_sent = 0;
 
+	/* orb_copy latency with concurrent subscribers */
+	static constexpr int MAX_COPY_SUBSCRIBERS = 16;
+	static int copy_latency_entry(int argc, char *argv[]);
+	int copy_latency_main(int index);
+	volatile bool _copy_test_should_exit = false;
+	int _copy_test_num_done = 0; ///< only accessed with __atomic builtins
+	uint64_t _copy_test_total_us[MAX_COPY_SUBSCRIBERS];
+	uint32_t _copy_test_max_us[MAX_COPY_SUBSCRIBERS];
+	uint32_t _copy_test_count[MAX_COPY_SUBSCRIBERS];
+
+	/* draining a queued topic published at 1 kHz, batched vs one sample per call */
+	static constexpr unsigned QUEUE_BENCH_SIZE = 16;
+	static int pub_queue_bench_entry(char *const argv[]);
+	int pub_queue_bench_main();
+	int queue_batch_run(bool batch);
+
 	int test_fail(const char *fmt, ...);
 	int test_note(const char *fmt, ...);
 };
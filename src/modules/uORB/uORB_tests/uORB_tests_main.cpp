@@ -32,6 +32,7 @@
  ****************************************************************************/
 
 #include <string.h>
+#include <stdlib.h>
 #include "../uORBDevices.hpp"
 #include "../uORB.h"
 #include "../uORBCommon.hpp"
@@ -44,7 +45,7 @@ extern "C" { __EXPORT int uorb_tests_main(int argc, char *argv[]); }
 
 static void usage()
 {
-	PX4_INFO("Usage: uorb_tests [latency_test]");
+	PX4_INFO("Usage: uorb_tests [latency_test|copy_latency_test [<num_subscribers>]|queue_batch_test]");
 }
 
 int
@@ -90,6 +91,30 @@ uorb_tests_main(int argc, char *argv[])
 		}
 	}
 
+	/*
+	 * Test the orb_copy latency with concurrent subscribers.
+	 */
+	if (argc > 1 && !strcmp(argv[1], "copy_latency_test")) {
+
+		uORBTest::UnitTest &t = uORBTest::UnitTest::instance();
+		int num_subscribers = 4;
+
+		if (argc > 2) {
+			num_subscribers = atoi(argv[2]);
+		}
+
+		return t.copy_latency_test(num_subscribers);
+	}
+
+	/*
+	 * Test draining a queued topic in batches.
+	 */
+	if (argc > 1 && !strcmp(argv[1], "queue_batch_test")) {
+
+		uORBTest::UnitTest &t = uORBTest::UnitTest::instance();
+		return t.queue_batch_test();
+	}
+
 #endif
 
 	usage();
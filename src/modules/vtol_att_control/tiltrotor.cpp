@@ -201,6 +201,16 @@ Tiltrotor::parameters_update()
 
 }
 
+bool
+Tiltrotor::parameters_changed(uint32_t generation)
+{
+	static_assert(sizeof(_params_handles_tiltrotor) % sizeof(param_t) == 0,
+		      "_params_handles_tiltrotor must only hold param_t handles");
+
+	return param_changed_since((const param_t *)&_params_handles_tiltrotor,
+				   sizeof(_params_handles_tiltrotor) / sizeof(param_t), generation, nullptr) > 0;
+}
+
 int Tiltrotor::get_motor_off_channels(int channels)
 {
 	int channel_bitmap = 0;
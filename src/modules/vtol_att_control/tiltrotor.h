@@ -186,5 +186,7 @@ private:
 	 */
 	virtual void parameters_update();
 
+	virtual bool parameters_changed(uint32_t generation);
+
 };
 #endif
@@ -95,7 +95,9 @@ VtolAttitudeControl::VtolAttitudeControl() :
 	/******************************************/
 
 	_transition_command(vtol_vehicle_status_s::VEHICLE_VTOL_STATE_MC),
-	_abort_front_transition(false)                         //初始化列表，避免野指针
+	_abort_front_transition(false),                         //初始化列表，避免野指针
+	_params_generation(0),
+	_params_perf(perf_alloc(PC_ELAPSED, "vtol_att_control params"))
 
 {/*执行构造函数时，飞行器应处于MC（/直升机）状态*/
 	memset(& _vtol_vehicle_status, 0, sizeof(_vtol_vehicle_status));
@@ -198,6 +200,8 @@ VtolAttitudeControl::~VtolAttitudeControl()//照应构造函数，析构函数
 		delete _vtol_type;             
 	}
 
+	perf_free(_params_perf);
+
 	VTOL_att_control::g_control = nullptr;
 }
 
@@ -368,8 +372,27 @@ VtolAttitudeControl::parameters_update_poll()
 	if (updated) {
 		struct parameter_update_s param_update;
 		orb_copy(ORB_ID(parameter_update), _params_sub, &param_update);
-		parameters_update();  //没有传参?
+
+		if (parameters_changed()) {
+			parameters_update();  //没有传参?
+		}
+	}
+}
+
+/**
+* Check whether a parameter of this module or of the vtol type changed since the last reload.
+*/
+bool
+VtolAttitudeControl::parameters_changed()
+{
+	static_assert(sizeof(_params_handles) % sizeof(param_t) == 0, "_params_handles must only hold param_t handles");
+
+	if (param_changed_since((const param_t *)&_params_handles, sizeof(_params_handles) / sizeof(param_t),
+				_params_generation, nullptr) > 0) {
+		return true;
 	}
+
+	return _vtol_type != nullptr && _vtol_type->parameters_changed(_params_generation);
 }
 
 /**
@@ -531,6 +554,10 @@ VtolAttitudeControl::parameters_update()
 {
 	float v;
 	int l;
+
+	perf_begin(_params_perf);
+	_params_generation = param_generation();
+
 	/* idle pwm for mc mode */
 	param_get(_params_handles.idle_pwm_mc, &_params.idle_pwm_mc);
 
@@ -603,6 +630,8 @@ VtolAttitudeControl::parameters_update()
 		_vtol_type->parameters_update();  //对应tiltrotor::parameters_update()
 	}
 
+	perf_end(_params_perf);
+
 	return OK;
 }
 
@@ -749,7 +778,9 @@ void VtolAttitudeControl::task_main()
 			orb_copy(ORB_ID(parameter_update), _params_sub, &update);
 
 			/* update parameters from storage */
-			parameters_update();//私有成员函数
+			if (parameters_changed()) {
+				parameters_update();//私有成员函数
+			}
 		}
 
 		_vtol_vehicle_status.fw_permanent_stab = (_params.vtol_fw_permanent_stab == 1);//为什么要先后两次判断？并行的原因？
@@ -61,6 +61,7 @@
 #include <lib/mathlib/mathlib.h>
 #include <systemlib/err.h>
 #include <systemlib/param/param.h>
+#include <systemlib/perf_counter.h>
 #include <systemlib/systemlib.h>
 
 #include <uORB/topics/actuator_armed.h>
@@ -225,6 +226,9 @@ private:
 	int _transition_command;
 	bool _abort_front_transition;
 
+	uint32_t _params_generation;	// parameter generation of the last reload
+	perf_counter_t _params_perf;	// parameter reload performance counter
+
 	VtolType *_vtol_type = nullptr;	// base class for different vtol types
 
 //*****************Member functions***********************************************************************
@@ -250,6 +254,7 @@ private:
 	void		tecs_status_poll();
 	void		land_detected_poll();
 	void 		parameters_update_poll();		//Check if parameters have changed
+	bool 		parameters_changed();			//Check if any of our or the vtol type's parameters changed
 	int 		parameters_update();			//Update local paraemter cache
 	void 		fill_mc_att_rates_sp();
 	void 		fill_fw_att_rates_sp();
@@ -153,6 +153,12 @@ public:
 
 	virtual void parameters_update() = 0;
 
+	/**
+	 * Returns true if one of the type specific parameters changed after generation.
+	 * Types which do not track their handles always ask for a reload.
+	 */
+	virtual bool parameters_changed(uint32_t generation) { return true; }
+
 protected:
 	VtolAttitudeControl *_attc;
 	mode _vtol_mode;
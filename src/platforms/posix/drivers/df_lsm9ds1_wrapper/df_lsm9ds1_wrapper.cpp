@@ -105,12 +105,19 @@ public:
 	void		info();
 
 private:
-	int _publish(struct imu_sensor_data &data);
+	int _publishBatch(const struct imu_sensor_sample *samples, unsigned num_samples,
+			  struct imu_sensor_data &data);
 
 	void _update_accel_calibration();
 	void _update_gyro_calibration();
 	void _update_mag_calibration();
 
+	/**
+	 * Fold rotation and calibration into one transform per sensor so that
+	 * a sample only costs a matrix-vector product.
+	 */
+	void _update_sample_transforms();
+
 	orb_advert_t		    _accel_topic;
 	orb_advert_t		    _gyro_topic;
 	orb_advert_t        	    _mag_topic;
@@ -146,6 +153,10 @@ private:
 	} _mag_calibration;
 
 	math::Matrix<3, 3>	    _rotation_matrix;
+	math::Matrix<3, 3>	    _accel_transform;
+	math::Vector<3>		    _accel_bias;
+	math::Matrix<3, 3>	    _gyro_transform;
+	math::Vector<3>		    _gyro_bias;
 	int			    _accel_orb_class_instance;
 	int			    _gyro_orb_class_instance;
 	int         _mag_orb_class_instance;
@@ -162,6 +173,10 @@ private:
 	perf_counter_t		    _gyro_range_hit_counter;
 	perf_counter_t		    _accel_range_hit_counter;
 	perf_counter_t		    _publish_perf;
+	perf_counter_t		    _sample_counter;
+	perf_counter_t		    _batch_perf;
+
+	uint64_t		    _batch_elapsed_total;
 
 	hrt_abstime		    _last_accel_range_hit_time;
 	uint64_t		    _last_accel_range_hit_count;
@@ -192,6 +207,9 @@ DfLsm9ds1Wrapper::DfLsm9ds1Wrapper(bool mag_enabled, enum Rotation rotation) :
 	_gyro_range_hit_counter(perf_alloc(PC_COUNT, "lsm9ds1_gyro_range_hits")),
 	_accel_range_hit_counter(perf_alloc(PC_COUNT, "lsm9ds1_accel_range_hits")),
 	_publish_perf(perf_alloc(PC_ELAPSED, "lsm9ds1_publish")),
+	_sample_counter(perf_alloc(PC_COUNT, "lsm9ds1_samples")),
+	_batch_perf(perf_alloc(PC_ELAPSED, "lsm9ds1_batch")),
+	_batch_elapsed_total(0),
 	_last_accel_range_hit_time(0),
 	_last_accel_range_hit_count(0),
 	_mag_enabled(mag_enabled)
@@ -222,6 +240,8 @@ DfLsm9ds1Wrapper::DfLsm9ds1Wrapper(bool mag_enabled, enum Rotation rotation) :
 
 	// Get sensor rotation matrix
 	get_rot_matrix(rotation, &_rotation_matrix);
+
+	_update_sample_transforms();
 }
 
 DfLsm9ds1Wrapper::~DfLsm9ds1Wrapper()
@@ -234,6 +254,8 @@ DfLsm9ds1Wrapper::~DfLsm9ds1Wrapper()
 	perf_free(_accel_range_hit_counter);
 
 	perf_free(_publish_perf);
+	perf_free(_sample_counter);
+	perf_free(_batch_perf);
 }
 
 int DfLsm9ds1Wrapper::start()
@@ -295,6 +317,7 @@ int DfLsm9ds1Wrapper::start()
 	_update_accel_calibration();
 	_update_gyro_calibration();
 	_update_mag_calibration();
+	_update_sample_transforms();
 
 	return 0;
 }
@@ -322,6 +345,14 @@ void DfLsm9ds1Wrapper::info()
 	perf_print_counter(_accel_range_hit_counter);
 
 	perf_print_counter(_publish_perf);
+	perf_print_counter(_sample_counter);
+	perf_print_counter(_batch_perf);
+
+	const uint64_t samples = perf_event_count(_sample_counter);
+
+	if (samples > 0) {
+		PX4_INFO("ingest cost: %.3f us per sample", (double)_batch_elapsed_total / samples);
+	}
 }
 
 void DfLsm9ds1Wrapper::_update_gyro_calibration()
@@ -555,8 +586,32 @@ void DfLsm9ds1Wrapper::_update_mag_calibration()
 	_mag_calibration.z_offset = 0.0f;
 }
 
-int DfLsm9ds1Wrapper::_publish(struct imu_sensor_data &data)
+void DfLsm9ds1Wrapper::_update_sample_transforms()
 {
+	// Calibration is applied after rotation: S * (R * v - o) = (S * R) * v - S * o
+	const float accel_scale[3] = {_accel_calibration.x_scale, _accel_calibration.y_scale, _accel_calibration.z_scale};
+	const float accel_offset[3] = {_accel_calibration.x_offset, _accel_calibration.y_offset, _accel_calibration.z_offset};
+	const float gyro_scale[3] = {_gyro_calibration.x_scale, _gyro_calibration.y_scale, _gyro_calibration.z_scale};
+	const float gyro_offset[3] = {_gyro_calibration.x_offset, _gyro_calibration.y_offset, _gyro_calibration.z_offset};
+
+	for (unsigned i = 0; i < 3; ++i) {
+		for (unsigned j = 0; j < 3; ++j) {
+			_accel_transform(i, j) = accel_scale[i] * _rotation_matrix(i, j);
+			_gyro_transform(i, j) = gyro_scale[i] * _rotation_matrix(i, j);
+		}
+
+		_accel_bias(i) = accel_scale[i] * accel_offset[i];
+		_gyro_bias(i) = gyro_scale[i] * gyro_offset[i];
+	}
+}
+
+int DfLsm9ds1Wrapper::_publishBatch(const struct imu_sensor_sample *samples, unsigned num_samples,
+				    struct imu_sensor_data &data)
+{
+	if (num_samples == 0) {
+		return 0;
+	}
+
 	/* Check if calibration values are still up-to-date. */
 	bool updated;
 	orb_check(_param_update_sub, &updated);
@@ -567,36 +622,37 @@ int DfLsm9ds1Wrapper::_publish(struct imu_sensor_data &data)
 
 		_update_accel_calibration();
 		_update_gyro_calibration();
+		_update_sample_transforms();
 	}
 
+	const hrt_abstime batch_start = hrt_absolute_time();
+
+	// Rotate, calibrate and integrate every sample of the burst.
 	math::Vector<3> vec_integrated_unused;
 	uint64_t integral_dt_unused;
-	math::Vector<3> accel_val(data.accel_m_s2_x,
-				  data.accel_m_s2_y,
-				  data.accel_m_s2_z);
-	// apply sensor rotation on the accel measurement
-	accel_val = _rotation_matrix * accel_val;
-	// Apply calibration after rotation
-	accel_val(0) = (accel_val(0) - _accel_calibration.x_offset) * _accel_calibration.x_scale;
-	accel_val(1) = (accel_val(1) - _accel_calibration.y_offset) * _accel_calibration.y_scale;
-	accel_val(2) = (accel_val(2) - _accel_calibration.z_offset) * _accel_calibration.z_scale;
-	_accel_int.put_with_interval(data.fifo_sample_interval_us,
-				     accel_val,
-				     vec_integrated_unused,
-				     integral_dt_unused);
-	math::Vector<3> gyro_val(data.gyro_rad_s_x,
-				 data.gyro_rad_s_y,
-				 data.gyro_rad_s_z);
-	// apply sensor rotation on the gyro measurement
-	gyro_val = _rotation_matrix * gyro_val;
-	// Apply calibration after rotation
-	gyro_val(0) = (gyro_val(0) - _gyro_calibration.x_offset) * _gyro_calibration.x_scale;
-	gyro_val(1) = (gyro_val(1) - _gyro_calibration.y_offset) * _gyro_calibration.y_scale;
-	gyro_val(2) = (gyro_val(2) - _gyro_calibration.z_offset) * _gyro_calibration.z_scale;
-	_gyro_int.put_with_interval(data.fifo_sample_interval_us,
-				    gyro_val,
-				    vec_integrated_unused,
-				    integral_dt_unused);
+
+	for (unsigned i = 0; i < num_samples; ++i) {
+		const struct imu_sensor_sample &sample = samples[i];
+
+		math::Vector<3> accel_val(sample.accel_m_s2_x, sample.accel_m_s2_y, sample.accel_m_s2_z);
+		accel_val = _accel_transform * accel_val - _accel_bias;
+		_accel_int.put_with_interval(data.fifo_sample_interval_us,
+					     accel_val,
+					     vec_integrated_unused,
+					     integral_dt_unused);
+
+		math::Vector<3> gyro_val(sample.gyro_rad_s_x, sample.gyro_rad_s_y, sample.gyro_rad_s_z);
+		gyro_val = _gyro_transform * gyro_val - _gyro_bias;
+		_gyro_int.put_with_interval(data.fifo_sample_interval_us,
+					    gyro_val,
+					    vec_integrated_unused,
+					    integral_dt_unused);
+	}
+
+	const hrt_abstime batch_elapsed = hrt_absolute_time() - batch_start;
+	perf_set_elapsed(_batch_perf, batch_elapsed);
+	_batch_elapsed_total += batch_elapsed;
+	perf_set_count(_sample_counter, perf_event_count(_sample_counter) + num_samples);
 
 	// The driver empties the FIFO buffer at 1kHz, however we only need to publish at 250Hz.
 	// Therefore, only publish every forth time.
@@ -111,12 +111,19 @@ public:
 	void		info();
 
 private:
-	int _publish(struct imu_sensor_data &data);
+	int _publishBatch(const struct imu_sensor_sample *samples, unsigned num_samples,
+			  struct imu_sensor_data &data);
 
 	void _update_accel_calibration();
 	void _update_gyro_calibration();
 	void _update_mag_calibration();
 
+	/**
+	 * Fold rotation and calibration into one transform per sensor so that
+	 * a sample only costs a matrix-vector product.
+	 */
+	void _update_sample_transforms();
+
 	orb_advert_t		    _accel_topic;
 	orb_advert_t		    _gyro_topic;
 	orb_advert_t		    _mag_topic;
@@ -152,6 +159,12 @@ private:
 		float z_scale;
 	} _mag_calibration;
 
+	math::Matrix<3, 3>	    _rotation_matrix;
+	math::Matrix<3, 3>	    _accel_transform;
+	math::Vector<3>		    _accel_bias;
+	math::Matrix<3, 3>	    _gyro_transform;
+	math::Vector<3>		    _gyro_bias;
+
 	int			    _accel_orb_class_instance;
 	int			    _gyro_orb_class_instance;
 	int			    _mag_orb_class_instance;
@@ -176,6 +189,10 @@ private:
 	perf_counter_t		    _accel_range_hit_counter;
 	perf_counter_t		    _mag_fifo_overflow_counter;
 	perf_counter_t		    _publish_perf;
+	perf_counter_t		    _sample_counter;
+	perf_counter_t		    _batch_perf;
+
+	uint64_t		    _batch_elapsed_total;
 
 	hrt_abstime		    _last_accel_range_hit_time;
 	uint64_t		    _last_accel_range_hit_count;
@@ -215,6 +232,9 @@ DfMpu9250Wrapper::DfMpu9250Wrapper(bool mag_enabled, enum Rotation rotation) :
 	_accel_range_hit_counter(perf_alloc(PC_COUNT, "mpu9250_accel_range_hits")),
 	_mag_fifo_overflow_counter(perf_alloc(PC_COUNT, "mpu9250_mag_fifo_overflows")),
 	_publish_perf(perf_alloc(PC_ELAPSED, "mpu9250_publish")),
+	_sample_counter(perf_alloc(PC_COUNT, "mpu9250_samples")),
+	_batch_perf(perf_alloc(PC_ELAPSED, "mpu9250_batch")),
+	_batch_elapsed_total(0),
 	_last_accel_range_hit_time(0),
 	_last_accel_range_hit_count(0),
 	_mag_enabled(mag_enabled),
@@ -243,6 +263,11 @@ DfMpu9250Wrapper::DfMpu9250Wrapper(bool mag_enabled, enum Rotation rotation) :
 		_mag_calibration.y_offset = 0.0f;
 		_mag_calibration.z_offset = 0.0f;
 	}
+
+	// Get sensor rotation matrix
+	get_rot_matrix(rotation, &_rotation_matrix);
+
+	_update_sample_transforms();
 }
 
 DfMpu9250Wrapper::~DfMpu9250Wrapper()
@@ -259,6 +284,8 @@ DfMpu9250Wrapper::~DfMpu9250Wrapper()
 	}
 
 	perf_free(_publish_perf);
+	perf_free(_sample_counter);
+	perf_free(_batch_perf);
 }
 
 int DfMpu9250Wrapper::start()
@@ -312,6 +339,7 @@ int DfMpu9250Wrapper::start()
 	_update_accel_calibration();
 	_update_gyro_calibration();
 	_update_mag_calibration();
+	_update_sample_transforms();
 
 	return 0;
 }
@@ -343,6 +371,14 @@ void DfMpu9250Wrapper::info()
 	}
 
 	perf_print_counter(_publish_perf);
+	perf_print_counter(_sample_counter);
+	perf_print_counter(_batch_perf);
+
+	const uint64_t samples = perf_event_count(_sample_counter);
+
+	if (samples > 0) {
+		PX4_INFO("ingest cost: %.3f us per sample", (double)_batch_elapsed_total / samples);
+	}
 }
 
 void DfMpu9250Wrapper::_update_gyro_calibration()
@@ -576,8 +612,32 @@ void DfMpu9250Wrapper::_update_mag_calibration()
 	_mag_calibration.z_offset = 0.0f;
 }
 
-int DfMpu9250Wrapper::_publish(struct imu_sensor_data &data)
+void DfMpu9250Wrapper::_update_sample_transforms()
+{
+	// Calibration is applied after rotation: S * (R * v - o) = (S * R) * v - S * o
+	const float accel_scale[3] = {_accel_calibration.x_scale, _accel_calibration.y_scale, _accel_calibration.z_scale};
+	const float accel_offset[3] = {_accel_calibration.x_offset, _accel_calibration.y_offset, _accel_calibration.z_offset};
+	const float gyro_scale[3] = {_gyro_calibration.x_scale, _gyro_calibration.y_scale, _gyro_calibration.z_scale};
+	const float gyro_offset[3] = {_gyro_calibration.x_offset, _gyro_calibration.y_offset, _gyro_calibration.z_offset};
+
+	for (unsigned i = 0; i < 3; ++i) {
+		for (unsigned j = 0; j < 3; ++j) {
+			_accel_transform(i, j) = accel_scale[i] * _rotation_matrix(i, j);
+			_gyro_transform(i, j) = gyro_scale[i] * _rotation_matrix(i, j);
+		}
+
+		_accel_bias(i) = accel_scale[i] * accel_offset[i];
+		_gyro_bias(i) = gyro_scale[i] * gyro_offset[i];
+	}
+}
+
+int DfMpu9250Wrapper::_publishBatch(const struct imu_sensor_sample *samples, unsigned num_samples,
+				    struct imu_sensor_data &data)
 {
+	if (num_samples == 0) {
+		return 0;
+	}
+
 	/* Check if calibration values are still up-to-date. */
 	bool updated;
 	orb_check(_param_update_sub, &updated);
@@ -589,81 +649,52 @@ int DfMpu9250Wrapper::_publish(struct imu_sensor_data &data)
 		_update_accel_calibration();
 		_update_gyro_calibration();
 		_update_mag_calibration();
+		_update_sample_transforms();
 	}
 
-	accel_report accel_report = {};
-	gyro_report gyro_report = {};
-	mag_report mag_report = {};
-
-	accel_report.timestamp = gyro_report.timestamp = hrt_absolute_time();
-
-	// ACCEL
-
-	// write raw data (without rotation)
-	accel_report.x_raw = data.accel_m_s2_x;
-	accel_report.y_raw = data.accel_m_s2_y;
-	accel_report.z_raw = data.accel_m_s2_z;
-
-	float xraw_f = data.accel_m_s2_x;
-	float yraw_f = data.accel_m_s2_y;
-	float zraw_f = data.accel_m_s2_z;
+	const hrt_abstime batch_start = hrt_absolute_time();
 
-	// apply user specified rotation
-	rotate_3f(_rotation, xraw_f, yraw_f, zraw_f);
+	// Rotate, calibrate and integrate every sample of the burst. The integrators get
+	// the FIFO sample interval because all samples of a burst arrive at the same time.
+	math::Vector<3> vec_integrated_unused;
+	uint64_t integral_dt_unused;
+	math::Vector<3> accel_sum(0.0f, 0.0f, 0.0f);
+	math::Vector<3> gyro_sum(0.0f, 0.0f, 0.0f);
 
-	// adjust values according to the calibration
-	float x_in_new = (xraw_f - _accel_calibration.x_offset) * _accel_calibration.x_scale;
-	float y_in_new = (yraw_f - _accel_calibration.y_offset) * _accel_calibration.y_scale;
-	float z_in_new = (zraw_f - _accel_calibration.z_offset) * _accel_calibration.z_scale;
+	for (unsigned i = 0; i < num_samples; ++i) {
+		const struct imu_sensor_sample &sample = samples[i];
 
-	accel_report.x = _accel_filter_x.apply(x_in_new);
-	accel_report.y = _accel_filter_y.apply(y_in_new);
-	accel_report.z = _accel_filter_z.apply(z_in_new);
+		math::Vector<3> accel_val(sample.accel_m_s2_x, sample.accel_m_s2_y, sample.accel_m_s2_z);
+		accel_val = _accel_transform * accel_val - _accel_bias;
+		_accel_int.put_with_interval(data.fifo_sample_interval_us,
+					     accel_val,
+					     vec_integrated_unused,
+					     integral_dt_unused);
+		accel_sum += accel_val;
 
-	math::Vector<3> aval(x_in_new, y_in_new, z_in_new);
-	math::Vector<3> aval_integrated;
-
-	_accel_int.put(accel_report.timestamp, aval, aval_integrated, accel_report.integral_dt);
-	accel_report.x_integral = aval_integrated(0);
-	accel_report.y_integral = aval_integrated(1);
-	accel_report.z_integral = aval_integrated(2);
-
-	// GYRO
-
-	// write raw data (withoud rotation)
-	gyro_report.x_raw = data.gyro_rad_s_x;
-	gyro_report.y_raw = data.gyro_rad_s_y;
-	gyro_report.z_raw = data.gyro_rad_s_z;
-
-	xraw_f = data.gyro_rad_s_x;
-	yraw_f = data.gyro_rad_s_y;
-	zraw_f = data.gyro_rad_s_z;
-
-	// apply user specified rotation
-	rotate_3f(_rotation, xraw_f, yraw_f, zraw_f);
-
-	// adjust values according to the calibration
-	float x_gyro_in_new = (xraw_f - _gyro_calibration.x_offset) * _gyro_calibration.x_scale;
-	float y_gyro_in_new = (yraw_f - _gyro_calibration.y_offset) * _gyro_calibration.y_scale;
-	float z_gyro_in_new = (zraw_f - _gyro_calibration.z_offset) * _gyro_calibration.z_scale;
-
-	gyro_report.x = _gyro_filter_x.apply(x_gyro_in_new);
-	gyro_report.y = _gyro_filter_y.apply(y_gyro_in_new);
-	gyro_report.z = _gyro_filter_z.apply(z_gyro_in_new);
+		math::Vector<3> gyro_val(sample.gyro_rad_s_x, sample.gyro_rad_s_y, sample.gyro_rad_s_z);
+		gyro_val = _gyro_transform * gyro_val - _gyro_bias;
+		_gyro_int.put_with_interval(data.fifo_sample_interval_us,
+					    gyro_val,
+					    vec_integrated_unused,
+					    integral_dt_unused);
+		gyro_sum += gyro_val;
+	}
 
-	math::Vector<3> gval(x_gyro_in_new, y_gyro_in_new, z_gyro_in_new);
-	math::Vector<3> gval_integrated;
+	// The low pass filters run at the measure rate (1 kHz), so they get the mean of the burst.
+	const float burst_scale = 1.0f / num_samples;
+	const float accel_filtered_x = _accel_filter_x.apply(accel_sum(0) * burst_scale);
+	const float accel_filtered_y = _accel_filter_y.apply(accel_sum(1) * burst_scale);
+	const float accel_filtered_z = _accel_filter_z.apply(accel_sum(2) * burst_scale);
+	const float gyro_filtered_x = _gyro_filter_x.apply(gyro_sum(0) * burst_scale);
+	const float gyro_filtered_y = _gyro_filter_y.apply(gyro_sum(1) * burst_scale);
+	const float gyro_filtered_z = _gyro_filter_z.apply(gyro_sum(2) * burst_scale);
 
-	_gyro_int.put(gyro_report.timestamp, gval, gval_integrated, gyro_report.integral_dt);
-	gyro_report.x_integral = gval_integrated(0);
-	gyro_report.y_integral = gval_integrated(1);
-	gyro_report.z_integral = gval_integrated(2);
+	const hrt_abstime batch_elapsed = hrt_absolute_time() - batch_start;
+	perf_set_elapsed(_batch_perf, batch_elapsed);
+	_batch_elapsed_total += batch_elapsed;
 
-	// If we are not receiving the last sample from the FIFO buffer yet, let's stop here
-	// and wait for more packets.
-	if (!data.is_last_fifo_sample) {
-		return 0;
-	}
+	perf_set_count(_sample_counter, perf_event_count(_sample_counter) + num_samples);
 
 	// The driver empties the FIFO buffer at 1kHz, however we only need to publish at 250Hz.
 	// Therefore, only publish every forth time.
@@ -689,6 +720,12 @@ int DfMpu9250Wrapper::_publish(struct imu_sensor_data &data)
 
 	perf_begin(_publish_perf);
 
+	accel_report accel_report = {};
+	gyro_report gyro_report = {};
+	mag_report mag_report = {};
+
+	accel_report.timestamp = gyro_report.timestamp = hrt_absolute_time();
+
 	// TODO: get these right
 	gyro_report.scaling = -1.0f;
 	gyro_report.range_rad_s = -1.0f;
@@ -698,6 +735,35 @@ int DfMpu9250Wrapper::_publish(struct imu_sensor_data &data)
 	accel_report.range_m_s2 = -1.0f;
 	accel_report.device_id = m_id.dev_id;
 
+	// write raw data of the last sample (without rotation)
+	accel_report.x_raw = data.accel_m_s2_x;
+	accel_report.y_raw = data.accel_m_s2_y;
+	accel_report.z_raw = data.accel_m_s2_z;
+
+	gyro_report.x_raw = data.gyro_rad_s_x;
+	gyro_report.y_raw = data.gyro_rad_s_y;
+	gyro_report.z_raw = data.gyro_rad_s_z;
+
+	accel_report.x = accel_filtered_x;
+	accel_report.y = accel_filtered_y;
+	accel_report.z = accel_filtered_z;
+
+	gyro_report.x = gyro_filtered_x;
+	gyro_report.y = gyro_filtered_y;
+	gyro_report.z = gyro_filtered_z;
+
+	// Read and reset.
+	math::Vector<3> accel_val_integ = _accel_int.get(true, accel_report.integral_dt);
+	math::Vector<3> gyro_val_integ = _gyro_int.get(true, gyro_report.integral_dt);
+
+	accel_report.x_integral = accel_val_integ(0);
+	accel_report.y_integral = accel_val_integ(1);
+	accel_report.z_integral = accel_val_integ(2);
+
+	gyro_report.x_integral = gyro_val_integ(0);
+	gyro_report.y_integral = gyro_val_integ(1);
+	gyro_report.z_integral = gyro_val_integ(2);
+
 	if (_mag_enabled) {
 		mag_report.timestamp = accel_report.timestamp;
 		mag_report.is_external = false;
@@ -710,9 +776,9 @@ int DfMpu9250Wrapper::_publish(struct imu_sensor_data &data)
 		mag_report.y_raw = 0;
 		mag_report.z_raw = 0;
 
-		xraw_f = data.mag_ga_x;
-		yraw_f = data.mag_ga_y;
-		zraw_f = data.mag_ga_z;
+		float xraw_f = data.mag_ga_x;
+		float yraw_f = data.mag_ga_y;
+		float zraw_f = data.mag_ga_z;
 
 		rotate_3f(_rotation, xraw_f, yraw_f, zraw_f);
 
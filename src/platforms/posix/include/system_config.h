@@ -80,5 +80,16 @@
 /** time in ms between checks for work in work queues **/
 #define CONFIG_SCHED_WORKPERIOD 50000
 
+/** worker threads per work queue, work of a queue runs concurrently if > 1 **/
+#define CONFIG_SCHED_HPWORK_NTHREADS 1
+#define CONFIG_SCHED_LPWORK_NTHREADS 1
+
+/** CPU the worker threads are pinned to, -1 for no affinity (Linux only) **/
+#define CONFIG_SCHED_HPWORK_CPU -1
+#define CONFIG_SCHED_LPWORK_CPU -1
+
+/** wake worker threads with a condition variable instead of usleep() and a signal **/
+//#define CONFIG_SCHED_WORK_CONDVAR 1
+
 #define CONFIG_SCHED_INSTRUMENTATION 1
 #define CONFIG_MAX_TASKS 32
@@ -48,16 +48,31 @@
 #include <string.h>
 #include <inttypes.h>
 #include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include "hrt_work.h"
 
-static struct sq_queue_s	callout_queue;
-
-/* latency histogram */
-#define LATENCY_BUCKET_COUNT 8
+/*
+ * Callouts are kept in a binary min-heap ordered by deadline. Each queued
+ * entry stores its position in the heap, so it is found in O(1) and
+ * entered or removed in O(log n).
+ */
+#define CALLOUT_HEAP_MIN_SIZE	32
+static struct hrt_call		**callout_heap = NULL;
+static unsigned			callout_count = 0;
+static unsigned			callout_size = 0;
+static unsigned			callout_count_max = 0;
+
+/* latency histogram: lateness of the callouts against their deadline */
+#define LATENCY_BUCKET_COUNT 10
 __EXPORT const uint16_t latency_bucket_count = LATENCY_BUCKET_COUNT;
-__EXPORT const uint16_t	latency_buckets[LATENCY_BUCKET_COUNT] = { 1, 2, 5, 10, 20, 50, 100, 1000 };
+__EXPORT const uint16_t	latency_buckets[LATENCY_BUCKET_COUNT] = { 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000 };
 __EXPORT uint32_t	latency_counters[LATENCY_BUCKET_COUNT + 1];
 
+static uint64_t		latency_count = 0;
+static uint64_t		latency_sum = 0;
+static hrt_abstime	latency_max = 0;
+
 static void		hrt_call_reschedule(void);
 
 // Intervals in usec
@@ -94,6 +109,106 @@ static void hrt_unlock(void)
 	px4_sem_post(&_hrt_lock);
 }
 
+/*
+ * Store an entry at a position of the callout heap.
+ */
+static inline void callout_set(unsigned index, struct hrt_call *entry)
+{
+	callout_heap[index] = entry;
+	entry->heap_index = index;
+}
+
+static void callout_sift_up(unsigned index)
+{
+	struct hrt_call *entry = callout_heap[index];
+
+	while (index > 0) {
+		unsigned parent = (index - 1) / 2;
+
+		if (callout_heap[parent]->deadline <= entry->deadline) {
+			break;
+		}
+
+		callout_set(index, callout_heap[parent]);
+		index = parent;
+	}
+
+	callout_set(index, entry);
+}
+
+static void callout_sift_down(unsigned index)
+{
+	struct hrt_call *entry = callout_heap[index];
+
+	while (true) {
+		unsigned child = 2 * index + 1;
+
+		if (child >= callout_count) {
+			break;
+		}
+
+		if (child + 1 < callout_count && callout_heap[child + 1]->deadline < callout_heap[child]->deadline) {
+			child++;
+		}
+
+		if (entry->deadline <= callout_heap[child]->deadline) {
+			break;
+		}
+
+		callout_set(index, callout_heap[child]);
+		index = child;
+	}
+
+	callout_set(index, entry);
+}
+
+/*
+ * Remove an entry from the callout heap, does nothing if it is not queued.
+ */
+static void callout_remove(struct hrt_call *entry)
+{
+	unsigned index = entry->heap_index;
+
+	if (index >= callout_count || callout_heap[index] != entry) {
+		return;
+	}
+
+	struct hrt_call *last = callout_heap[--callout_count];
+
+	if (index < callout_count) {
+		callout_set(index, last);
+
+		if (index > 0 && callout_heap[(index - 1) / 2]->deadline > last->deadline) {
+			callout_sift_up(index);
+
+		} else {
+			callout_sift_down(index);
+		}
+	}
+}
+
+/*
+ * Account the lateness of a callout against its deadline.
+ */
+static void hrt_latency_update(hrt_abstime latency)
+{
+	unsigned index;
+
+	for (index = 0; index < LATENCY_BUCKET_COUNT; index++) {
+		if (latency <= latency_buckets[index]) {
+			break;
+		}
+	}
+
+	latency_counters[index]++;
+	latency_count++;
+	latency_sum += latency;
+
+	if (latency > latency_max) {
+		latency_max = latency;
+	}
+}
+
 #if defined(__PX4_APPLE_LEGACY)
 #include <sys/time.h>
 
@@ -278,7 +393,7 @@ bool	hrt_called(struct hrt_call *entry)
 void	hrt_cancel(struct hrt_call *entry)
 {
 	hrt_lock();
-	sq_rem(&entry->link, &callout_queue);
+	callout_remove(entry);
 	entry->deadline = 0;
 
 	/* if this is a periodic call being removed by the callout, prevent it from
@@ -314,7 +429,7 @@ void	hrt_call_delay(struct hrt_call *entry, hrt_abstime delay)
  */
 void	hrt_init(void)
 {
-	sq_init(&callout_queue);
+	callout_count = 0;
 
 	int sem_ret = px4_sem_init(&_hrt_lock, 0, 1);
 
@@ -350,27 +465,33 @@ void	hrt_stop_delay()
 static void
 hrt_call_enter(struct hrt_call *entry)
 {
-	struct hrt_call	*call, *next;
-
 	//PX4_INFO("hrt_call_enter");
-	call = (struct hrt_call *)sq_peek(&callout_queue);
+	if (callout_count == callout_size) {
+		unsigned size = (callout_size > 0) ? callout_size * 2 : CALLOUT_HEAP_MIN_SIZE;
+		struct hrt_call **heap = (struct hrt_call **)realloc(callout_heap, size * sizeof(struct hrt_call *));
+
+		if (heap == NULL) {
+			PX4_ERR("hrt callout heap allocation failed");
+			entry->deadline = 0;
+			return;
+		}
 
-	if ((call == NULL) || (entry->deadline < call->deadline)) {
-		sq_addfirst(&entry->link, &callout_queue);
-		//if (call != NULL) PX4_INFO("call enter at head, reschedule (%lu %lu)", entry->deadline, call->deadline);
-		/* we changed the next deadline, reschedule the timer event */
-		hrt_call_reschedule();
+		callout_heap = heap;
+		callout_size = size;
+	}
 
-	} else {
-		do {
-			next = (struct hrt_call *)sq_next(&call->link);
+	callout_heap[callout_count] = entry;
+	entry->heap_index = callout_count++;
+	callout_sift_up(entry->heap_index);
 
-			if ((next == NULL) || (entry->deadline < next->deadline)) {
-				//lldbg("call enter after head\n");
-				sq_addafter(&call->link, &entry->link, &callout_queue);
-				break;
-			}
-		} while ((call = next) != NULL);
+	if (callout_count > callout_count_max) {
+		callout_count_max = callout_count;
+	}
+
+	if (entry->heap_index == 0) {
+		//PX4_INFO("call enter at head, reschedule");
+		/* we changed the next deadline, reschedule the timer event */
+		hrt_call_reschedule();
 	}
 
 	//PX4_INFO("scheduled");
@@ -407,7 +528,7 @@ hrt_call_reschedule()
 {
 	hrt_abstime	now = hrt_absolute_time();
 	hrt_abstime	delay = HRT_INTERVAL_MAX;
-	struct hrt_call	*next = (struct hrt_call *)sq_peek(&callout_queue);
+	struct hrt_call	*next = (callout_count > 0) ? callout_heap[0] : NULL;
 	hrt_abstime	deadline = now + HRT_INTERVAL_MAX;
 
 	//PX4_INFO("hrt_call_reschedule");
@@ -454,16 +575,11 @@ hrt_call_internal(struct hrt_call *entry, hrt_abstime deadline, hrt_abstime inte
 
 	//PX4_INFO("hrt_call_internal after lock");
 	/* if the entry is currently queued, remove it */
-	/* note that we are using a potentially uninitialised
-	   entry->link here, but it is safe as sq_rem() doesn't
-	   dereference the passed node unless it is found in the
-	   list. So we potentially waste a bit of time searching the
-	   queue for the uninitialised entry->link but we don't do
-	   anything actually unsafe.
+	/* note that entry->heap_index is potentially uninitialised here,
+	   but callout_remove() only uses it after checking that it points
+	   at this entry inside the heap.
 	*/
-	if (entry->deadline != 0) {
-		sq_rem(&entry->link, &callout_queue);
-	}
+	callout_remove(entry);
 
 #if 1
 
@@ -541,19 +657,21 @@ hrt_call_invoke(void)
 		/* get the current time */
 		hrt_abstime now = hrt_absolute_time();
 
-		call = (struct hrt_call *)sq_peek(&callout_queue);
-
-		if (call == NULL) {
+		if (callout_count == 0) {
 			break;
 		}
 
+		call = callout_heap[0];
+
 		if (call->deadline > now) {
 			break;
 		}
 
-		sq_rem(&call->link, &callout_queue);
+		callout_remove(call);
 		//PX4_INFO("call pop");
 
+		hrt_latency_update(now - call->deadline);
+
 		/* save the intended deadline for periodic calls */
 		deadline = call->deadline;
 
@@ -588,3 +706,39 @@ hrt_call_invoke(void)
 	hrt_unlock();
 }
 
+/*
+ * Print the callout queue length and lateness histogram.
+ */
+void	hrt_print_stats(void)
+{
+	hrt_lock();
+
+	printf("callouts queued: %u (max %u, heap size %u)\n", callout_count, callout_count_max, callout_size);
+	printf("callouts invoked: %" PRIu64 ", lateness mean %" PRIu64 " us, max %" PRIu64 " us\n",
+	       latency_count, (latency_count > 0) ? latency_sum / latency_count : 0, latency_max);
+	printf("lateness [us] : callouts\n");
+
+	for (unsigned i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+		printf("        %5u : %u\n", latency_buckets[i], latency_counters[i]);
+	}
+
+	printf("       >%5u : %u\n", latency_buckets[LATENCY_BUCKET_COUNT - 1], latency_counters[LATENCY_BUCKET_COUNT]);
+
+	hrt_unlock();
+}
+
+/*
+ * Reset the callout statistics.
+ */
+void	hrt_reset_stats(void)
+{
+	hrt_lock();
+
+	memset(latency_counters, 0, sizeof(latency_counters));
+	latency_count = 0;
+	latency_sum = 0;
+	latency_max = 0;
+	callout_count_max = callout_count;
+
+	hrt_unlock();
+}
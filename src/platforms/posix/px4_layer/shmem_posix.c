@@ -60,12 +60,6 @@ void update_index_from_shmem(void);
 uint64_t update_from_shmem_prev_time = 0, update_from_shmem_current_time = 0;
 extern unsigned char *adsp_changed_index;
 
-struct param_wbuf_s {
-	union param_value_u val;
-	param_t param;
-	bool unsaved;
-};
-
 /*update value and param's change bit in shared memory*/
 void update_to_shmem(param_t param, union param_value_u value)
 {
@@ -45,6 +45,7 @@
 #include "hrt_test.h"
 #include <unistd.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <cstring>
 
 px4::AppState HRTTest::appState;
@@ -63,6 +64,58 @@ static void timer_expired(void *arg)
 	}
 }
 
+static struct hrt_call t2;
+static const hrt_abstime jitter_interval = 1000;
+static const int jitter_samples = 2000;
+static uint32_t jitter_latency[jitter_samples];
+static volatile int jitter_count = 0;
+static hrt_abstime jitter_expected;
+
+static void jitter_expired(void *arg)
+{
+	hrt_abstime now = hrt_absolute_time();
+
+	if (jitter_count < jitter_samples) {
+		jitter_latency[jitter_count++] = (now > jitter_expected) ? (uint32_t)(now - jitter_expected) : 0;
+	}
+
+	jitter_expected += jitter_interval;
+}
+
+static int compare_latency(const void *a, const void *b)
+{
+	uint32_t la = *(const uint32_t *)a;
+	uint32_t lb = *(const uint32_t *)b;
+	return (la > lb) - (la < lb);
+}
+
+/* measure the wakeup latency of a 1 kHz periodic hrt call */
+static void measure_jitter()
+{
+	memset(&t2, 0, sizeof(t2));
+	jitter_count = 0;
+	jitter_expected = hrt_absolute_time() + jitter_interval;
+	hrt_call_every(&t2, jitter_interval, jitter_interval, jitter_expired, (void *)0);
+
+	while (jitter_count < jitter_samples) {
+		usleep(100000);
+	}
+
+	hrt_cancel(&t2);
+
+	uint64_t sum = 0;
+
+	for (int i = 0; i < jitter_samples; i++) {
+		sum += jitter_latency[i];
+	}
+
+	qsort(jitter_latency, jitter_samples, sizeof(jitter_latency[0]), compare_latency);
+
+	PX4_INFO("hrt_call_every %llu us: latency mean %llu us, p99 %u us, max %u us\n",
+		 (unsigned long long)jitter_interval, (unsigned long long)(sum / jitter_samples),
+		 jitter_latency[jitter_samples * 99 / 100], jitter_latency[jitter_samples - 1]);
+}
+
 int HRTTest::main()
 {
 	appState.setRunning(true);
@@ -89,5 +142,7 @@ int HRTTest::main()
 	hrt_cancel(&t1);
 	PX4_INFO("HRT_CALL + %d\n", hrt_called(&t1));
 
+	measure_jitter();
+
 	return 0;
 }
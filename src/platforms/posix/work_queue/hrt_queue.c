@@ -51,6 +51,7 @@
 #include <px4_workqueue.h>
 #include <px4_posix.h>
 #include "hrt_work.h"
+#include "work_lock.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -120,18 +121,17 @@ int hrt_work_queue(struct work_s *work, worker_t worker, void *arg, uint32_t del
 	 */
 
 	hrt_work_lock();
-	work->qtime  = hrt_absolute_time(); /* Time work queued */
+	work->qtime    = hrt_absolute_time(); /* Time work queued */
+	work->deadline = work->qtime + delay;
 	//PX4_INFO("hrt work_queue adding work delay=%u time=%lu", delay, work->qtime);
 
-	dq_addlast((dq_entry_t *)work, &wqueue->q);
+	work_insert(&wqueue->q, work);
 
-	if (px4_getpid() != wqueue->pid) { /* only need to wake up if called from a different thread */
-#ifdef __PX4_QURT
-		px4_task_kill(wqueue->pid, SIGALRM);      /* Wake up the worker thread */
-#else
-		//wqueue->pid == own task? -> don't signal
-		px4_task_kill(wqueue->pid, SIGCONT);      /* Wake up the worker thread */
-#endif
+	/* Wake up the worker thread, unless the worker wakes up before this
+	 * work is due anyway.
+	 */
+	if (wqueue->q.head == (dq_entry_t *)work) {
+		work_signal(HRTWORK);
 	}
 
 	hrt_work_unlock();
@@ -46,10 +46,14 @@
 #include <signal.h>
 #include <stdio.h>
 #include <unistd.h>
+#ifdef __PX4_LINUX
+#include <sys/prctl.h>
+#endif
 #include <queue.h>
 #include <px4_workqueue.h>
 #include <drivers/drv_hrt.h>
 #include "hrt_work.h"
+#include "work_lock.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -76,26 +80,6 @@ px4_sem_t _hrt_work_lock;
  ****************************************************************************/
 static void hrt_work_process(void);
 
-static void _sighandler(int sig_num);
-
-/****************************************************************************
- * Name: _sighandler
- *
- * Description:
- *   This is the handler for the signal to wake the queue processing thread
- *
- * Input parameters:
- *   sig_num - the received signal
- *
- * Returned Value:
- *   None
- *
- ****************************************************************************/
-static void _sighandler(int sig_num)
-{
-	PX4_DEBUG("RECEIVED SIGNAL %d", sig_num);
-}
-
 /****************************************************************************
  * Name: work_process
  *
@@ -116,8 +100,7 @@ static void hrt_work_process()
 	volatile struct work_s *work;
 	worker_t  worker;
 	void *arg;
-	uint64_t elapsed;
-	uint32_t remaining;
+	uint64_t now;
 	uint32_t next;
 
 	// set the threads name
@@ -128,8 +111,8 @@ static void hrt_work_process()
 	//rv = pthread_setname_np(pthread_self(), "HRT");
 #endif
 
-	/* Then process queued work.  We need to keep interrupts disabled while
-	 * we process items in the work list.
+	/* Then process queued work.  The queue is ordered by deadline, so only
+	 * the work at the head of the queue needs to be checked.
 	 */
 
 	/* Default to sleeping for 1 sec */
@@ -138,18 +121,11 @@ static void hrt_work_process()
 	hrt_work_lock();
 
 	work  = (struct work_s *)wqueue->q.head;
+	now   = hrt_absolute_time();
 
 	while (work) {
-		/* Is this work ready?  It is ready if there is no delay or if
-		 * the delay has elapsed. qtime is the time that the work was added
-		 * to the work queue.  It will always be greater than or equal to
-		 * zero.  Therefore a delay of zero will always execute immediately.
-		 */
-
-		elapsed = hrt_absolute_time() - work->qtime;
-
-		//PX4_INFO("hrt work_process: in usec elapsed=%lu delay=%u work=%p", elapsed, work->delay, work);
-		if (elapsed >= work->delay) {
+		//PX4_INFO("hrt work_process: deadline=%lu now=%lu work=%p", work->deadline, now, work);
+		if (work->deadline <= now) {
 			/* Remove the ready-to-execute work from the list */
 
 			(void)dq_rem((struct dq_entry_s *) & (work->dq), &(wqueue->q));
@@ -180,44 +156,30 @@ static void hrt_work_process()
 				worker(arg);
 			}
 
-			/* Now, unfortunately, since we re-enabled interrupts we don't
-			 * know the state of the work list and we will have to start
-			 * back at the head of the list.
+			/* The queue may have changed while the work was performed,
+			 * start again at the head of the queue.
 			 */
 
 			hrt_work_lock();
 			work  = (struct work_s *)wqueue->q.head;
+			now   = hrt_absolute_time();
 
 		} else {
-			/* This one is not ready.. will it be ready before the next
-			 * scheduled wakeup interval?
-			 */
+			/* The first work that is not ready determines the wakeup */
 
-			/* Here: elapsed < work->delay */
-			remaining = work->delay - elapsed;
-
-			//PX4_INFO("remaining=%u delay=%u elapsed=%lu", remaining, work->delay, elapsed);
-			if (remaining < next) {
-				/* Yes.. Then schedule to wake up when the work is ready */
-
-				next = remaining;
+			if (work->deadline - now < next) {
+				next = work->deadline - now;
 			}
 
-			/* Then try the next in the list. */
-
-			work = (struct work_s *)work->dq.flink;
-			//PX4_INFO("next %u work %p", next, work);
+			break;
 		}
 	}
 
-	/* Wait awhile to check the work list.  We will wait here until either
-	 * the time elapses or until we are awakened by a signal.
-	 */
 	hrt_work_unlock();
 
-	/* might sleep less if a signal received and new item was queued */
+	/* Wait until the next work is due or until new work is queued */
 	//PX4_INFO("Sleeping for %u usec", next);
-	usleep(next);
+	work_wait(HRTWORK, next);
 }
 
 /****************************************************************************
@@ -247,6 +209,13 @@ static void hrt_work_process()
 
 static int work_hrtthread(int argc, char *argv[])
 {
+#ifdef __PX4_LINUX
+	/* The default timer slack of 50us would delay every timed wakeup of
+	 * this thread, use the smallest slack possible instead.
+	 */
+	prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+#endif
+
 	/* Loop forever */
 
 	for (;;) {
@@ -275,6 +244,7 @@ void hrt_work_queue_init(void)
 {
 	px4_sem_init(&_hrt_work_lock, 0, 1);
 	memset(&g_hrt_work, 0, sizeof(g_hrt_work));
+	work_wait_init(HRTWORK);
 
 	// Create high priority worker thread
 	g_hrt_work.pid = px4_task_spawn_cmd("wkr_hrt",
@@ -283,12 +253,5 @@ void hrt_work_queue_init(void)
 					    2000,
 					    work_hrtthread,
 					    (char *const *)NULL);
-
-
-#ifdef __PX4_QURT
-	signal(SIGALRM, _sighandler);
-#else
-	signal(SIGCONT, _sighandler);
-#endif
 }
 
@@ -30,9 +30,16 @@
  * POSSIBILITY OF SUCH DAMAGE.
  *
  ****************************************************************************/
+#include <px4_config.h>
 #include <px4_log.h>
 #include <px4_posix.h>
 #include <stdio.h>
+#include <px4_tasks.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <signal.h>
+#include <hrt_work.h>
 #include "work_lock.h"
 
 
@@ -47,3 +54,105 @@ void work_unlock(int id)
 {
 	px4_sem_post(&_work_lock[id]);
 }
+
+static px4_task_t work_pid(int id)
+{
+	return (id == HRTWORK) ? g_hrt_work.pid : g_work[id].pid;
+}
+
+#if defined(__PX4_QURT) || !defined(CONFIG_SCHED_WORK_CONDVAR)
+
+/* Sleep and wake the worker with a signal */
+
+#ifdef __PX4_QURT
+#define WORK_WAKEUP_SIGNAL SIGALRM
+#else
+#define WORK_WAKEUP_SIGNAL SIGCONT
+#endif
+
+static void _sighandler(int sig_num)
+{
+	PX4_DEBUG("RECEIVED SIGNAL %d", sig_num);
+}
+
+void work_wait_init(int id)
+{
+	/* the handler makes usleep() return early */
+	signal(WORK_WAKEUP_SIGNAL, _sighandler);
+}
+
+void work_wait(int id, uint32_t usec)
+{
+	usleep(usec);
+}
+
+void work_signal(int id)
+{
+	if (px4_getpid() != work_pid(id)) { /* only need to wake up if called from a different thread */
+		px4_task_kill(work_pid(id), WORK_WAKEUP_SIGNAL);
+	}
+}
+
+#else
+
+static struct {
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	bool pending;		/* work_signal() was called since the last wakeup */
+} _work_wait[NWORKERS + 1];
+
+void work_wait_init(int id)
+{
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+#ifndef __PX4_DARWIN
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+#endif
+
+	pthread_mutex_init(&_work_wait[id].mutex, NULL);
+	pthread_cond_init(&_work_wait[id].cond, &attr);
+	_work_wait[id].pending = false;
+
+	pthread_condattr_destroy(&attr);
+}
+
+void work_wait(int id, uint32_t usec)
+{
+	pthread_mutex_lock(&_work_wait[id].mutex);
+
+	if (!_work_wait[id].pending) {
+#ifdef __PX4_DARWIN
+		struct timespec ts;
+		ts.tv_sec = usec / 1000000;
+		ts.tv_nsec = (usec % 1000000) * 1000;
+		pthread_cond_timedwait_relative_np(&_work_wait[id].cond, &_work_wait[id].mutex, &ts);
+#else
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		uint64_t nsec = (uint64_t)ts.tv_nsec + (uint64_t)usec * 1000;
+		ts.tv_sec += nsec / 1000000000;
+		ts.tv_nsec = nsec % 1000000000;
+		pthread_cond_timedwait(&_work_wait[id].cond, &_work_wait[id].mutex, &ts);
+#endif
+	}
+
+	_work_wait[id].pending = false;
+	pthread_mutex_unlock(&_work_wait[id].mutex);
+}
+
+void work_signal(int id)
+{
+	/* The worker checks the queue again before it waits, work queued from
+	 * its own thread (e.g. re-queued hrt_tim_isr) needs no extra pass.
+	 */
+	if (px4_getpid() == work_pid(id)) {
+		return;
+	}
+
+	pthread_mutex_lock(&_work_wait[id].mutex);
+	_work_wait[id].pending = true;
+	pthread_cond_signal(&_work_wait[id].cond);
+	pthread_mutex_unlock(&_work_wait[id].mutex);
+}
+
+#endif /* __PX4_QURT || !CONFIG_SCHED_WORK_CONDVAR */
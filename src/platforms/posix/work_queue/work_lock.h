@@ -37,7 +37,25 @@
 
 //#pragma once
 
+#include <stdint.h>
+#include <px4_workqueue.h>
+
+/* ID of the HRT work queue for work_wait() and work_signal() */
+#define HRTWORK NWORKERS
+
 void work_lock(int id);
 void work_unlock(int id);
 
+/* Worker thread wakeup: work_wait() returns after at most usec or as soon
+ * as work_signal() is called for the same queue from another thread.
+ * By default this is usleep() and a signal. With CONFIG_SCHED_WORK_CONDVAR
+ * a condition variable is used and a work_signal() before the worker starts
+ * waiting is not lost. */
+void work_wait_init(int id);
+void work_wait(int id, uint32_t usec);
+void work_signal(int id);
+
+/* Insert work into a queue ordered by deadline, after all work with the same deadline */
+void work_insert(dq_queue_t *q, struct work_s *work);
+
 #endif // _work_lock_h_
@@ -47,8 +47,36 @@
 #include <queue.h>
 #include <stdio.h>
 #include <semaphore.h>
+#include <drivers/drv_hrt.h>
 #include "work_lock.h"
 
+/****************************************************************************
+ * Name: work_insert
+ *
+ * Description:
+ *   Insert work into a queue ordered by deadline.  Work with the same
+ *   deadline is performed in the order it was queued.  The queue lock must
+ *   be held.
+ *
+ ****************************************************************************/
+
+void work_insert(dq_queue_t *q, struct work_s *work)
+{
+	/* most work is queued with the longest delay, so search from the tail */
+	struct work_s *prev = (struct work_s *)q->tail;
+
+	while (prev && prev->deadline > work->deadline) {
+		prev = (struct work_s *)prev->dq.blink;
+	}
+
+	if (prev) {
+		dq_addafter((dq_entry_t *)prev, (dq_entry_t *)work, q);
+
+	} else {
+		dq_addfirst((dq_entry_t *)work, q);
+	}
+}
+
 #ifdef CONFIG_SCHED_WORKQUEUE
 
 /****************************************************************************
@@ -122,14 +150,17 @@ int work_queue(int qid, struct work_s *work, worker_t worker, void *arg, uint32_
 	 */
 
 	work_lock(qid);
-	work->qtime  = clock_systimer(); /* Time work queued */
-
-	dq_addlast((dq_entry_t *)work, &wqueue->q);
-#ifdef __PX4_QURT
-	px4_task_kill(wqueue->pid, SIGALRM);      /* Wake up the worker thread */
-#else
-	px4_task_kill(wqueue->pid, SIGCONT);      /* Wake up the worker thread */
-#endif
+	work->qtime    = hrt_absolute_time(); /* Time work queued */
+	work->deadline = work->qtime + (uint64_t)delay * USEC_PER_TICK;
+
+	work_insert(&wqueue->q, work);
+
+	/* Wake up the worker thread, unless the worker wakes up before this
+	 * work is due anyway.
+	 */
+	if (wqueue->q.head == (dq_entry_t *)work) {
+		work_signal(qid);
+	}
 
 	work_unlock(qid);
 	return PX4_OK;
@@ -37,6 +37,10 @@
  * Included Files
  ****************************************************************************/
 
+#if defined(__PX4_LINUX) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* pthread_setaffinity_np() */
+#endif
+
 #include <px4_config.h>
 #include <px4_defines.h>
 #include <px4_posix.h>
@@ -48,6 +52,9 @@
 #include <unistd.h>
 #include <queue.h>
 #include <pthread.h>
+#ifdef __PX4_LINUX
+#include <sys/prctl.h>
+#endif
 #include <drivers/drv_hrt.h>
 #include "work_lock.h"
 
@@ -57,6 +64,22 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_SCHED_HPWORK_NTHREADS
+#define CONFIG_SCHED_HPWORK_NTHREADS 1
+#endif
+
+#ifndef CONFIG_SCHED_LPWORK_NTHREADS
+#define CONFIG_SCHED_LPWORK_NTHREADS 1
+#endif
+
+#ifndef CONFIG_SCHED_HPWORK_CPU
+#define CONFIG_SCHED_HPWORK_CPU -1
+#endif
+
+#ifndef CONFIG_SCHED_LPWORK_CPU
+#define CONFIG_SCHED_LPWORK_CPU -1
+#endif
+
 /****************************************************************************
  * Private Type Declarations
  ****************************************************************************/
@@ -96,12 +119,11 @@ static void work_process(struct wqueue_s *wqueue, int lock_id)
 	volatile struct work_s *work;
 	worker_t  worker;
 	void *arg;
-	uint64_t elapsed;
-	uint32_t remaining;
+	uint64_t now;
 	uint32_t next;
 
-	/* Then process queued work.  We need to keep interrupts disabled while
-	 * we process items in the work list.
+	/* Then process queued work.  The queue is ordered by deadline, so only
+	 * the work at the head of the queue needs to be checked.
 	 */
 
 	next  = CONFIG_SCHED_WORKPERIOD;
@@ -109,18 +131,10 @@ static void work_process(struct wqueue_s *wqueue, int lock_id)
 	work_lock(lock_id);
 
 	work  = (struct work_s *)wqueue->q.head;
+	now   = hrt_absolute_time();
 
 	while (work) {
-		/* Is this work ready?  It is ready if there is no delay or if
-		 * the delay has elapsed. qtime is the time that the work was added
-		 * to the work queue.  It will always be greater than or equal to
-		 * zero.  Therefore a delay of zero will always execute immediately.
-		 */
-
-		elapsed = USEC2TICK(clock_systimer() - work->qtime);
-
-		//printf("work_process: in ticks elapsed=%lu delay=%u\n", elapsed, work->delay);
-		if (elapsed >= work->delay) {
+		if (work->deadline <= now) {
 			/* Remove the ready-to-execute work from the list */
 
 			(void)dq_rem((struct dq_entry_s *)work, &wqueue->q);
@@ -149,40 +163,58 @@ static void work_process(struct wqueue_s *wqueue, int lock_id)
 				worker(arg);
 			}
 
-			/* Now, unfortunately, since we re-enabled interrupts we don't
-			 * know the state of the work list and we will have to start
-			 * back at the head of the list.
+			/* The queue may have changed while the work was performed,
+			 * start again at the head of the queue.
 			 */
 
 			work_lock(lock_id);
 			work  = (struct work_s *)wqueue->q.head;
+			now   = hrt_absolute_time();
 
 		} else {
-			/* This one is not ready.. will it be ready before the next
-			 * scheduled wakeup interval?
-			 */
+			/* The first work that is not ready determines the wakeup */
 
-			/* Here: elapsed < work->delay */
-			remaining = USEC_PER_TICK * (work->delay - elapsed);
-
-			if (remaining < next) {
-				/* Yes.. Then schedule to wake up when the work is ready */
-
-				next = remaining;
+			if (work->deadline - now < next) {
+				next = work->deadline - now;
 			}
 
-			/* Then try the next in the list. */
-
-			work = (struct work_s *)work->dq.flink;
+			break;
 		}
 	}
 
-	/* Wait awhile to check the work list.  We will wait here until either
-	 * the time elapses or until we are awakened by a signal.
-	 */
 	work_unlock(lock_id);
 
-	usleep(next);
+	/* Wait until the next work is due or until new work is queued */
+
+	work_wait(lock_id, next);
+}
+
+/****************************************************************************
+ * Name: work_thread_setup
+ *
+ * Description:
+ *   Set up the calling worker thread: minimal timer slack and pinning to a
+ *   CPU, cpu < 0 leaves the affinity unchanged.
+ *
+ ****************************************************************************/
+
+static void work_thread_setup(int cpu)
+{
+#if defined(__PX4_LINUX)
+	/* Timed wakeups should not be deferred by the default 50us timer slack */
+	prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+
+	if (cpu >= 0) {
+		cpu_set_t cpuset;
+		CPU_ZERO(&cpuset);
+		CPU_SET(cpu, &cpuset);
+
+		if (pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) != 0) {
+			PX4_WARN("work queue: could not set CPU affinity to %d", cpu);
+		}
+	}
+
+#endif
 }
 
 /****************************************************************************
@@ -190,28 +222,38 @@ static void work_process(struct wqueue_s *wqueue, int lock_id)
  ****************************************************************************/
 void work_queues_init(void)
 {
+	char name[16];
+
 	px4_sem_init(&_work_lock[HPWORK], 0, 1);
 	px4_sem_init(&_work_lock[LPWORK], 0, 1);
+	work_wait_init(HPWORK);
+	work_wait_init(LPWORK);
 #ifdef CONFIG_SCHED_USRWORK
 	px4_sem_init(&_work_lock[USRWORK], 0, 1);
+	work_wait_init(USRWORK);
 #endif
 
-	// Create high priority worker thread
-	g_work[HPWORK].pid = px4_task_spawn_cmd("hpwork",
-						SCHED_DEFAULT,
-						SCHED_PRIORITY_MAX - 1,
-						2000,
-						work_hpthread,
-						(char *const *)NULL);
-
-	// Create low priority worker thread
-	g_work[LPWORK].pid = px4_task_spawn_cmd("lpwork",
-						SCHED_DEFAULT,
-						SCHED_PRIORITY_MIN,
-						2000,
-						work_lpthread,
-						(char *const *)NULL);
+	// Create high priority worker threads, the first one is the queue's task
+	for (int i = CONFIG_SCHED_HPWORK_NTHREADS - 1; i >= 0; i--) {
+		snprintf(name, sizeof(name), i > 0 ? "hpwork%d" : "hpwork", i);
+		g_work[HPWORK].pid = px4_task_spawn_cmd(name,
+							SCHED_DEFAULT,
+							SCHED_PRIORITY_MAX - 1,
+							2000,
+							work_hpthread,
+							(char *const *)NULL);
+	}
 
+	// Create low priority worker threads
+	for (int i = CONFIG_SCHED_LPWORK_NTHREADS - 1; i >= 0; i--) {
+		snprintf(name, sizeof(name), i > 0 ? "lpwork%d" : "lpwork", i);
+		g_work[LPWORK].pid = px4_task_spawn_cmd(name,
+							SCHED_DEFAULT,
+							SCHED_PRIORITY_MIN,
+							2000,
+							work_lpthread,
+							(char *const *)NULL);
+	}
 }
 
 /****************************************************************************
@@ -249,6 +291,8 @@ void work_queues_init(void)
 
 int work_hpthread(int argc, char *argv[])
 {
+	work_thread_setup(CONFIG_SCHED_HPWORK_CPU);
+
 	/* Loop forever */
 
 	for (;;) {
@@ -277,6 +321,8 @@ int work_hpthread(int argc, char *argv[])
 
 int work_lpthread(int argc, char *argv[])
 {
+	work_thread_setup(CONFIG_SCHED_LPWORK_CPU);
+
 	/* Loop forever */
 
 	for (;;) {
@@ -76,12 +76,7 @@ static unsigned log2_for_int(unsigned v)
 	return r;
 }
 
-struct param_wbuf_s {
-	union param_value_u val;
-	param_t param;
-	bool unsaved;
-};
-extern struct param_wbuf_s *param_find_changed(param_t param);
+extern union param_value_u *param_find_changed(param_t param);
 
 int get_shmem_lock(const char *caller_file_name, int caller_line_number)
 {
@@ -170,14 +165,14 @@ void copy_params_to_shmem(struct param_info_s *param_info_base)
 
 	for (param = 0; param < param_count(); param++) {
 		//{PX4_INFO("writing to offset %d\n", (unsigned char*)(shmem_info_p->adsp_params[param].name)-(unsigned char*)shmem_info_p);}
-		struct param_wbuf_s *s = param_find_changed(param);
+		union param_value_u *s = param_find_changed(param);
 
 		if (s == NULL) {
 			shmem_info_p->params_val[param] = param_info_base[param].val;
 		}
 
 		else {
-			shmem_info_p->params_val[param] = s->val;
+			shmem_info_p->params_val[param] = *s;
 		}
 
 #ifdef SHMEM_DEBUG
@@ -71,10 +71,18 @@ static int	mixer_callback(uintptr_t handle,
 			       uint8_t control_index,
 			       float &control);
 
+static int	mixer_callback_all_groups(uintptr_t handle,
+		uint8_t control_group,
+		uint8_t control_index,
+		float &control);
+
 const unsigned output_max = 8;
 static float actuator_controls[output_max];
 static bool should_prearm = false;
 
+const unsigned group_max = 4;
+static float group_controls[group_max][output_max];
+
 #define NAN_VALUE (0.0f/0.0f)
 
 #ifdef __PX4_DARWIN
@@ -116,6 +124,8 @@ private:
 	bool loadQuadTest();
 	bool loadComplexTest();
 	bool loadAllTest();
+	bool compiledKernelTest();
+	bool compare_compiled(const char *filename);
 	bool load_mixer(const char *filename, unsigned expected_count, bool verbose = false);
 	bool load_mixer(const char *filename, const char *buf, unsigned loaded, unsigned expected_count,
 			const unsigned chunk_size, bool verbose);
@@ -136,6 +146,7 @@ bool MixerTest::run_tests()
 	ut_run_test(loadVTOL2Test);
 	ut_run_test(loadComplexTest);
 	ut_run_test(loadAllTest);
+	ut_run_test(compiledKernelTest);
 	ut_run_test(mixerTest);
 
 	return (_tests_failed == 0);
@@ -235,6 +246,114 @@ bool MixerTest::loadAllTest()
 	return true;
 }
 
+bool MixerTest::compiledKernelTest()
+{
+	PX4_INFO("Comparing the compiled kernel for all mixers in %s", MIXER_ONBOARD_PATH);
+
+	DIR *dp = opendir(MIXER_ONBOARD_PATH);
+
+	if (dp == nullptr) {
+		PX4_ERR("File open failed");
+		return false;
+	}
+
+	struct dirent *result = nullptr;
+	bool ret = true;
+
+	while (ret && (result = readdir(dp)) != nullptr) {
+#ifdef __PX4_NUTTX
+
+		if (result->d_type != DTYPE_FILE) {
+#else
+
+		if (result->d_type != DT_REG) {
+#endif
+			continue;
+		}
+
+		if (strncmp(result->d_name, ".", 1) == 0) {
+			continue;
+		}
+
+		char buf[PATH_MAX];
+		(void)snprintf(buf, sizeof(buf), "%s/%s", MIXER_ONBOARD_PATH, result->d_name);
+
+		ret = compare_compiled(buf);
+	}
+
+	closedir(dp);
+
+	return ret && compare_compiled(MIXER_PATH(complex_test.mix));
+}
+
+bool MixerTest::compare_compiled(const char *filename)
+{
+	char buf[2048];
+
+	if (load_mixer_file(filename, &buf[0], sizeof(buf)) != 0) {
+		PX4_ERR("Mixer load failed: %s", filename);
+		return false;
+	}
+
+	/* serve every control group, so that no output depends on an unset control */
+	MixerGroup group(mixer_callback_all_groups, 0);
+	unsigned loaded = strlen(buf);
+	group.load_from_buf(&buf[0], loaded);
+
+	uint32_t seed = 1;
+
+	for (unsigned run = 0; run < 500; run++) {
+
+		/* pseudo random controls, including some outside of the valid range */
+		for (unsigned g = 0; g < group_max; g++) {
+			for (unsigned i = 0; i < output_max; i++) {
+				seed = seed * 1664525u + 1013904223u;
+				group_controls[g][i] = (float)(seed >> 8) / 16777216.0f * 2.4f - 1.2f;
+			}
+		}
+
+		if (run % 7 == 0) {
+			group_controls[0][actuator_controls_s::INDEX_THROTTLE] = NAN_VALUE;
+		}
+
+		/* also cover a limited output space and trims */
+		const unsigned space = (run % 5 == 0) ? (run / 5) % (2 * output_max + 1) : 2 * output_max;
+
+		if (run == 250) {
+			int16_t trims[2 * output_max] = {100, -100, 50, -50};
+			group.set_trims(trims, 2 * output_max);
+		}
+
+		float outputs[2 * output_max];
+		float outputs_reference[2 * output_max];
+		uint16_t status = 0;
+		uint16_t status_reference = 0;
+
+		unsigned mixed = group.mix(&outputs[0], space, &status);
+		unsigned mixed_reference = group.mix_reference(&outputs_reference[0], space, &status_reference);
+
+		if (mixed != mixed_reference || status != status_reference) {
+			PX4_ERR("%s: mixed %u outputs, reference %u", filename, mixed, mixed_reference);
+			return false;
+		}
+
+		/* the kernel keeps the summation order, so the results have to be bit exact */
+		for (unsigned i = 0; i < mixed; i++) {
+			if (!PX4_ISFINITE(outputs[i]) && !PX4_ISFINITE(outputs_reference[i])) {
+				continue;
+			}
+
+			if (memcmp(&outputs[i], &outputs_reference[i], sizeof(float)) != 0) {
+				PX4_ERR("%s: output %u is %.6f, reference %.6f", filename, i, (double)outputs[i],
+					(double)outputs_reference[i]);
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
 bool MixerTest::load_mixer(const char *filename, unsigned expected_count, bool verbose)
 {
 	char buf[2048];
@@ -607,3 +726,15 @@ mixer_callback(uintptr_t handle, uint8_t control_group, uint8_t control_index, f
 
 	return 0;
 }
+
+static int
+mixer_callback_all_groups(uintptr_t handle, uint8_t control_group, uint8_t control_index, float &control)
+{
+	if (control_group >= group_max || control_index >= output_max) {
+		return -1;
+	}
+
+	control = group_controls[control_group][control_index];
+
+	return 0;
+}